@@ -199,10 +199,8 @@ void FRendererWindow::InitializeVulkanRenderer()
     tRenderer->CreateDepthResources();
     tRenderer->CreateFramebuffers();
     tRenderer->CreateTextureImage();
-    tRenderer->CreateTextureImageView();
     tRenderer->CreateTextureSampler();
     tRenderer->CreateVertexBuffers();
-    tRenderer->CreateIndexBuffer();
     tRenderer->CreateConstantBuffer();
     tRenderer->CreateDescriptorPool();
     tRenderer->CreateDescriptorSet();
@@ -0,0 +1,23 @@
+#ifndef VERTEX_DECODE_HLSLI
+#define VERTEX_DECODE_HLSLI
+
+// 与InternalLib的FVertexQuantization对应的顶点解码
+// SNORM/UNORM/半精度属性由硬件完成归一化，这里只处理需要额外计算的部分
+
+// 位置相对包围盒量化，Scale与Bias的w分量使结果的w恒为1
+float4 DecodePosition(float4 QuantizedPos, float4 PositionScale, float4 PositionBias)
+{
+    return QuantizedPos * PositionScale + PositionBias;
+}
+
+// 八面体映射编码的法线
+float3 DecodeOctahedral(float2 Encoded)
+{
+    float3 Normal = float3(Encoded, 1.0 - abs(Encoded.x) - abs(Encoded.y));
+    float Fold = saturate(-Normal.z);
+    // 非负分量减去Fold，负分量加上Fold
+    Normal.xy += Fold * (1.0 - 2.0 * step(0.0, Normal.xy));
+    return normalize(Normal);
+}
+
+#endif
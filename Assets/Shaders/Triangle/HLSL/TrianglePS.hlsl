@@ -1,5 +1,8 @@
 
+// 纹理与采样器合并为binding 1上的一个COMBINED_IMAGE_SAMPLER
+[[vk::combinedImageSampler]]
 Texture2D<float4> Texture1 : register(t1, space0);
+[[vk::combinedImageSampler]]
 SamplerState Sampler1 : register(s1, space0);
 
 struct VSOutput
@@ -7,10 +10,24 @@ struct VSOutput
     float4 Pos : SV_POSITION;
     float3 Color : COLOR;
     float2 TexCoord : TEXCOORD;
+    float3 Normal : NORMAL;
 };
 
+#if USE_VERTEX_NORMAL
+// 世界空间中指向光源的方向
+static const float3 LightDirection = normalize(float3(1.0, 1.0, 2.0));
+#endif
+
 float4 Main(VSOutput Input) : SV_TARGET
 {
     float4 Color = Texture1.Sample(Sampler1, Input.TexCoord);
+#if USE_VERTEX_COLOR
+    Color.rgb *= Input.Color;
+#endif
+#if USE_VERTEX_NORMAL
+    // 半兰伯特，背光面不会完全变黑
+    float HalfLambert = dot(normalize(Input.Normal), LightDirection) * 0.5 + 0.5;
+    Color.rgb *= HalfLambert * HalfLambert;
+#endif
     return Color;
 }
\ No newline at end of file
@@ -1,9 +1,11 @@
+#include "../../Common/VertexDecode.hlsli"
 
 struct VSInput
 {
-    float3 Pos : POSITION;
-    float3 Color : COLOR;
-    float2 TexCoord : TEXCOORD;
+    float4 Pos : POSITION;      // R16G16B16A16_SNORM
+    float4 Color : COLOR;       // R8G8B8A8_UNORM
+    float2 TexCoord : TEXCOORD; // R16G16_SFLOAT
+    float2 Normal : NORMAL;     // R16G16_SNORM，八面体编码
 };
 
 struct VSOutput
@@ -11,6 +13,7 @@ struct VSOutput
     float4 Pos : SV_POSITION;
     float3 Color : COLOR;
     float2 TexCoord : TEXCOORD;
+    float3 Normal : NORMAL;
 };
 
 // MVP变换矩阵
@@ -19,16 +22,21 @@ cbuffer MVPBuffer : register(b0, space0)
     float4x4 Model;
     float4x4 View;
     float4x4 Projection;
+    // 量化位置的反量化参数
+    float4 PositionScale;
+    float4 PositionBias;
 }
 
 VSOutput Main(VSInput Input)
 {
     VSOutput output;
-    float4 WorldPos = mul(Model, float4(Input.Pos, 1.0));
+    float4 WorldPos = mul(Model, DecodePosition(Input.Pos, PositionScale, PositionBias));
     float4 ViewPos = mul(View, WorldPos);
     float4 HomogeneousPos = mul(Projection, ViewPos); // 齐次坐标
     output.Pos = HomogeneousPos;
-    output.Color = Input.Color;
+    output.Color = Input.Color.rgb;
     output.TexCoord = Input.TexCoord;
+    // 模型矩阵只含旋转与均匀缩放，直接变换法线后重新归一化
+    output.Normal = normalize(mul((float3x3)Model, DecodeOctahedral(Input.Normal)));
     return output;
 }
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+#include "Mixins.hh"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace SilverBell::Utility
+{
+    /*
+     * 异步资产加载器
+     * 读取文件与解码在专用的加载线程上执行，等待中的请求按优先级排序(数值越小越先加载，通常为到相机的距离)，
+     * 加载完成的结果排队等待调用方在帧边界调用PumpCompletions，在调用线程上执行完成回调，GPU上传放在回调中进行
+     * 加载线程不属于全局线程池，导入过程中的ParallelFor仍可以使用全部工作线程
+     */
+    class INTERNALLIB_API FAssetLoader : public NonCopyable
+    {
+    public:
+        using RequestId = std::uint64_t;
+
+        explicit FAssetLoader(std::uint32_t ThreadCount = 2);
+        ~FAssetLoader();
+
+        /*
+         * 提交加载请求，Load在加载线程上执行，OnComplete(Load的返回值)在PumpCompletions的调用线程上执行
+         * Load抛出异常时记录警告并丢弃该请求，不会调用OnComplete
+         * 请求被取消时以默认构造的结果(空的optional或指针)调用OnComplete，等待加载结束的一方因此总能收到结果
+         */
+        template<typename LoadFunc, typename CompleteFunc>
+        RequestId Submit(float Priority, LoadFunc&& Load, CompleteFunc&& OnComplete)
+        {
+            using ResultType = std::invoke_result_t<std::decay_t<LoadFunc>&>;
+            static_assert(std::is_default_constructible_v<ResultType>, "Load result must be default constructible to report cancellation");
+            // 加载完成与取消只会发生一个，两者共用同一个回调
+            auto SharedComplete = std::make_shared<std::decay_t<CompleteFunc>>(std::forward<CompleteFunc>(OnComplete));
+            // std::function要求可拷贝，结果可能只能移动，放进shared_ptr中传递
+            return Push(Priority, [Load = std::forward<LoadFunc>(Load), SharedComplete]() mutable
+            {
+                auto Result = std::make_shared<ResultType>(Load());
+                return CompletionFunc([Result, SharedComplete]()
+                {
+                    (*SharedComplete)(std::move(*Result));
+                });
+            },
+            [SharedComplete]()
+            {
+                (*SharedComplete)(ResultType{});
+            });
+        }
+
+        // 相机移动后调整尚未开始加载的请求的优先级，返回请求是否仍在等待，已开始或已完成时没有效果
+        bool UpdatePriority(RequestId Id, float Priority);
+
+        // 取消尚未开始加载的请求，返回是否取消成功，成功时OnComplete在之后的PumpCompletions中以空结果执行
+        bool Cancel(RequestId Id);
+
+        // 执行至多MaxCount个已完成请求的回调，返回执行的数量，用于限制每帧的上传量
+        std::size_t PumpCompletions(std::size_t MaxCount = std::numeric_limits<std::size_t>::max());
+
+        // 等待中、加载中与等待回调的请求总数
+        std::size_t GetOutstandingCount() const;
+
+    private:
+        using CompletionFunc = std::function<void()>;
+        using LoadJob = std::function<CompletionFunc()>;
+
+        struct PendingRequest
+        {
+            LoadJob Job;
+            // 取消时放入完成队列的回调
+            CompletionFunc OnCancelled;
+            float Priority = 0.0f;
+            // 每次调整优先级递增，队列中版本不一致的条目已经过期
+            std::uint32_t Version = 0;
+        };
+
+        struct QueueEntry
+        {
+            float Priority;
+            RequestId Id;
+            std::uint32_t Version;
+
+            // priority_queue是大顶堆，优先级数值小、提交早的请求排在前面
+            bool operator<(const QueueEntry& Other) const
+            {
+                return Priority != Other.Priority ? Priority > Other.Priority : Id > Other.Id;
+            }
+        };
+
+        RequestId Push(float Priority, LoadJob Job, CompletionFunc OnCancelled);
+
+        void WorkerLoop();
+
+        mutable std::mutex Mutex;
+        std::condition_variable Condition;
+        std::priority_queue<QueueEntry> Queue;
+        std::unordered_map<RequestId, PendingRequest> PendingRequests;
+        std::size_t LoadingCount = 0;
+        std::deque<CompletionFunc> Completions;
+        RequestId NextRequestId = 1;
+        bool bStopping = false;
+
+        std::vector<std::thread> Workers;
+    };
+}
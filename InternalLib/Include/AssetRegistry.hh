@@ -0,0 +1,289 @@
+#pragma once
+
+#include "Hash.hh"
+#include "Logger.hh"
+#include "Mixins.hh"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SilverBell::Assets
+{
+    /*
+     * 32位代数句柄，低20位为槽位下标，高12位为槽位代数
+     * 槽位被回收后代数递增，持有旧句柄访问时得到空指针而不是被复用的资产
+     */
+    template<typename T>
+    struct AssetHandle
+    {
+        static constexpr std::uint32_t IndexBits = 20;
+        static constexpr std::uint32_t IndexMask = (1u << IndexBits) - 1;
+        static constexpr std::uint32_t GenerationMask = (1u << (32 - IndexBits)) - 1;
+
+        // 代数从1开始，0为无效句柄
+        std::uint32_t Value = 0;
+
+        std::uint32_t GetIndex() const { return Value & IndexMask; }
+        std::uint32_t GetGeneration() const { return Value >> IndexBits; }
+        bool IsValid() const { return Value != 0; }
+
+        bool operator==(const AssetHandle& Other) const = default;
+
+        static AssetHandle Make(std::uint32_t Index, std::uint32_t Generation)
+        {
+            return { (Generation << IndexBits) | Index };
+        }
+    };
+
+    /*
+     * 引用计数的资产注册表
+     * 以路径去重，同一路径的资产只保留一份，引用计数归零后资产进入待销毁列表，
+     * 等调用方确认使用它的GPU帧执行完毕(CollectGarbage)后才销毁，销毁前仍可被同一路径的请求重新引用
+     * 异步加载由BeginLoad/FinishLoad包围，加载期间同一路径的请求挂到第一个请求上，不会重复加载
+     * 不是线程安全的，只在渲染线程上使用
+     */
+    template<typename T>
+    class FAssetRegistry : public NonCopyable
+    {
+    public:
+        using Handle = AssetHandle<T>;
+        // 销毁资产前调用，用于释放资产持有的GPU资源
+        using DestroyFunc = std::function<void(T&)>;
+        // 异步加载完成后调用，每个等待者各持有一个引用，加载失败时为空句柄
+        using LoadedFunc = std::function<void(Handle)>;
+
+        explicit FAssetRegistry(DestroyFunc InOnDestroy = {})
+            : OnDestroy(std::move(InOnDestroy))
+        {
+        }
+
+        ~FAssetRegistry()
+        {
+            Clear();
+        }
+
+        // 查找已注册的资产，命中时增加引用计数
+        Handle Find(std::string_view Path)
+        {
+            const auto Iter = PathToSlot.find(Path);
+            if (Iter == PathToSlot.end()) return {};
+
+            Slot& CurrentSlot = Slots[Iter->second];
+            ++CurrentSlot.RefCount;
+            return Handle::Make(Iter->second, CurrentSlot.Generation);
+        }
+
+        // 注册资产，引用计数为1；同一路径已注册时丢弃传入的资产并返回已有资产的句柄
+        Handle Add(std::string_view Path, std::unique_ptr<T> Asset)
+        {
+            if (Handle Existing = Find(Path); Existing.IsValid()) return Existing;
+            if (Asset == nullptr) return {};
+
+            std::uint32_t Index;
+            if (!FreeSlots.empty())
+            {
+                Index = FreeSlots.back();
+                FreeSlots.pop_back();
+            }
+            else
+            {
+                if (Slots.size() > Handle::IndexMask)
+                {
+                    LOG_ERROR("资产数量超过句柄上限: {}", Handle::IndexMask + 1);
+                    throw std::runtime_error("Asset registry is full!");
+                }
+                Index = static_cast<std::uint32_t>(Slots.size());
+                Slots.emplace_back();
+            }
+
+            Slot& NewSlot = Slots[Index];
+            NewSlot.Asset = std::move(Asset);
+            NewSlot.Path = Path;
+            NewSlot.RefCount = 1;
+            PathToSlot.emplace(NewSlot.Path, Index);
+            return Handle::Make(Index, NewSlot.Generation);
+        }
+
+        // 先查找，未注册时同步调用Load()加载，Load返回std::unique_ptr<T>，失败时返回空句柄
+        template<typename LoadFunc>
+        Handle Acquire(std::string_view Path, LoadFunc&& Load)
+        {
+            if (Handle Existing = Find(Path); Existing.IsValid()) return Existing;
+            return Add(Path, Load());
+        }
+
+        /*
+         * 开始异步加载，返回调用方是否需要发起加载
+         * 路径已注册时立即以新的引用调用OnLoaded，已在加载中时把OnLoaded挂到该加载上，这两种情况返回false
+         * 返回true时调用方需在加载结束后(包括失败)调用FinishLoad
+         */
+        bool BeginLoad(std::string_view Path, LoadedFunc OnLoaded)
+        {
+            if (Handle Existing = Find(Path); Existing.IsValid())
+            {
+                OnLoaded(Existing);
+                return false;
+            }
+
+            auto [Iter, bInserted] = PendingLoads.try_emplace(std::string(Path));
+            Iter->second.push_back(std::move(OnLoaded));
+            return bInserted;
+        }
+
+        // 注册加载结果并通知所有等待者，Asset为空表示加载失败
+        void FinishLoad(std::string_view Path, std::unique_ptr<T> Asset)
+        {
+            const auto Iter = PendingLoads.find(Path);
+            if (Iter == PendingLoads.end()) return;
+            // 回调中可能再次请求或释放资产，先移出等待列表
+            std::vector<LoadedFunc> Waiters = std::move(Iter->second);
+            PendingLoads.erase(Iter);
+
+            const Handle Loaded = Add(Path, std::move(Asset));
+            for (std::size_t Idx = 0; Idx < Waiters.size(); ++Idx)
+            {
+                // Add已经计入了第一个等待者的引用
+                if (Idx > 0) AddRef(Loaded);
+                Waiters[Idx](Loaded);
+            }
+        }
+
+        bool IsLoading(std::string_view Path) const
+        {
+            return PendingLoads.contains(Path);
+        }
+
+        void AddRef(Handle InHandle)
+        {
+            if (Slot* CurrentSlot = GetSlot(InHandle))
+            {
+                ++CurrentSlot->RefCount;
+            }
+        }
+
+        // 释放引用并清空句柄，RetireFrame为最后一个可能使用该资产的GPU帧
+        void Release(Handle& InHandle, std::uint64_t RetireFrame = 0)
+        {
+            Slot* CurrentSlot = GetSlot(InHandle);
+            InHandle = {};
+            if (CurrentSlot == nullptr || CurrentSlot->RefCount == 0) return;
+
+            if (--CurrentSlot->RefCount == 0)
+            {
+                CurrentSlot->RetireFrame = RetireFrame;
+                if (!CurrentSlot->bRetired)
+                {
+                    CurrentSlot->bRetired = true;
+                    RetiredSlots.push_back(static_cast<std::uint32_t>(CurrentSlot - Slots.data()));
+                }
+            }
+        }
+
+        // 句柄过期或资产已销毁时返回空指针
+        T* Get(Handle InHandle) const
+        {
+            const Slot* CurrentSlot = GetSlot(InHandle);
+            return CurrentSlot ? CurrentSlot->Asset.get() : nullptr;
+        }
+
+        // 销毁RetireFrame不晚于CompletedFrame且没有被重新引用的资产，返回销毁的数量
+        std::size_t CollectGarbage(std::uint64_t CompletedFrame)
+        {
+            std::size_t DestroyedCount = 0;
+            std::erase_if(RetiredSlots, [&](std::uint32_t Index)
+            {
+                Slot& CurrentSlot = Slots[Index];
+                if (CurrentSlot.RefCount > 0)
+                {
+                    // 等待销毁期间被重新引用
+                    CurrentSlot.bRetired = false;
+                    return true;
+                }
+                if (CurrentSlot.RetireFrame > CompletedFrame) return false;
+
+                DestroySlot(Index);
+                ++DestroyedCount;
+                return true;
+            });
+            return DestroyedCount;
+        }
+
+        // 不论引用计数销毁全部资产，调用前需确保GPU已不再使用它们，已发出的句柄全部失效
+        void Clear()
+        {
+            for (std::uint32_t Index = 0; Index < Slots.size(); ++Index)
+            {
+                if (Slots[Index].Asset) DestroySlot(Index);
+            }
+            RetiredSlots.clear();
+        }
+
+        std::size_t GetLiveCount() const { return PathToSlot.size(); }
+
+    private:
+        struct Slot
+        {
+            std::unique_ptr<T> Asset;
+            std::string Path;
+            std::uint32_t Generation = 1;
+            std::uint32_t RefCount = 0;
+            std::uint64_t RetireFrame = 0;
+            bool bRetired = false;
+        };
+
+        // 支持以string_view查找，避免每次查找构造std::string
+        struct PathHasher
+        {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view Path) const noexcept
+            {
+                return static_cast<std::size_t>(Algorithm::HashFunction::Hash64(Path.data(), Path.size()));
+            }
+        };
+
+        template<typename ValueType>
+        using PathMap = std::unordered_map<std::string, ValueType, PathHasher, std::equal_to<>>;
+
+        Slot* GetSlot(Handle InHandle)
+        {
+            return const_cast<Slot*>(std::as_const(*this).GetSlot(InHandle));
+        }
+
+        const Slot* GetSlot(Handle InHandle) const
+        {
+            if (!InHandle.IsValid() || InHandle.GetIndex() >= Slots.size()) return nullptr;
+            const Slot& CurrentSlot = Slots[InHandle.GetIndex()];
+            if (CurrentSlot.Generation != InHandle.GetGeneration() || CurrentSlot.Asset == nullptr) return nullptr;
+            return &CurrentSlot;
+        }
+
+        void DestroySlot(std::uint32_t Index)
+        {
+            Slot& CurrentSlot = Slots[Index];
+            if (OnDestroy) OnDestroy(*CurrentSlot.Asset);
+            CurrentSlot.Asset.reset();
+            PathToSlot.erase(CurrentSlot.Path);
+            CurrentSlot.Path.clear();
+            CurrentSlot.RefCount = 0;
+            CurrentSlot.bRetired = false;
+            // 代数回绕时跳过0，保证句柄值不为0
+            CurrentSlot.Generation = CurrentSlot.Generation == Handle::GenerationMask ? 1 : CurrentSlot.Generation + 1;
+            FreeSlots.push_back(Index);
+        }
+
+        DestroyFunc OnDestroy;
+        std::vector<Slot> Slots;
+        std::vector<std::uint32_t> FreeSlots;
+        std::vector<std::uint32_t> RetiredSlots;
+        PathMap<std::uint32_t> PathToSlot;
+        PathMap<std::vector<LoadedFunc>> PendingLoads;
+    };
+}
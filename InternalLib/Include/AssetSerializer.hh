@@ -0,0 +1,430 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+
+#include "Hash.hh"
+#include "Logger.hh"
+#include "Math.hh"
+
+#include <ylt/reflection/member_value.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace SilverBell::Assets
+{
+    /*
+     * 烘焙资产文件格式
+     * [文件头][根结构体]
+     * 结构体: [u32 字段数] + 逐字段 [u32 字段名哈希][u64 字节数][数据]，字节数用于跳过不认识的字段
+     * 字符串: 原始字节；元素为标量或Eigen矩阵等可按位拷贝的非结构体的vector: [u32 元素大小][u32 0][元素数据]，加载时一次memcpy
+     * 其他vector(包括元素为可按位拷贝的反射结构体): [u64 元素数] + 逐元素 [u64 字节数][数据]，元素的字段同样按名字匹配；
+     * 其他可按位拷贝的类型: 原始字节
+     * 结构体哈希与代码一致时字段按顺序一一对应，不一致时按字段名匹配，新增的字段保持默认值
+     */
+    struct AssetFileHeader
+    {
+        std::uint32_t Magic;
+        std::uint32_t FormatVersion;
+        std::uint64_t SchemaHash;
+        // 资产类型的static constexpr AssetVersion，字段含义变化而名字不变时由资产类型递增
+        std::uint32_t AssetVersion;
+        std::uint32_t Reserved;
+        std::uint64_t PayloadSize;
+    };
+
+    namespace Serialization
+    {
+        template<typename T>
+        struct IsVector : std::false_type {};
+        template<typename E, typename A>
+        struct IsVector<std::vector<E, A>> : std::true_type {};
+
+        template<typename T>
+        struct IsArray : std::false_type {};
+        template<typename E, std::size_t N>
+        struct IsArray<std::array<E, N>> : std::true_type {};
+
+        // Eigen定长矩阵有自定义的拷贝构造函数，但内存布局就是标量数组
+        template<typename T>
+        concept FixedSizeMatrix = std::is_base_of_v<Eigen::PlainObjectBase<T>, T> && T::SizeAtCompileTime != Eigen::Dynamic;
+
+        template<typename T>
+        concept StringLike = std::is_same_v<T, std::string> || std::is_same_v<T, std::filesystem::path>;
+
+        template<typename T>
+        concept Bitwise = FixedSizeMatrix<T> || (std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>);
+
+        template<typename T>
+        concept Reflected = std::is_class_v<T> && !StringLike<T> && !IsVector<T>::value && !IsArray<T>::value
+                            && !FixedSizeMatrix<T> && (ylt::reflection::members_count_v<T> > 0);
+
+        // 整块拷贝的vector元素，反射结构体即使可按位拷贝也逐元素按字段写入，字段增删或重排后仍能按名字读取
+        template<typename T>
+        concept BlockElement = Bitwise<T> && !Reflected<T>;
+
+        template<typename T>
+        constexpr std::uint32_t AssetVersionOf()
+        {
+            if constexpr (requires { T::AssetVersion; }) return T::AssetVersion;
+            else return 0;
+        }
+
+        inline std::uint32_t HashName(std::string_view Name)
+        {
+            return static_cast<std::uint32_t>(Algorithm::HashFunction::Hash64(Name.data(), Name.size()));
+        }
+
+        // 类型结构的哈希，包含字段名、字段类型与可按位拷贝类型的大小
+        template<typename T>
+        std::uint64_t ComputeSchemaHash()
+        {
+            using Algorithm::HashFunction;
+            if constexpr (StringLike<T>)
+            {
+                return 'S';
+            }
+            else if constexpr (IsVector<T>::value)
+            {
+                return HashFunction::HashCombine(std::uint64_t{ 'V' }, ComputeSchemaHash<typename T::value_type>());
+            }
+            else if constexpr (Reflected<T>)
+            {
+                // 含有vector等成员的结构体大小与标准库实现有关，只有按位拷贝的结构体才计入大小
+                std::uint64_t Seed = Bitwise<T> ? HashFunction::HashCombine(std::uint64_t{ 'R' }, std::uint64_t{ sizeof(T) }) : 'R';
+                const T Prototype{};
+                ylt::reflection::for_each(Prototype, [&Seed](auto& Field, auto Name, auto Index)
+                {
+                    Seed = HashFunction::HashCombine(Seed, std::uint64_t{ HashName(std::string_view(Name)) });
+                    Seed = HashFunction::HashCombine(Seed, ComputeSchemaHash<std::remove_cvref_t<decltype(Field)>>());
+                });
+                return Seed;
+            }
+            else
+            {
+                static_assert(Bitwise<T>, "Unsupported asset field type");
+                return HashFunction::HashCombine(std::uint64_t{ 'B' }, std::uint64_t{ sizeof(T) });
+            }
+        }
+
+        template<typename T>
+        const std::array<std::uint32_t, ylt::reflection::members_count_v<T>>& GetFieldNameHashes()
+        {
+            static const auto NameHashes = []()
+            {
+                std::array<std::uint32_t, ylt::reflection::members_count_v<T>> Result = {};
+                const T Prototype{};
+                ylt::reflection::for_each(Prototype, [&Result](auto& Field, auto Name, auto Index)
+                {
+                    Result[static_cast<std::size_t>(Index)] = HashName(std::string_view(Name));
+                });
+                return Result;
+            }();
+            return NameHashes;
+        }
+
+        inline void Append(std::vector<std::byte>& Buffer, const void* Data, std::size_t Size)
+        {
+            if (Size == 0) return;
+            const std::size_t Offset = Buffer.size();
+            Buffer.resize(Offset + Size);
+            std::memcpy(Buffer.data() + Offset, Data, Size);
+        }
+
+        template<typename T>
+        void AppendPod(std::vector<std::byte>& Buffer, const T& Value)
+        {
+            Append(Buffer, &Value, sizeof(T));
+        }
+
+        // 顺序读取，越界时返回false
+        struct ByteReader
+        {
+            std::span<const std::byte> Data;
+            std::size_t Offset = 0;
+
+            bool Read(void* Dest, std::size_t Size)
+            {
+                if (Size > Data.size() - Offset) return false;
+                if (Size > 0) std::memcpy(Dest, Data.data() + Offset, Size);
+                Offset += Size;
+                return true;
+            }
+
+            bool Take(std::size_t Size, std::span<const std::byte>& OutData)
+            {
+                if (Size > Data.size() - Offset) return false;
+                OutData = Data.subspan(Offset, Size);
+                Offset += Size;
+                return true;
+            }
+        };
+
+        template<typename T>
+        void WriteValue(std::vector<std::byte>& Buffer, const T& Value);
+
+        // 写入 [u64 字节数][数据]，字节数在数据写完后回填
+        template<typename T>
+        void WriteSized(std::vector<std::byte>& Buffer, const T& Value)
+        {
+            const std::size_t SizeOffset = Buffer.size();
+            AppendPod(Buffer, std::uint64_t{ 0 });
+            WriteValue(Buffer, Value);
+            const std::uint64_t Size = Buffer.size() - SizeOffset - sizeof(std::uint64_t);
+            std::memcpy(Buffer.data() + SizeOffset, &Size, sizeof(Size));
+        }
+
+        template<typename T>
+        void WriteValue(std::vector<std::byte>& Buffer, const T& Value)
+        {
+            if constexpr (std::is_same_v<T, std::string>)
+            {
+                Append(Buffer, Value.data(), Value.size());
+            }
+            else if constexpr (std::is_same_v<T, std::filesystem::path>)
+            {
+                const std::u8string PathString = Value.generic_u8string();
+                Append(Buffer, PathString.data(), PathString.size());
+            }
+            else if constexpr (IsVector<T>::value)
+            {
+                using ElementType = typename T::value_type;
+                if constexpr (BlockElement<ElementType>)
+                {
+                    AppendPod(Buffer, static_cast<std::uint32_t>(sizeof(ElementType)));
+                    AppendPod(Buffer, std::uint32_t{ 0 });
+                    Append(Buffer, Value.data(), Value.size() * sizeof(ElementType));
+                }
+                else
+                {
+                    AppendPod(Buffer, static_cast<std::uint64_t>(Value.size()));
+                    for (const auto& Element : Value)
+                    {
+                        WriteSized(Buffer, Element);
+                    }
+                }
+            }
+            else if constexpr (Reflected<T>)
+            {
+                AppendPod(Buffer, static_cast<std::uint32_t>(ylt::reflection::members_count_v<T>));
+                const auto& NameHashes = GetFieldNameHashes<T>();
+                ylt::reflection::for_each(Value, [&Buffer, &NameHashes](auto& Field, auto Name, auto Index)
+                {
+                    AppendPod(Buffer, NameHashes[static_cast<std::size_t>(Index)]);
+                    WriteSized(Buffer, Field);
+                });
+            }
+            else if constexpr (FixedSizeMatrix<T>)
+            {
+                Append(Buffer, Value.data(), sizeof(typename T::Scalar) * T::SizeAtCompileTime);
+            }
+            else
+            {
+                static_assert(Bitwise<T>, "Unsupported asset field type");
+                AppendPod(Buffer, Value);
+            }
+        }
+
+        // 数据与类型不匹配时返回false，调用方保留该值的默认值
+        template<typename T>
+        bool ReadValue(std::span<const std::byte> Data, T& Value)
+        {
+            if constexpr (std::is_same_v<T, std::string>)
+            {
+                Value.assign(reinterpret_cast<const char*>(Data.data()), Data.size());
+                return true;
+            }
+            else if constexpr (std::is_same_v<T, std::filesystem::path>)
+            {
+                Value = std::u8string(reinterpret_cast<const char8_t*>(Data.data()), Data.size());
+                return true;
+            }
+            else if constexpr (IsVector<T>::value)
+            {
+                using ElementType = typename T::value_type;
+                ByteReader Reader{ Data };
+                if constexpr (BlockElement<ElementType>)
+                {
+                    std::uint32_t ElementSize = 0;
+                    std::uint32_t Padding = 0;
+                    if (!Reader.Read(&ElementSize, sizeof(ElementSize)) || !Reader.Read(&Padding, sizeof(Padding))) return false;
+                    const std::size_t ByteCount = Data.size() - Reader.Offset;
+                    if (ElementSize != sizeof(ElementType) || ByteCount % sizeof(ElementType) != 0) return false;
+                    Value.resize(ByteCount / sizeof(ElementType));
+                    return Reader.Read(Value.data(), ByteCount);
+                }
+                else
+                {
+                    std::uint64_t Count = 0;
+                    // 每个元素至少有8字节的长度前缀，元素数不可能超过剩余字节数的1/8
+                    if (!Reader.Read(&Count, sizeof(Count)) || Count > (Data.size() - Reader.Offset) / sizeof(std::uint64_t)) return false;
+                    Value.clear();
+                    Value.resize(static_cast<std::size_t>(Count));
+                    for (auto& Element : Value)
+                    {
+                        std::uint64_t Size = 0;
+                        std::span<const std::byte> ElementData;
+                        if (!Reader.Read(&Size, sizeof(Size)) || !Reader.Take(static_cast<std::size_t>(Size), ElementData)
+                            || !ReadValue(ElementData, Element))
+                        {
+                            Value.clear();
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+            }
+            else if constexpr (Reflected<T>)
+            {
+                constexpr std::size_t MemberCount = ylt::reflection::members_count_v<T>;
+                const auto& NameHashes = GetFieldNameHashes<T>();
+                ByteReader Reader{ Data };
+                std::uint32_t FieldCount = 0;
+                if (!Reader.Read(&FieldCount, sizeof(FieldCount))) return false;
+
+                std::size_t ExpectedField = 0;
+                for (std::uint32_t Record = 0; Record < FieldCount; ++Record)
+                {
+                    std::uint32_t NameHash = 0;
+                    std::uint64_t Size = 0;
+                    std::span<const std::byte> FieldData;
+                    if (!Reader.Read(&NameHash, sizeof(NameHash)) || !Reader.Read(&Size, sizeof(Size))
+                        || !Reader.Take(static_cast<std::size_t>(Size), FieldData))
+                    {
+                        return false;
+                    }
+
+                    // 结构未变化时总是命中下一个字段，否则按名字查找，找不到说明字段已被删除，直接跳过
+                    std::size_t FieldIndex = ExpectedField;
+                    if (FieldIndex >= MemberCount || NameHashes[FieldIndex] != NameHash)
+                    {
+                        FieldIndex = static_cast<std::size_t>(std::find(NameHashes.begin(), NameHashes.end(), NameHash) - NameHashes.begin());
+                        if (FieldIndex == MemberCount) continue;
+                    }
+                    ExpectedField = FieldIndex + 1;
+
+                    ylt::reflection::for_each(Value, [FieldIndex, FieldData](auto& Field, auto Name, auto Index)
+                    {
+                        if (static_cast<std::size_t>(Index) != FieldIndex) return;
+                        if (!ReadValue(FieldData, Field))
+                        {
+                            LOG_DEBUG("资产字段 {} 的类型已变化，保持默认值", std::string_view(Name));
+                        }
+                    });
+                }
+                return true;
+            }
+            else if constexpr (FixedSizeMatrix<T>)
+            {
+                constexpr std::size_t Size = sizeof(typename T::Scalar) * T::SizeAtCompileTime;
+                if (Data.size() != Size) return false;
+                std::memcpy(Value.data(), Data.data(), Size);
+                return true;
+            }
+            else
+            {
+                static_assert(Bitwise<T>, "Unsupported asset field type");
+                if (Data.size() != sizeof(T)) return false;
+                std::memcpy(&Value, Data.data(), sizeof(T));
+                return true;
+            }
+        }
+    }
+
+    /*
+     * 基于YLT_REFL反射的烘焙资产序列化
+     * 支持反射的结构体(可嵌套)、std::string、std::filesystem::path、std::vector与可按位拷贝的类型(含Eigen定长矩阵)，
+     * 元素为标量或Eigen矩阵的vector直接整块拷贝，加载速度接近内存带宽
+     */
+    class INTERNALLIB_API FAssetSerializer
+    {
+    public:
+        FAssetSerializer() = delete;
+        ~FAssetSerializer() = delete;
+
+        static constexpr std::uint32_t Magic = 0x53414253; // "SBAS"
+        // 文件格式本身变化时需要递增
+        static constexpr std::uint32_t FormatVersion = 2;
+
+        template<typename T>
+        static std::uint64_t GetSchemaHash()
+        {
+            static const std::uint64_t SchemaHash = Serialization::ComputeSchemaHash<T>();
+            return SchemaHash;
+        }
+
+        template<typename T>
+        static std::vector<std::byte> Serialize(const T& Asset)
+        {
+            static_assert(Serialization::Reflected<T>, "Asset type must be reflected");
+            std::vector<std::byte> Buffer(sizeof(AssetFileHeader));
+            Serialization::WriteValue(Buffer, Asset);
+
+            AssetFileHeader Header = {};
+            Header.Magic = Magic;
+            Header.FormatVersion = FormatVersion;
+            Header.SchemaHash = GetSchemaHash<T>();
+            Header.AssetVersion = Serialization::AssetVersionOf<T>();
+            Header.PayloadSize = Buffer.size() - sizeof(AssetFileHeader);
+            std::memcpy(Buffer.data(), &Header, sizeof(Header));
+            return Buffer;
+        }
+
+        // 文件头不匹配、资产版本比代码新或数据损坏时返回false，OutAsset的内容不确定
+        template<typename T>
+        static bool Deserialize(std::span<const std::byte> Data, T& OutAsset)
+        {
+            static_assert(Serialization::Reflected<T>, "Asset type must be reflected");
+            const auto Header = ReadHeader(Data, Serialization::AssetVersionOf<T>());
+            if (!Header.has_value()) return false;
+
+            if (Header->SchemaHash != GetSchemaHash<T>())
+            {
+                LOG_DEBUG("资产结构已变化，按字段名读取");
+            }
+            if (!Serialization::ReadValue(Data.subspan(sizeof(AssetFileHeader)), OutAsset))
+            {
+                LOG_WARN("资产数据已损坏");
+                return false;
+            }
+            return true;
+        }
+
+        template<typename T>
+        static bool SaveToFile(const std::filesystem::path& FilePath, const T& Asset)
+        {
+            return WriteFile(FilePath, Serialize(Asset));
+        }
+
+        // 文件整体映射后直接解析，不存在或无法读取时返回false
+        template<typename T>
+        static bool LoadFromFile(const std::filesystem::path& FilePath, T& OutAsset)
+        {
+            bool bResult = false;
+            ReadFile(FilePath, [&bResult, &OutAsset](std::span<const std::byte> Data)
+            {
+                bResult = Deserialize(Data, OutAsset);
+            });
+            return bResult;
+        }
+
+    private:
+        // 校验文件头与负载大小，资产版本高于MaxAssetVersion时视为无法读取
+        static std::optional<AssetFileHeader> ReadHeader(std::span<const std::byte> Data, std::uint32_t MaxAssetVersion);
+
+        // 先写临时文件再重命名，避免读到写了一半的文件
+        static bool WriteFile(const std::filesystem::path& FilePath, std::span<const std::byte> Data);
+
+        static void ReadFile(const std::filesystem::path& FilePath, const std::function<void(std::span<const std::byte>)>& Callback);
+    };
+}
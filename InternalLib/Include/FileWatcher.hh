@@ -0,0 +1,57 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+#include "Mixins.hh"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace SilverBell::Utility
+{
+    /*
+     * 文件监视器
+     * 在后台线程中监视一组文件，文件被修改后回调变化的文件列表，短时间内的多次修改会被合并成一次回调
+     * Linux下使用inotify监视文件所在的目录，以便正确处理编辑器先写临时文件再重命名的保存方式，其他平台退化为轮询修改时间
+     */
+    class INTERNALLIB_API FFileWatcher : public NonCopyable
+    {
+    public:
+        using ChangeCallback = std::function<void(const std::vector<std::filesystem::path>&)>;
+
+        // 回调在监视线程上调用
+        explicit FFileWatcher(ChangeCallback iOnChanged, std::chrono::milliseconds iDebounceTime = std::chrono::milliseconds(100));
+        ~FFileWatcher();
+
+        // 线程安全，重复添加同一个文件没有副作用
+        void Watch(const std::filesystem::path& FilePath);
+
+    private:
+        void Run();
+
+        // 返回本轮检测到变化的文件，最多阻塞Timeout时长
+        std::vector<std::filesystem::path> WaitForChanges(std::chrono::milliseconds Timeout);
+
+        ChangeCallback OnChanged;
+        std::chrono::milliseconds DebounceTime;
+
+        std::mutex Mutex;
+        // 被监视文件的绝对路径与最后修改时间
+        std::map<std::filesystem::path, std::filesystem::file_time_type> WatchedFiles;
+
+#ifdef __linux__
+        int InotifyFd = -1;
+        // inotify监视描述符与目录的对应关系
+        std::unordered_map<int, std::filesystem::path> WatchedDirectories;
+#endif
+
+        std::atomic<bool> bStopping = false;
+        std::thread WatchThread;
+    };
+}
@@ -6,6 +6,8 @@
 
 #include <ylt/reflection/member_value.hpp>
 
+#include <filesystem>
+
 template<typename T>
 concept HasMembers = requires { ylt::reflection::members_count_v<T> != 0; };
 
@@ -26,7 +28,12 @@ namespace SilverBell::Algorithm
         template<typename T>
         static std::uint64_t Hash64(const T& Data)
         {
-            if constexpr (IsStdContainer<T>)
+            if constexpr (std::is_same_v<T, std::filesystem::path>)
+            {
+                // path对象内部持有堆内存，必须对路径字符串本身求哈希，否则哈希值在不同进程间不稳定
+                return Hash64(Data.native());
+            }
+            else if constexpr (IsStdContainer<T>)
             {
                 using MemberType = typename T::value_type;
                 // 如果MemberType仍然是标准容器，则递归调用Hash64
@@ -2,8 +2,11 @@
 
 #include "InternalLibMarco.hh"
 
-#include <string_view>
+#include <cstddef>
 #include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
 
 namespace SilverBell
 {
@@ -20,10 +23,25 @@ namespace SilverBell
             uint32_t Width = 0;
             uint32_t Height = 0;
             uint8_t Channels = 0; // 通道数，默认为4
+            // 像素写入了调用方提供的内存，FreeImage不释放
+            bool bExternalPixels = false;
+
+            std::size_t GetDataSize() const { return static_cast<std::size_t>(Width) * Height * 4; }
         };
 
         static std::optional<ImageInfo> ImportImage(std::string_view FilePath);
 
+        // 只读取文件头得到尺寸，Pixels为空，用于预先分配批量解码的目标内存
+        static std::vector<std::optional<ImageInfo>> QueryImages(std::span<const std::string_view> FilePaths);
+
+        /*
+         * 在线程池上并行解码多张图片，像素统一为RGBA8
+         * Destinations为空时像素来自缓冲池，用完需FreeImage归还；
+         * 否则Destinations[i]至少需要GetDataSize()字节(例如映射的暂存缓冲区中的一段)，解码结果直接写入其中，空间不足的图片视为失败
+         */
+        static std::vector<std::optional<ImageInfo>> ImportImages(std::span<const std::string_view> FilePaths,
+                                                                  std::span<const std::span<std::byte>> Destinations = {});
+
         static void FreeImage(ImageInfo& ImageInfo);
 
     };
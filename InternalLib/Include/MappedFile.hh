@@ -0,0 +1,35 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+#include "Mixins.hh"
+
+#include <filesystem>
+#include <span>
+
+namespace SilverBell::Utility
+{
+    /*
+     * 只读内存映射文件
+     * 映射的生命周期与对象一致，GetData返回的内存在对象销毁后失效
+     */
+    class INTERNALLIB_API FMappedFile : public NonCopyable
+    {
+    public:
+        // 打开或映射失败时抛出异常
+        explicit FMappedFile(const std::filesystem::path& FilePath);
+        ~FMappedFile();
+
+        std::span<const char> GetData() const { return { Data, Size }; }
+
+        std::size_t GetSize() const { return Size; }
+
+    private:
+        const char* Data = nullptr;
+        std::size_t Size = 0;
+
+#ifdef _WIN32
+        void* FileHandle = nullptr;
+        void* MappingHandle = nullptr;
+#endif
+    };
+}
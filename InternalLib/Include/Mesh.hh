@@ -2,6 +2,10 @@
 
 #include "Math.hh"
 
+#include <cstdint>
+#include <span>
+#include <vector>
+
 #include <ylt/reflection/member_value.hpp>
 
 namespace SilverBell::Assets
@@ -13,18 +17,94 @@ namespace SilverBell::Assets
         std::vector<Math::Vec2> TexCoord;
     };
 
+    // 相对网格包围盒量化到[-1, 1]的16位位置，W为填充，对应VK_FORMAT_R16G16B16A16_SNORM
+    struct QuantizedPosition
+    {
+        int16_t X, Y, Z, W;
+    };
+
+    // 八面体映射编码的单位法线，对应VK_FORMAT_R16G16_SNORM
+    struct OctahedralNormal
+    {
+        int16_t X, Y;
+    };
+
+    // 半精度纹理坐标，对应VK_FORMAT_R16G16_SFLOAT
+    struct HalfTexcoord
+    {
+        uint16_t U, V;
+    };
+
+    // 对应VK_FORMAT_R8G8B8A8_UNORM
+    struct ColorRGBA8
+    {
+        uint8_t R, G, B, A;
+    };
+
+    // 上传到GPU的量化顶点，每个顶点20字节，前三个成员与BaseMesh一致，法线为八面体编码
+    struct QuantizedMesh
+    {
+        std::vector<QuantizedPosition> Positions;
+        std::vector<ColorRGBA8> Color;
+        std::vector<HalfTexcoord> TexCoord;
+        std::vector<OctahedralNormal> Normal;
+    };
+
+    // 位置的反量化参数，解码为 Quantized * PositionScale + PositionBias
+    struct QuantizationParams
+    {
+        Math::Vec4 PositionScale = Math::Vec4::Ones();
+        Math::Vec4 PositionBias = Math::Vec4::Zero();
+    };
+
     struct Mesh
     {
         std::vector<Math::Vec3> Positions;
         std::vector<Math::Vec3> Normals;
         std::vector<Math::Vec2> Texcoords;
+        // xyz为切线，w为副切线方向，见FMeshGeometry::ComputeTangents
+        std::vector<Math::Vec4> Tangents;
 
         std::vector<uint32_t> Indices;  // 每3个为一组
     };
 
+    /*
+     * 紧凑索引缓冲
+     * 顶点数量不超过65536时使用16位索引，否则使用32位索引，Indices16与Indices32只有一个非空
+     */
     struct MeshIndices
     {
-        std::vector<uint32_t> Indices;
+        std::vector<uint16_t> Indices16;
+        std::vector<uint32_t> Indices32;
+
+        bool Is16Bit() const { return Indices32.empty(); }
+
+        std::size_t GetIndexCount() const { return Is16Bit() ? Indices16.size() : Indices32.size(); }
+
+        const void* GetData() const
+        {
+            return Is16Bit() ? static_cast<const void*>(Indices16.data()) : static_cast<const void*>(Indices32.data());
+        }
+
+        std::size_t GetDataSize() const
+        {
+            return Is16Bit() ? Indices16.size() * sizeof(uint16_t) : Indices32.size() * sizeof(uint32_t);
+        }
+
+        // 根据顶点数量选择索引宽度并写入
+        void Assign(std::span<const uint32_t> Indices, std::size_t VertexCount)
+        {
+            Indices16.clear();
+            Indices32.clear();
+            if (VertexCount <= std::size_t(UINT16_MAX) + 1)
+            {
+                Indices16.assign(Indices.begin(), Indices.end());
+            }
+            else
+            {
+                Indices32.assign(Indices.begin(), Indices.end());
+            }
+        }
     };
 
     struct MVPMatrix
@@ -32,8 +112,11 @@ namespace SilverBell::Assets
         Math::Mat4  Model;
         Math::Mat4  View;
         Math::Mat4  Projection;
+        // 量化位置的反量化参数，见QuantizationParams
+        Math::Vec4  PositionScale = Math::Vec4::Ones();
+        Math::Vec4  PositionBias = Math::Vec4::Zero();
     };
-    YLT_REFL(MVPMatrix, Model, View, Projection);
+    YLT_REFL(MVPMatrix, Model, View, Projection, PositionScale, PositionBias);
 
     //constexpr inline auto MemberCount = ylt::reflection::members_count_v<MVPMatrix>;
     inline MVPMatrix TestTriangleMeshUniformBufferObject =
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+
+#include "ModelImporter.hh"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+namespace SilverBell
+{
+    /*
+     * 二进制网格缓存文件格式
+     * [文件头][段表][16字节对齐的各段数据]
+     * 段依次为各量化顶点流(与QuantizedMesh成员顺序一致)、索引、LOD层级、meshlet的各个数组，
+     * 加载时整个文件被内存映射，顶点流与索引不经解析直接拷贝到暂存缓冲
+     */
+    struct MeshCacheHeader
+    {
+        std::uint32_t Magic;
+        std::uint32_t Version;
+        std::uint64_t SourceKey;
+        std::uint32_t VertexCount;
+        std::uint32_t IndexCount;
+        std::uint32_t IndexStride;
+        std::uint32_t SectionCount;
+        float BoundingSphere[4];
+        // 量化位置的反量化参数
+        float PositionScale[4];
+        float PositionBias[4];
+    };
+
+    struct MeshCacheSection
+    {
+        std::uint64_t Offset;    // 相对文件开头，16字节对齐
+        std::uint64_t Size;      // 字节数
+    };
+
+    class INTERNALLIB_API FMeshCache
+    {
+    public:
+        FMeshCache() = delete;
+        ~FMeshCache() = delete;
+
+        static constexpr std::uint32_t CacheMagic = 0x434D4253; // "SBMC"
+        // 缓存格式或导入流程变化时需要递增
+        static constexpr std::uint32_t CacheVersion = 5;
+
+        // 缓存文件路径，由源文件路径的哈希命名
+        static std::filesystem::path GetCachePath(const std::filesystem::path& SourcePath);
+
+        // 由源文件的修改时间、大小与导入参数组合成的键，源文件不存在时返回空
+        static std::optional<std::uint64_t> ComputeSourceKey(const std::filesystem::path& SourcePath, const Assets::MeshLODSettings& LODSettings);
+
+        // 缓存不存在、键不匹配或文件损坏时返回空指针
+        static std::unique_ptr<Model> Load(const std::filesystem::path& CachePath, std::uint64_t SourceKey);
+
+        static void Store(const std::filesystem::path& CachePath, std::uint64_t SourceKey, const Model& InModel);
+    };
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+
+#include "Math.hh"
+#include "Mesh.hh"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace SilverBell::Assets
+{
+    struct BoundingBox
+    {
+        Math::Vec3 Min = Math::Vec3::Zero();
+        Math::Vec3 Max = Math::Vec3::Zero();
+
+        Math::Vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+
+        // 半长
+        Math::Vec3 GetExtent() const { return (Max - Min) * 0.5f; }
+    };
+
+    /*
+     * 网格几何计算
+     * 包围体与面法线使用SSE，每次处理4个顶点或4个三角形，顶点数较多时按块分给线程池并行，
+     * 顶点法线与切线先建立顶点到三角形角点的邻接表，再逐顶点汇总，各线程只写自己的顶点，结果与线程数无关
+     */
+    class INTERNALLIB_API FMeshGeometry
+    {
+    public:
+        FMeshGeometry() = delete;
+        ~FMeshGeometry() = delete;
+
+        // 没有顶点时返回全零的包围盒
+        static BoundingBox ComputeBoundingBox(std::span<const Math::Vec3> Positions);
+
+        // 球心取包围盒中心，xyz为球心，w为半径
+        static Math::Vec4 ComputeBoundingSphere(std::span<const Math::Vec3> Positions);
+
+        // 面积加权的平滑顶点法线，没有相邻三角形或相邻三角形都退化的顶点法线为+Z
+        static std::vector<Math::Vec3> ComputeNormals(std::span<const uint32_t> Indices, std::span<const Math::Vec3> Positions);
+
+        /*
+         * 近似MikkTSpace的逐顶点切线，xyz为切线，w为副切线方向(±1)，副切线为 cross(Normal, Tangent) * w
+         * 三角形切线先投影到顶点法线的切平面上再按角点的夹角加权汇总，纹理坐标退化的顶点取任意一个与法线垂直的方向
+         * 与参考实现不同，不会在UV接缝、镜像或平滑组边界拆分顶点，这些位置的切线被平均，与烘焙工具的结果不一致
+         * 副切线方向取决于输入纹理坐标的朝向，导入时翻转过V的纹理坐标得到的w与原始纹理坐标相反
+         */
+        static std::vector<Math::Vec4> ComputeTangents(std::span<const uint32_t> Indices, std::span<const Math::Vec3> Positions,
+                                                       std::span<const Math::Vec3> Normals, std::span<const Math::Vec2> Texcoords);
+
+        // 补全法线(为空时)与切线(有纹理坐标时)
+        static void ComputeVertexFrames(Mesh& InOutMesh);
+    };
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+
+#include "Math.hh"
+#include "Mesh.hh"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace SilverBell::Assets
+{
+    // 索引重排的统计结果，ACMR为每个三角形平均的顶点缓存未命中次数，理想值接近0.5
+    struct VertexCacheReport
+    {
+        float ACMRBefore = 0.0f;
+        float ACMRAfter = 0.0f;
+        std::size_t ClusterCount = 0;
+        // 重叠绘制排序使ACMR超出阈值时会放弃排序，保留Tipsify的输出顺序
+        bool bOverdrawSorted = false;
+    };
+
+    /*
+     * Meshlet数据，按SoA布局平铺存放，各数组可以直接上传为GPU的结构化缓冲
+     * 第i个meshlet的顶点为VertexIndices[VertexOffsets[i], VertexOffsets[i] + VertexCounts[i])，
+     * 三角形为LocalIndices[TriangleOffsets[i] * 3, (TriangleOffsets[i] + TriangleCounts[i]) * 3)，局部索引指向该meshlet的顶点
+     */
+    struct MeshletBuffers
+    {
+        std::vector<uint32_t> VertexOffsets;
+        std::vector<uint32_t> VertexCounts;
+        std::vector<uint32_t> TriangleOffsets;
+        std::vector<uint32_t> TriangleCounts;
+        // xyz为球心，w为半径，用于视锥剔除
+        std::vector<Math::Vec4> BoundingSpheres;
+        // 法线锥顶点，w未使用
+        std::vector<Math::Vec4> ConeApexes;
+        // xyz为锥轴，w为截止值，dot(normalize(ConeApex - CameraPosition), ConeAxis) >= w 时整个meshlet背向相机
+        // 三角形朝向分散到无法构成法线锥时w为1，视为不可剔除
+        std::vector<Math::Vec4> ConeAxisCutoffs;
+
+        // meshlet局部顶点到网格顶点的映射
+        std::vector<uint32_t> VertexIndices;
+        // 每3个为一组
+        std::vector<uint8_t> LocalIndices;
+
+        std::size_t GetMeshletCount() const { return VertexOffsets.size(); }
+    };
+
+    /*
+     * 网格处理
+     * 面向顶点着色吞吐的三角形重排，均原地修改索引：
+     * 1. Tipsify顶点缓存优化，同时在缓存被迫刷新的位置把三角形切分为簇
+     * 2. 重叠绘制优化，簇按朝外程度排序，使外层表面先绘制，提升Early-Z剔除率
+     * 3. 顶点拉取优化，按首次引用顺序重新编号顶点，使顶点缓冲的访问连续
+     * 另外提供meshlet划分，供计算着色器按簇做视锥与背面剔除
+     */
+    class INTERNALLIB_API FMeshProcessing
+    {
+    public:
+        FMeshProcessing() = delete;
+        ~FMeshProcessing() = delete;
+
+        // 模拟的后变换顶点缓存大小，与主流GPU的有效容量相当
+        static constexpr uint32_t DefaultCacheSize = 16;
+
+        // 使用FIFO缓存模拟计算ACMR
+        static float ComputeACMR(std::span<const uint32_t> Indices, std::size_t VertexCount, uint32_t CacheSize = DefaultCacheSize);
+
+        // Tipsify重排，返回每个簇第一个三角形的编号
+        static std::vector<uint32_t> OptimizeVertexCache(std::span<uint32_t> Indices, std::size_t VertexCount, uint32_t CacheSize = DefaultCacheSize);
+
+        // 按簇的朝外程度排序，排序后ACMR超过原来的Threshold倍时不做修改，返回是否排序
+        static bool OptimizeOverdraw(std::span<uint32_t> Indices, std::span<const Math::Vec3> Positions,
+            std::span<const uint32_t> ClusterOffsets, float Threshold = 1.05f, uint32_t CacheSize = DefaultCacheSize);
+
+        // 依次执行顶点缓存优化与重叠绘制优化，返回ACMR的前后对比
+        static VertexCacheReport OptimizeIndexOrder(std::span<uint32_t> Indices, std::span<const Math::Vec3> Positions,
+            float OverdrawThreshold = 1.05f, uint32_t CacheSize = DefaultCacheSize);
+
+        // 按首次引用的顺序重新编号顶点并改写索引，返回旧编号到新编号的映射，未被引用的顶点排在最后
+        static std::vector<uint32_t> OptimizeVertexFetch(std::span<uint32_t> Indices, std::size_t VertexCount);
+
+        // meshlet默认上限，与主流硬件mesh shader的推荐值一致
+        static constexpr uint32_t DefaultMeshletMaxVertices = 64;
+        static constexpr uint32_t DefaultMeshletMaxTriangles = 124;
+
+        // 按索引顺序贪心地把三角形装入meshlet，索引应先经过顶点缓存优化以保证空间连续，局部索引为8位，MaxVertices不能超过256
+        static MeshletBuffers BuildMeshlets(std::span<const uint32_t> Indices, std::span<const Math::Vec3> Positions,
+            uint32_t MaxVertices = DefaultMeshletMaxVertices, uint32_t MaxTriangles = DefaultMeshletMaxTriangles);
+
+        static MeshletBuffers BuildMeshlets(const Mesh& InMesh,
+            uint32_t MaxVertices = DefaultMeshletMaxVertices, uint32_t MaxTriangles = DefaultMeshletMaxTriangles)
+        {
+            return BuildMeshlets(InMesh.Indices, InMesh.Positions, MaxVertices, MaxTriangles);
+        }
+
+        // 按OptimizeVertexFetch返回的映射重排一个顶点属性流
+        template<typename T>
+        static void RemapVertices(std::vector<T>& Vertices, std::span<const uint32_t> Remap)
+        {
+            std::vector<T> Remapped(Vertices.size());
+            for (std::size_t Idx = 0; Idx < Vertices.size(); ++Idx)
+            {
+                Remapped[Remap[Idx]] = std::move(Vertices[Idx]);
+            }
+            Vertices = std::move(Remapped);
+        }
+    };
+}
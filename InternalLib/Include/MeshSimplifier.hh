@@ -0,0 +1,85 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+
+#include "Math.hh"
+#include "Mesh.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace SilverBell::Assets
+{
+    struct MeshLOD
+    {
+        uint32_t IndexOffset = 0;
+        uint32_t IndexCount = 0;
+        // 相对原始网格的几何误差，与顶点坐标同一单位
+        float Error = 0.0f;
+    };
+
+    /*
+     * LOD链
+     * 所有层级共享原始顶点缓冲，索引依次拼接在Indices中，第0层为原始网格
+     */
+    struct MeshLODChain
+    {
+        std::vector<uint32_t> Indices;
+        std::vector<MeshLOD> Levels;
+        // xyz为球心，w为半径
+        Math::Vec4 BoundingSphere = Math::Vec4::Zero();
+
+        /*
+         * 按投影到屏幕上的误差选择层级，返回误差不超过MaxPixelError的最粗层级
+         * ProjectionScale为距离1处每单位长度对应的像素数，透视投影下为 视口高度 / (2 * tan(FovY / 2))
+         */
+        std::size_t SelectLevel(float Distance, float ProjectionScale, float MaxPixelError = 1.0f) const
+        {
+            std::size_t Result = 0;
+            const float PixelsPerUnit = ProjectionScale / std::max(Distance, 1e-4f);
+            for (std::size_t Level = 1; Level < Levels.size(); ++Level)
+            {
+                if (Levels[Level].Error * PixelsPerUnit > MaxPixelError) break;
+                Result = Level;
+            }
+            return Result;
+        }
+    };
+
+    struct MeshLODSettings
+    {
+        // 包括第0层在内的最大层级数
+        uint32_t MaxLevelCount = 4;
+        // 每一层的目标三角形数相对上一层的比例
+        float ReductionRatio = 0.5f;
+        // 每一层允许的最大误差，相对于网格包围球半径
+        float MaxRelativeError = 0.02f;
+    };
+
+    /*
+     * 基于二次误差度量的网格简化
+     * 使用半边坍缩，顶点只会合并到已有顶点上，简化结果可以直接复用原顶点缓冲，
+     * 开放边界和纹理接缝上的顶点被锁定，保证轮廓和贴图不被撕裂
+     */
+    class INTERNALLIB_API FMeshSimplifier
+    {
+    public:
+        FMeshSimplifier() = delete;
+        ~FMeshSimplifier() = delete;
+
+        // 简化到不超过TargetIndexCount个索引或达到TargetError为止，OutError返回实际产生的最大误差
+        static std::vector<uint32_t> Simplify(std::span<const uint32_t> Indices, std::span<const Math::Vec3> Positions,
+            std::size_t TargetIndexCount, float TargetError, float* OutError = nullptr);
+
+        // 逐层简化生成LOD链，某一层无法继续明显减少三角形时提前结束
+        static MeshLODChain BuildLODChain(std::span<const uint32_t> Indices, std::span<const Math::Vec3> Positions,
+            const MeshLODSettings& Settings = {});
+
+        static MeshLODChain BuildLODChain(const Mesh& InMesh, const MeshLODSettings& Settings = {})
+        {
+            return BuildLODChain(InMesh.Indices, InMesh.Positions, Settings);
+        }
+    };
+}
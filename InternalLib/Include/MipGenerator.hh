@@ -0,0 +1,76 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace SilverBell::Assets
+{
+    enum class EMipFilter : uint8_t
+    {
+        // 每个目标像素取其覆盖的源像素按面积加权平均，奇数尺寸时覆盖3个源像素
+        Box,
+        // Kaiser窗的sinc，半径3个目标像素，比Box更锐利，远处纹理不易发糊
+        Kaiser,
+    };
+
+    struct MipGenerateOptions
+    {
+        EMipFilter Filter = EMipFilter::Box;
+        // RGB为sRGB编码时先转换到线性空间再平均，Alpha始终按线性处理
+        bool bSRGB = true;
+    };
+
+    struct MipLevel
+    {
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        // 在MipChain::Pixels中的字节偏移与大小
+        std::size_t Offset = 0;
+        std::size_t Size = 0;
+    };
+
+    // RGBA8的mip链，各级从第0级开始紧密排列，可以整体写入暂存缓冲后逐级复制到图像，块压缩后的mip链中Pixels为块数据
+    struct MipChain
+    {
+        std::vector<MipLevel> Levels;
+        std::vector<unsigned char> Pixels;
+
+        std::span<unsigned char> GetLevelData(std::size_t Level)
+        {
+            return { Pixels.data() + Levels[Level].Offset, Levels[Level].Size };
+        }
+
+        std::span<const unsigned char> GetLevelData(std::size_t Level) const
+        {
+            return { Pixels.data() + Levels[Level].Offset, Levels[Level].Size };
+        }
+    };
+
+    /*
+     * CPU上的mip链生成，离线导入或加载线程上使用
+     * 滤波按轴分离，先横向再纵向，每个像素的4个通道放在一个SSE寄存器中累加，
+     * 每一级按目标行分块交给线程池并行，下一级从上一级的8位结果生成
+     * 边缘按钳制寻址处理
+     */
+    class INTERNALLIB_API FMipGenerator
+    {
+    public:
+        FMipGenerator() = delete;
+        ~FMipGenerator() = delete;
+
+        // 完整mip链的级数，每级尺寸减半直到1x1
+        static uint32_t GetMipLevelCount(uint32_t Width, uint32_t Height);
+
+        // 分配并布局mip链，LevelCount为0时为完整mip链，像素内容未填充
+        static MipChain AllocateChain(uint32_t Width, uint32_t Height, uint32_t LevelCount = 0);
+
+        // 由已填充的第0级生成其余各级
+        static void GenerateLevels(MipChain& Chain, const MipGenerateOptions& Options = {});
+
+        static MipChain Generate(const unsigned char* Pixels, uint32_t Width, uint32_t Height, const MipGenerateOptions& Options = {});
+    };
+}
@@ -2,16 +2,61 @@
 
 #include "InternalLibMarco.hh"
 
+#include "MappedFile.hh"
 #include "Mesh.hh"
+#include "MeshProcessing.hh"
+#include "MeshSimplifier.hh"
+#include "VertexQuantization.hh"
 
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
 #include <string_view>
+#include <vector>
 
 namespace SilverBell
 {
     struct Model
     {
+        // 导入过程中的全精度顶点，量化为RenderData后被清空
         Assets::BaseMesh MeshData;
+        // 上传到GPU的量化顶点
+        Assets::QuantizedMesh RenderData;
+        Assets::QuantizationParams Quantization;
         Assets::MeshIndices MeshIndices;
+        // 供计算着色器做逐簇剔除
+        Assets::MeshletBuffers Meshlets;
+        // 各层级的索引已拼接存入MeshIndices，这里只保留层级划分与误差
+        Assets::MeshLODChain LODChain;
+        // 顶点流的数量与顺序与QuantizedMesh的成员一致，即渲染器GetBindingDescriptions的绑定顺序
+        static constexpr std::size_t VertexStreamCount = ylt::reflection::members_count_v<Assets::QuantizedMesh>;
+
+        // 从二进制网格缓存加载时，顶点流与索引直接引用映射的文件，RenderData与MeshIndices保持为空
+        std::shared_ptr<Utility::FMappedFile> MappedFile;
+        std::array<std::span<const std::byte>, VertexStreamCount> MappedVertexStreams;
+        std::span<const std::byte> MappedIndices;
+        bool bMappedIndices16 = false;
+
+        std::span<const std::byte> GetVertexStream(std::size_t Stream) const
+        {
+            if (MappedFile) return MappedVertexStreams[Stream];
+
+            std::span<const std::byte> Result;
+            ylt::reflection::for_each(RenderData, [&Result, Stream](auto& Field, auto Name, auto Index)
+            {
+                if (static_cast<std::size_t>(Index) == Stream) Result = std::as_bytes(std::span(Field));
+            });
+            return Result;
+        }
+
+        std::span<const std::byte> GetIndexData() const
+        {
+            if (MappedFile) return MappedIndices;
+            return { static_cast<const std::byte*>(MeshIndices.GetData()), MeshIndices.GetDataSize() };
+        }
+
+        bool Is16BitIndex() const { return MappedFile ? bMappedIndices16 : MeshIndices.Is16Bit(); }
     };
 
     class INTERNALLIB_API FModelImporter
@@ -20,7 +65,8 @@ namespace SilverBell
         FModelImporter() = delete;
         ~FModelImporter() = delete;
 
-        static Model* ImporterModel(std::string_view FilePath);
+        // 导入失败时返回空指针
+        static std::unique_ptr<Model> ImporterModel(std::string_view FilePath, const Assets::MeshLODSettings& LODSettings = {});
 
     };
 
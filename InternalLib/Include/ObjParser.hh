@@ -0,0 +1,49 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+
+#include "Math.hh"
+
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace SilverBell
+{
+    // OBJ面的一个角点，分别为位置/纹理坐标/法线的下标，从0开始，缺省的分量为-1
+    struct ObjCorner
+    {
+        int32_t Position = -1;
+        int32_t Texcoord = -1;
+        int32_t Normal = -1;
+
+        bool operator==(const ObjCorner&) const = default;
+    };
+
+    struct ObjData
+    {
+        std::vector<Math::Vec3> Positions;
+        std::vector<Math::Vec2> Texcoords;
+        std::vector<Math::Vec3> Normals;
+        // 多边形面以扇形三角化，每3个为一组
+        std::vector<ObjCorner> Corners;
+    };
+
+    /*
+     * OBJ解析器
+     * 文件通过内存映射读取，按行对齐切分为若干块后在线程池上并行解析，最后按块的顺序合并，
+     * 只解析几何数据(v/vt/vn/f)，材质与分组信息被忽略
+     */
+    class INTERNALLIB_API FObjParser
+    {
+    public:
+        FObjParser() = delete;
+        ~FObjParser() = delete;
+
+        // 文件无法打开或内容有误时返回空
+        static std::optional<ObjData> Parse(const std::filesystem::path& FilePath);
+
+        static std::optional<ObjData> ParseText(std::string_view Text);
+    };
+}
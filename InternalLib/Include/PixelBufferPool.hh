@@ -0,0 +1,64 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+#include "Mixins.hh"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace SilverBell::Utility
+{
+    /*
+     * 图像解码用的缓冲池
+     * 按2的幂分级缓存释放的块，批量解码同尺寸的纹理时解码器的临时缓冲与输出缓冲都能直接复用，
+     * 小于最小级别或大于最大级别的块直接使用malloc，缓存的总字节数超过上限时多出的块直接释放
+     * 块的级别与大小记录在以地址为键的表中而不是块头里，2的幂大小的图像恰好占满一个级别，
+     * Free与Reallocate不需要传入大小，可以直接作为stb_image的分配函数
+     */
+    class INTERNALLIB_API FPixelBufferPool : public NonCopyable
+    {
+    public:
+        static FPixelBufferPool& Instance();
+
+        explicit FPixelBufferPool(std::size_t InMaxRetainedBytes = std::size_t{ 256 } << 20);
+        ~FPixelBufferPool();
+
+        // 返回16字节对齐的内存，失败时返回空指针
+        void* Allocate(std::size_t Size);
+
+        // 与realloc语义一致，新大小仍在原级别内时原地返回
+        void* Reallocate(void* Block, std::size_t Size);
+
+        void Free(void* Block);
+
+        // 释放所有缓存的块
+        void Trim();
+
+        std::size_t GetRetainedBytes() const;
+
+    private:
+        static constexpr std::size_t MinClassShift = 12;    // 4KB
+        static constexpr std::size_t MaxClassShift = 28;    // 256MB
+        static constexpr std::size_t ClassCount = MaxClassShift - MinClassShift + 1;
+        // 不属于任何级别，直接由malloc分配的块
+        static constexpr std::uint32_t DirectClass = 0xFFFFFFFFu;
+
+        struct BlockInfo
+        {
+            std::uint32_t SizeClass;
+            // 池中的块为级别的容量，直接分配的块为请求的大小，供Reallocate拷贝
+            std::size_t Size;
+        };
+
+        mutable std::mutex Mutex;
+        std::array<std::vector<void*>, ClassCount> FreeBlocks;
+        // 已分配出去的块
+        std::unordered_map<void*, BlockInfo> LiveBlocks;
+        std::size_t RetainedBytes = 0;
+        std::size_t MaxRetainedBytes;
+    };
+}
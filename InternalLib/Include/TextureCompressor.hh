@@ -0,0 +1,64 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+
+#include "MipGenerator.hh"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace SilverBell::Assets
+{
+    // 烘焙纹理的存储格式，BC格式以4x4像素为一块
+    enum class ETextureFormat : uint8_t
+    {
+        // 未压缩，设备不支持块压缩时使用
+        RGBA8,
+        // 每块8字节，只有RGB，用于不透明的颜色纹理
+        BC1,
+        // 每块16字节，BC4编码的Alpha + BC1编码的RGB
+        BC3,
+        // 每块16字节，R与G各一个BC4块，用于切线空间法线
+        BC5,
+        // 每块16字节，RGBA，质量最好
+        BC7,
+    };
+
+    enum class ECompressionQuality : uint8_t
+    {
+        // 只取主轴两端作为端点
+        Fast,
+        // 再按选出的索引做两轮最小二乘求端点
+        Normal,
+        // 更多轮最小二乘，并从包围盒对角线再搜索一次
+        High,
+    };
+
+    /*
+     * CPU上的块压缩编码器，导入时使用，结果由FTextureCooker缓存
+     * 端点取块内颜色的主轴两端，量化后选择索引，再固定索引用最小二乘重新求端点，保留误差最小的结果，
+     * 索引选择时4个像素放在一个SSE寄存器中与调色板逐项比较，块按行分给线程池并行
+     * BC7只使用模式6(单子集、RGBA端点带P位、4位索引)
+     */
+    class INTERNALLIB_API FTextureCompressor
+    {
+    public:
+        FTextureCompressor() = delete;
+        ~FTextureCompressor() = delete;
+
+        static bool IsBlockCompressed(ETextureFormat Format) { return Format != ETextureFormat::RGBA8; }
+
+        // 每块的字节数，RGBA8为每像素的字节数
+        static uint32_t GetBlockBytes(ETextureFormat Format);
+
+        static std::size_t GetLevelSize(ETextureFormat Format, uint32_t Width, uint32_t Height);
+
+        // 压缩一级RGBA8像素，不足4的倍数的边缘块重复边缘像素，Output的大小需为GetLevelSize
+        static void CompressLevel(std::span<const unsigned char> Pixels, uint32_t Width, uint32_t Height,
+                                  ETextureFormat Format, ECompressionQuality Quality, std::span<unsigned char> Output);
+
+        // 逐级压缩RGBA8的mip链，返回的链中各级的偏移与大小为压缩后的数据，RGBA8时原样复制
+        static MipChain Compress(const MipChain& Mips, ETextureFormat Format, ECompressionQuality Quality);
+    };
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+
+#include "AssetSerializer.hh"
+#include "MipGenerator.hh"
+#include "TextureCompressor.hh"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace SilverBell::Assets
+{
+    struct TextureCookSettings
+    {
+        ETextureFormat Format = ETextureFormat::BC7;
+        ECompressionQuality Quality = ECompressionQuality::Normal;
+        // 为false时只保留第0级，其余级别上传后在GPU上生成，只适用于RGBA8
+        bool bGenerateMips = true;
+        MipGenerateOptions MipOptions;
+    };
+
+    // 烘焙后的纹理，各级mip的数据按Format紧密排列在Data中
+    struct CookedTexture
+    {
+        static constexpr std::uint32_t AssetVersion = 1;
+
+        // 与当前源文件和烘焙参数的键不一致时重新烘焙
+        std::uint64_t SourceKey = 0;
+        ETextureFormat Format = ETextureFormat::RGBA8;
+        std::vector<MipLevel> Levels;
+        std::vector<unsigned char> Data;
+    };
+    YLT_REFL(CookedTexture, SourceKey, Format, Levels, Data);
+
+    /*
+     * 导入时的纹理烘焙：解码、生成mip链、块压缩
+     * 结果由FAssetSerializer写入Intermediate/TextureCache，源文件与烘焙参数都没有变化时直接读取
+     */
+    class INTERNALLIB_API FTextureCooker
+    {
+    public:
+        FTextureCooker() = delete;
+        ~FTextureCooker() = delete;
+
+        // 编码器或mip生成的结果变化时需要递增
+        static constexpr std::uint32_t CookVersion = 1;
+
+        // 缓存文件路径，由源文件路径的哈希命名
+        static std::filesystem::path GetCachePath(const std::filesystem::path& SourcePath);
+
+        // 由源文件的修改时间、大小与烘焙参数组合成的键，源文件不存在时返回空
+        static std::optional<std::uint64_t> ComputeSourceKey(const std::filesystem::path& SourcePath, const TextureCookSettings& Settings);
+
+        // FilePath相对于项目根目录，解码失败时返回空
+        static std::optional<CookedTexture> Cook(std::string_view FilePath, const TextureCookSettings& Settings);
+    };
+}
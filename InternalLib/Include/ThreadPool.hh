@@ -0,0 +1,108 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+#include "Mixins.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace SilverBell::Utility
+{
+    /*
+     * 通用线程池
+     * 工作线程数量默认为硬件线程数减一，给主线程留出一个核心
+     */
+    class INTERNALLIB_API FThreadPool : public NonCopyable
+    {
+    public:
+        static FThreadPool& Instance();
+
+        explicit FThreadPool(std::uint32_t ThreadCount);
+        ~FThreadPool();
+
+        // 提交一个任务，返回对应的future，任务抛出的异常会在future.get()时重新抛出
+        template<typename Func, typename... Args>
+        auto Enqueue(Func&& Task, Args&&... Arguments) -> std::future<std::invoke_result_t<std::decay_t<Func>, std::decay_t<Args>...>>
+        {
+            using ReturnType = std::invoke_result_t<std::decay_t<Func>, std::decay_t<Args>...>;
+
+            auto PackagedTask = std::make_shared<std::packaged_task<ReturnType()>>(
+                [Task = std::forward<Func>(Task), ...Arguments = std::forward<Args>(Arguments)]() mutable
+                {
+                    return std::invoke(std::move(Task), std::move(Arguments)...);
+                });
+            auto Future = PackagedTask->get_future();
+            Push([PackagedTask]() { (*PackagedTask)(); });
+            return Future;
+        }
+
+        // 将[0, Count)切分给工作线程执行，调用线程也参与计算，所有任务完成后返回
+        // 注：在工作线程内部嵌套调用时直接串行执行，避免所有工作线程互相等待造成死锁
+        template<typename Func>
+        void ParallelFor(std::size_t Count, Func&& Body)
+        {
+            if (Count == 0) return;
+            if (Count == 1 || Workers.empty() || IsWorkerThread())
+            {
+                for (std::size_t Idx = 0; Idx < Count; ++Idx) Body(Idx);
+                return;
+            }
+
+            std::atomic<std::size_t> NextIndex = 0;
+            auto Worker = [&NextIndex, &Body, Count]()
+            {
+                for (std::size_t Idx = NextIndex.fetch_add(1); Idx < Count; Idx = NextIndex.fetch_add(1))
+                {
+                    Body(Idx);
+                }
+            };
+
+            const std::size_t HelperCount = std::min<std::size_t>(Workers.size(), Count - 1);
+            std::vector<std::future<void>> Helpers;
+            Helpers.reserve(HelperCount);
+            for (std::size_t Idx = 0; Idx < HelperCount; ++Idx)
+            {
+                Helpers.push_back(Enqueue(Worker));
+            }
+            try
+            {
+                Worker();
+            }
+            catch (...)
+            {
+                // 辅助任务引用了当前栈上的变量，必须等它们结束后才能抛出
+                NextIndex = Count;
+                for (auto& Helper : Helpers) Helper.wait();
+                throw;
+            }
+            for (auto& Helper : Helpers) Helper.wait();
+            for (auto& Helper : Helpers) Helper.get();
+        }
+
+        std::uint32_t GetThreadCount() const { return static_cast<std::uint32_t>(Workers.size()); }
+
+        // 当前线程是否是线程池的工作线程
+        static bool IsWorkerThread();
+
+    private:
+        void Push(std::function<void()> Task);
+
+        void WorkerLoop();
+
+        std::vector<std::thread> Workers;
+        std::deque<std::function<void()>> Tasks;
+        std::mutex Mutex;
+        std::condition_variable Condition;
+        bool bStopping = false;
+    };
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "InternalLibMarco.hh"
+
+#include "Math.hh"
+#include "Mesh.hh"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace SilverBell::Assets
+{
+    /*
+     * 顶点属性量化
+     * 位置相对包围盒逐轴量化为16位SNORM，法线使用八面体映射编码为两个16位SNORM，纹理坐标转为半精度，颜色转为RGBA8，
+     * 采样时由硬件完成归一化，着色器中只需对位置做一次乘加、对法线做八面体解码，见Shaders/Common/VertexDecode.hlsli
+     */
+    class INTERNALLIB_API FVertexQuantization
+    {
+    public:
+        FVertexQuantization() = delete;
+        ~FVertexQuantization() = delete;
+
+        // 由位置的包围盒计算反量化参数，xyz为半长与中心，w使解码结果的w分量恒为1
+        static QuantizationParams ComputePositionParams(std::span<const Math::Vec3> Positions);
+
+        static QuantizedPosition EncodePosition(const Math::Vec3& Position, const QuantizationParams& Params);
+
+        static Math::Vec3 DecodePosition(const QuantizedPosition& Position, const QuantizationParams& Params);
+
+        // 输入需为单位向量
+        static OctahedralNormal EncodeNormal(const Math::Vec3& Normal);
+
+        static Math::Vec3 DecodeNormal(const OctahedralNormal& Normal);
+
+        static std::vector<OctahedralNormal> EncodeNormals(std::span<const Math::Vec3> Normals);
+
+        // 就近舍入，超出半精度范围的值变为无穷大
+        static uint16_t FloatToHalf(float Value);
+
+        static float HalfToFloat(uint16_t Value);
+
+        static ColorRGBA8 EncodeColor(const Math::Vec3& Color);
+
+        // 量化整个网格，同时输出位置的反量化参数，Normals为与顶点一一对应的单位法线
+        static QuantizedMesh Quantize(const BaseMesh& Mesh, std::span<const Math::Vec3> Normals, QuantizationParams& OutParams);
+    };
+}
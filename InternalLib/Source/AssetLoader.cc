@@ -0,0 +1,138 @@
+#include "AssetLoader.hh"
+
+#include "Logger.hh"
+
+#include <algorithm>
+
+using namespace SilverBell::Utility;
+
+FAssetLoader::FAssetLoader(std::uint32_t ThreadCount)
+{
+    Workers.reserve(ThreadCount);
+    for (std::uint32_t Idx = 0; Idx < std::max(ThreadCount, 1u); ++Idx)
+    {
+        Workers.emplace_back(&FAssetLoader::WorkerLoop, this);
+    }
+}
+
+FAssetLoader::~FAssetLoader()
+{
+    {
+        std::scoped_lock Lock(Mutex);
+        bStopping = true;
+    }
+    Condition.notify_all();
+    for (auto& Worker : Workers)
+    {
+        Worker.join();
+    }
+    // 未执行的完成回调随之丢弃，加载结果由其析构函数释放
+}
+
+bool FAssetLoader::UpdatePriority(RequestId Id, float Priority)
+{
+    {
+        std::scoped_lock Lock(Mutex);
+        auto Iter = PendingRequests.find(Id);
+        if (Iter == PendingRequests.end()) return false;
+        // 每帧都会调用，优先级不变时不向队列添加条目
+        if (Iter->second.Priority == Priority) return true;
+        Iter->second.Priority = Priority;
+        Queue.push({ Priority, Id, ++Iter->second.Version });
+    }
+    Condition.notify_one();
+    return true;
+}
+
+bool FAssetLoader::Cancel(RequestId Id)
+{
+    std::scoped_lock Lock(Mutex);
+    auto Iter = PendingRequests.find(Id);
+    if (Iter == PendingRequests.end()) return false;
+    // 与加载完成一样在调用方的线程上通知，队列中的条目在出队时发现请求已不存在后跳过
+    Completions.push_back(std::move(Iter->second.OnCancelled));
+    PendingRequests.erase(Iter);
+    return true;
+}
+
+std::size_t FAssetLoader::PumpCompletions(std::size_t MaxCount)
+{
+    std::size_t Count = 0;
+    while (Count < MaxCount)
+    {
+        CompletionFunc Completion;
+        {
+            std::scoped_lock Lock(Mutex);
+            if (Completions.empty()) break;
+            Completion = std::move(Completions.front());
+            Completions.pop_front();
+        }
+        // 回调中可能继续提交请求，不能持有锁
+        Completion();
+        ++Count;
+    }
+    return Count;
+}
+
+std::size_t FAssetLoader::GetOutstandingCount() const
+{
+    std::scoped_lock Lock(Mutex);
+    return PendingRequests.size() + LoadingCount + Completions.size();
+}
+
+FAssetLoader::RequestId FAssetLoader::Push(float Priority, LoadJob Job, CompletionFunc OnCancelled)
+{
+    RequestId Id;
+    {
+        std::scoped_lock Lock(Mutex);
+        Id = NextRequestId++;
+        PendingRequests.emplace(Id, PendingRequest{ .Job = std::move(Job), .OnCancelled = std::move(OnCancelled), .Priority = Priority });
+        Queue.push({ Priority, Id, 0 });
+    }
+    Condition.notify_one();
+    return Id;
+}
+
+void FAssetLoader::WorkerLoop()
+{
+    while (true)
+    {
+        LoadJob Job;
+        {
+            std::unique_lock Lock(Mutex);
+            while (true)
+            {
+                Condition.wait(Lock, [this]() { return bStopping || !Queue.empty(); });
+                if (bStopping) return;
+
+                const QueueEntry Entry = Queue.top();
+                Queue.pop();
+                auto Iter = PendingRequests.find(Entry.Id);
+                // 已取消或优先级已被调整过的过期条目
+                if (Iter == PendingRequests.end() || Iter->second.Version != Entry.Version) continue;
+
+                Job = std::move(Iter->second.Job);
+                PendingRequests.erase(Iter);
+                ++LoadingCount;
+                break;
+            }
+        }
+
+        CompletionFunc Completion;
+        try
+        {
+            Completion = Job();
+        }
+        catch (const std::exception& Exception)
+        {
+            LOG_WARN("资产加载失败: {}", Exception.what());
+        }
+
+        std::scoped_lock Lock(Mutex);
+        --LoadingCount;
+        if (Completion)
+        {
+            Completions.push_back(std::move(Completion));
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include "AssetSerializer.hh"
+
+#include "MappedFile.hh"
+
+#include <fstream>
+
+using namespace SilverBell::Assets;
+
+std::optional<AssetFileHeader> FAssetSerializer::ReadHeader(std::span<const std::byte> Data, std::uint32_t MaxAssetVersion)
+{
+    AssetFileHeader Header = {};
+    if (Data.size() < sizeof(Header))
+    {
+        LOG_WARN("资产文件不完整");
+        return std::nullopt;
+    }
+    std::memcpy(&Header, Data.data(), sizeof(Header));
+    if (Header.Magic != Magic || Header.FormatVersion != FormatVersion)
+    {
+        LOG_WARN("资产文件格式不匹配，版本: {}", Header.FormatVersion);
+        return std::nullopt;
+    }
+    if (Header.AssetVersion > MaxAssetVersion)
+    {
+        LOG_WARN("资产版本 {} 高于当前支持的版本 {}", Header.AssetVersion, MaxAssetVersion);
+        return std::nullopt;
+    }
+    if (Header.PayloadSize != Data.size() - sizeof(Header))
+    {
+        LOG_WARN("资产文件大小不匹配");
+        return std::nullopt;
+    }
+    return Header;
+}
+
+bool FAssetSerializer::WriteFile(const std::filesystem::path& FilePath, std::span<const std::byte> Data)
+{
+    std::error_code ErrorCode;
+    if (FilePath.has_parent_path())
+    {
+        std::filesystem::create_directories(FilePath.parent_path(), ErrorCode);
+    }
+
+    auto TempFilePath = FilePath;
+    TempFilePath += ".tmp";
+    {
+        std::ofstream File(TempFilePath, std::ios::binary | std::ios::trunc);
+        if (!File.is_open() || !File.write(reinterpret_cast<const char*>(Data.data()), static_cast<std::streamsize>(Data.size())))
+        {
+            LOG_WARN("写入资产文件失败: {}", TempFilePath.string());
+            return false;
+        }
+    }
+    std::filesystem::rename(TempFilePath, FilePath, ErrorCode);
+    if (ErrorCode)
+    {
+        LOG_WARN("写入资产文件失败: {}, {}", FilePath.string(), ErrorCode.message());
+        std::filesystem::remove(TempFilePath, ErrorCode);
+        return false;
+    }
+    return true;
+}
+
+void FAssetSerializer::ReadFile(const std::filesystem::path& FilePath, const std::function<void(std::span<const std::byte>)>& Callback)
+{
+    std::error_code ErrorCode;
+    if (!std::filesystem::exists(FilePath, ErrorCode)) return;
+
+    try
+    {
+        const Utility::FMappedFile File(FilePath);
+        Callback(std::as_bytes(File.GetData()));
+    }
+    catch (const std::exception& Exception)
+    {
+        LOG_WARN("读取资产文件失败: {}, {}", FilePath.string(), Exception.what());
+    }
+}
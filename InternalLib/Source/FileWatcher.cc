@@ -0,0 +1,151 @@
+#include "FileWatcher.hh"
+
+#include "Logger.hh"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace SilverBell::Utility;
+
+FFileWatcher::FFileWatcher(ChangeCallback iOnChanged, std::chrono::milliseconds iDebounceTime)
+    : OnChanged(std::move(iOnChanged)), DebounceTime(iDebounceTime)
+{
+#ifdef __linux__
+    InotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (InotifyFd < 0)
+    {
+        LOG_ERROR("inotify初始化失败，errno: {}", errno);
+        throw std::runtime_error("Failed to initialize inotify!");
+    }
+#endif
+    WatchThread = std::thread(&FFileWatcher::Run, this);
+}
+
+FFileWatcher::~FFileWatcher()
+{
+    bStopping = true;
+    if (WatchThread.joinable())
+    {
+        WatchThread.join();
+    }
+#ifdef __linux__
+    close(InotifyFd);
+#endif
+}
+
+void FFileWatcher::Watch(const std::filesystem::path& FilePath)
+{
+    std::error_code ErrorCode;
+    auto AbsolutePath = std::filesystem::absolute(FilePath, ErrorCode).lexically_normal();
+    if (ErrorCode)
+    {
+        LOG_WARN("无法监视文件: {}, {}", FilePath.string(), ErrorCode.message());
+        return;
+    }
+
+    std::scoped_lock Lock(Mutex);
+    if (WatchedFiles.contains(AbsolutePath)) return;
+    WatchedFiles[AbsolutePath] = std::filesystem::last_write_time(AbsolutePath, ErrorCode);
+
+#ifdef __linux__
+    const auto Directory = AbsolutePath.parent_path();
+    const bool bDirectoryWatched = std::ranges::any_of(WatchedDirectories, [&Directory](const auto& Pair)
+    {
+        return Pair.second == Directory;
+    });
+    if (!bDirectoryWatched)
+    {
+        const int WatchDescriptor = inotify_add_watch(InotifyFd, Directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (WatchDescriptor < 0)
+        {
+            LOG_WARN("无法监视目录: {}, errno: {}", Directory.string(), errno);
+            return;
+        }
+        WatchedDirectories[WatchDescriptor] = Directory;
+    }
+#endif
+}
+
+void FFileWatcher::Run()
+{
+    constexpr auto IdleTimeout = std::chrono::milliseconds(200);
+    while (!bStopping)
+    {
+        auto ChangedFiles = WaitForChanges(IdleTimeout);
+        if (ChangedFiles.empty()) continue;
+
+        // 保存一个文件时往往会连续触发多次事件，等到一段时间内不再有变化再统一回调
+        while (!bStopping)
+        {
+            auto MoreFiles = WaitForChanges(DebounceTime);
+            if (MoreFiles.empty()) break;
+            ChangedFiles.insert(ChangedFiles.end(), MoreFiles.begin(), MoreFiles.end());
+        }
+
+        std::ranges::sort(ChangedFiles);
+        const auto [First, Last] = std::ranges::unique(ChangedFiles);
+        ChangedFiles.erase(First, Last);
+
+        try
+        {
+            OnChanged(ChangedFiles);
+        }
+        catch (const std::exception& E)
+        {
+            LOG_ERROR("文件变化回调异常: {}", E.what());
+        }
+    }
+}
+
+std::vector<std::filesystem::path> FFileWatcher::WaitForChanges(std::chrono::milliseconds Timeout)
+{
+    std::vector<std::filesystem::path> ChangedFiles;
+
+#ifdef __linux__
+    pollfd PollFd = { .fd = InotifyFd, .events = POLLIN, .revents = 0 };
+    if (poll(&PollFd, 1, static_cast<int>(Timeout.count())) <= 0) return ChangedFiles;
+
+    alignas(inotify_event) char Buffer[4096];
+    while (true)
+    {
+        const ssize_t Length = read(InotifyFd, Buffer, sizeof(Buffer));
+        if (Length <= 0) break;
+
+        std::scoped_lock Lock(Mutex);
+        for (ssize_t Offset = 0; Offset < Length;)
+        {
+            const auto* Event = reinterpret_cast<const inotify_event*>(Buffer + Offset);
+            Offset += static_cast<ssize_t>(sizeof(inotify_event) + Event->len);
+
+            auto DirectoryIter = WatchedDirectories.find(Event->wd);
+            if (Event->len == 0 || DirectoryIter == WatchedDirectories.end()) continue;
+
+            auto FilePath = DirectoryIter->second / Event->name;
+            if (WatchedFiles.contains(FilePath))
+            {
+                ChangedFiles.push_back(std::move(FilePath));
+            }
+        }
+    }
+#else
+    std::this_thread::sleep_for(Timeout);
+
+    std::scoped_lock Lock(Mutex);
+    for (auto& [FilePath, LastWriteTime] : WatchedFiles)
+    {
+        std::error_code ErrorCode;
+        const auto WriteTime = std::filesystem::last_write_time(FilePath, ErrorCode);
+        // 文件被删除或正在被替换时跳过，等它重新出现时再比较
+        if (ErrorCode || WriteTime == LastWriteTime) continue;
+        LastWriteTime = WriteTime;
+        ChangedFiles.push_back(FilePath);
+    }
+#endif
+
+    return ChangedFiles;
+}
@@ -1,36 +1,130 @@
 #include "ImageImporter.hh"
 
 #include "Logger.hh"
+#include "MappedFile.hh"
+#include "PixelBufferPool.hh"
+#include "ThreadPool.hh"
 
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+// 解码器的临时缓冲与输出缓冲都从缓冲池分配，批量解码时反复复用
+#define STBI_MALLOC(Size) SilverBell::Utility::FPixelBufferPool::Instance().Allocate(Size)
+#define STBI_REALLOC(Block, Size) SilverBell::Utility::FPixelBufferPool::Instance().Reallocate(Block, Size)
+#define STBI_FREE(Block) SilverBell::Utility::FPixelBufferPool::Instance().Free(Block)
 #define STB_IMAGE_IMPLEMENTATION
 #include<stb/stb_image.h>
 
 using namespace SilverBell;
 
+namespace
+{
+    std::filesystem::path GetFullPath(std::string_view FilePath)
+    {
+        return std::string(PROJECT_ROOT_PATH) + std::string(FilePath);
+    }
+
+    // 映射整个文件后从内存解码，省去stb分块读文件的开销
+    std::optional<FImageImporter::ImageInfo> DecodeImage(std::string_view FilePath, std::span<std::byte> Destination)
+    {
+        const auto FullPath = GetFullPath(FilePath);
+        std::optional<Utility::FMappedFile> File;
+        try
+        {
+            File.emplace(FullPath);
+        }
+        catch (const std::exception&)
+        {
+            LOG_WARN("加载图片失败： {}", FullPath.string());
+            return std::nullopt;
+        }
+
+        const auto FileData = File->GetData();
+        if (FileData.size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+        {
+            LOG_WARN("图片文件过大： {}", FullPath.string());
+            return std::nullopt;
+        }
+
+        int tWidth, tHeight, tChannels;
+        unsigned char* Data = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(FileData.data()), static_cast<int>(FileData.size()),
+            &tWidth, &tHeight, &tChannels, STBI_rgb_alpha);
+        if (!Data)
+        {
+            LOG_WARN("加载图片失败： {}", FullPath.string());
+            LOG_WARN("失败原因：{}", stbi_failure_reason());
+            return std::nullopt;
+        }
+
+        FImageImporter::ImageInfo Info;
+        Info.Pixels = Data;
+        Info.Width = static_cast<uint32_t>(tWidth);
+        Info.Height = static_cast<uint32_t>(tHeight);
+        Info.Channels = 4; // 强制转换为4通道
+        if (Destination.empty()) return Info;
+
+        // stb总是解码到自己分配的缓冲中，从缓冲池取出的缓冲拷贝一次到目标后立即归还
+        const std::size_t DataSize = Info.GetDataSize();
+        if (Destination.size() < DataSize)
+        {
+            LOG_WARN("图片目标内存不足： {}，需要 {} 字节，提供 {} 字节", FullPath.string(), DataSize, Destination.size());
+            stbi_image_free(Data);
+            return std::nullopt;
+        }
+        std::memcpy(Destination.data(), Data, DataSize);
+        stbi_image_free(Data);
+        Info.Pixels = reinterpret_cast<unsigned char*>(Destination.data());
+        Info.bExternalPixels = true;
+        return Info;
+    }
+}
+
 std::optional<FImageImporter::ImageInfo> FImageImporter::ImportImage(std::string_view FilePath)
 {
-    ImageInfo Info;
-    std::string FullPath = std::string(PROJECT_ROOT_PATH) + std::string(FilePath);
-    int tWidth, tHeight, tChannels;
-    unsigned char* Data = stbi_load(FullPath.data(), &tWidth, &tHeight, &tChannels, STBI_rgb_alpha);
-    if (!Data)
+    return DecodeImage(FilePath, {});
+}
+
+std::vector<std::optional<FImageImporter::ImageInfo>> FImageImporter::QueryImages(std::span<const std::string_view> FilePaths)
+{
+    std::vector<std::optional<ImageInfo>> Result(FilePaths.size());
+    Utility::FThreadPool::Instance().ParallelFor(FilePaths.size(), [&](std::size_t Idx)
     {
-        LOG_WARN("加载图片失败： {}", FullPath);
-        LOG_WARN("失败原因：{}", stbi_failure_reason());
-        return std::nullopt;
+        const auto FullPath = GetFullPath(FilePaths[Idx]);
+        int tWidth, tHeight, tChannels;
+        if (!stbi_info(FullPath.string().c_str(), &tWidth, &tHeight, &tChannels))
+        {
+            LOG_WARN("读取图片信息失败： {}", FullPath.string());
+            return;
+        }
+        Result[Idx] = ImageInfo{ .Width = static_cast<uint32_t>(tWidth), .Height = static_cast<uint32_t>(tHeight), .Channels = 4 };
+    });
+    return Result;
+}
+
+std::vector<std::optional<FImageImporter::ImageInfo>> FImageImporter::ImportImages(std::span<const std::string_view> FilePaths,
+                                                                                  std::span<const std::span<std::byte>> Destinations)
+{
+    if (!Destinations.empty() && Destinations.size() != FilePaths.size())
+    {
+        LOG_ERROR("批量解码的目标数量与图片数量不一致: {} / {}", Destinations.size(), FilePaths.size());
+        throw std::runtime_error("Image destination count mismatch!");
     }
-    Info.Pixels = Data;
-    Info.Width = static_cast<uint32_t>(tWidth);
-    Info.Height = static_cast<uint32_t>(tHeight);
-    Info.Channels = 4; // 强制转换为4通道
-    return Info;
+
+    std::vector<std::optional<ImageInfo>> Result(FilePaths.size());
+    Utility::FThreadPool::Instance().ParallelFor(FilePaths.size(), [&](std::size_t Idx)
+    {
+        Result[Idx] = DecodeImage(FilePaths[Idx], Destinations.empty() ? std::span<std::byte>() : Destinations[Idx]);
+    });
+    return Result;
 }
 
 void FImageImporter::FreeImage(ImageInfo& ImageInfo)
 {
-    if (ImageInfo.Pixels)
+    if (ImageInfo.Pixels && !ImageInfo.bExternalPixels)
     {
         stbi_image_free(ImageInfo.Pixels);
-        ImageInfo.Pixels = nullptr;
     }
+    ImageInfo.Pixels = nullptr;
 }
@@ -0,0 +1,90 @@
+#include "MappedFile.hh"
+
+#include "Logger.hh"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace SilverBell::Utility;
+
+#ifdef _WIN32
+
+FMappedFile::FMappedFile(const std::filesystem::path& FilePath)
+{
+    FileHandle = CreateFileW(FilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (FileHandle == INVALID_HANDLE_VALUE)
+    {
+        FileHandle = nullptr;
+        LOG_ERROR("打开文件失败: {}", FilePath.string());
+        throw std::runtime_error("Failed to open file: " + FilePath.string());
+    }
+
+    LARGE_INTEGER FileSize;
+    GetFileSizeEx(FileHandle, &FileSize);
+    Size = static_cast<std::size_t>(FileSize.QuadPart);
+    // 空文件无法创建映射
+    if (Size == 0) return;
+
+    MappingHandle = CreateFileMappingW(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (MappingHandle != nullptr)
+    {
+        Data = static_cast<const char*>(MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (Data == nullptr)
+    {
+        if (MappingHandle != nullptr) CloseHandle(MappingHandle);
+        CloseHandle(FileHandle);
+        LOG_ERROR("映射文件失败: {}", FilePath.string());
+        throw std::runtime_error("Failed to map file: " + FilePath.string());
+    }
+}
+
+FMappedFile::~FMappedFile()
+{
+    if (Data != nullptr) UnmapViewOfFile(Data);
+    if (MappingHandle != nullptr) CloseHandle(MappingHandle);
+    if (FileHandle != nullptr) CloseHandle(FileHandle);
+}
+
+#else
+
+FMappedFile::FMappedFile(const std::filesystem::path& FilePath)
+{
+    const int FileDescriptor = open(FilePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (FileDescriptor < 0)
+    {
+        LOG_ERROR("打开文件失败: {}", FilePath.string());
+        throw std::runtime_error("Failed to open file: " + FilePath.string());
+    }
+
+    struct stat FileStat = {};
+    fstat(FileDescriptor, &FileStat);
+    Size = static_cast<std::size_t>(FileStat.st_size);
+    if (Size != 0)
+    {
+        void* Mapping = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+        if (Mapping == MAP_FAILED)
+        {
+            close(FileDescriptor);
+            LOG_ERROR("映射文件失败: {}", FilePath.string());
+            throw std::runtime_error("Failed to map file: " + FilePath.string());
+        }
+        Data = static_cast<const char*>(Mapping);
+    }
+    // 映射建立后文件描述符可以直接关闭
+    close(FileDescriptor);
+}
+
+FMappedFile::~FMappedFile()
+{
+    if (Data != nullptr) munmap(const_cast<char*>(Data), Size);
+}
+
+#endif
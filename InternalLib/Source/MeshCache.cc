@@ -0,0 +1,228 @@
+#include "MeshCache.hh"
+
+#include "Hash.hh"
+#include "Logger.hh"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+
+using namespace SilverBell;
+
+namespace
+{
+    constexpr std::size_t SectionAlignment = 16;
+
+    const std::filesystem::path MeshCacheDirectory = PROJECT_ROOT_PATH "Intermediate/MeshCache";
+
+    // 各顶点流每个顶点的字节数
+    std::array<std::size_t, Model::VertexStreamCount> GetVertexStreamStrides()
+    {
+        std::array<std::size_t, Model::VertexStreamCount> Strides = {};
+        const Assets::QuantizedMesh Prototype;
+        ylt::reflection::for_each(Prototype, [&Strides](auto& Field, auto Name, auto Index)
+        {
+            using MemberType = std::remove_cvref_t<decltype(Field)>;
+            Strides[Index] = sizeof(typename MemberType::value_type);
+        });
+        return Strides;
+    }
+
+    std::size_t AlignUp(std::size_t Value)
+    {
+        return (Value + SectionAlignment - 1) & ~(SectionAlignment - 1);
+    }
+}
+
+std::filesystem::path FMeshCache::GetCachePath(const std::filesystem::path& SourcePath)
+{
+    const auto PathHash = Algorithm::HashFunction::Hash64(SourcePath.lexically_normal());
+    return MeshCacheDirectory / std::format("{:016x}.sbmesh", PathHash);
+}
+
+std::optional<std::uint64_t> FMeshCache::ComputeSourceKey(const std::filesystem::path& SourcePath, const Assets::MeshLODSettings& LODSettings)
+{
+    // 对源文件内容求哈希对大文件代价太高，以修改时间和大小判断是否变化
+    std::error_code ErrorCode;
+    const auto WriteTime = std::filesystem::last_write_time(SourcePath, ErrorCode);
+    if (ErrorCode) return std::nullopt;
+    const auto FileSize = std::filesystem::file_size(SourcePath, ErrorCode);
+    if (ErrorCode) return std::nullopt;
+
+    using Algorithm::HashFunction;
+    std::uint64_t Key = HashFunction::HashCombine(static_cast<std::uint64_t>(CacheVersion),
+        static_cast<std::uint64_t>(WriteTime.time_since_epoch().count()));
+    Key = HashFunction::HashCombine(Key, static_cast<std::uint64_t>(FileSize));
+    Key = HashFunction::HashCombine(Key, HashFunction::Hash64(&LODSettings, sizeof(LODSettings)));
+    return Key;
+}
+
+std::unique_ptr<Model> FMeshCache::Load(const std::filesystem::path& CachePath, std::uint64_t SourceKey)
+{
+    std::error_code ErrorCode;
+    if (!std::filesystem::exists(CachePath, ErrorCode)) return nullptr;
+
+    std::shared_ptr<Utility::FMappedFile> File;
+    try
+    {
+        File = std::make_shared<Utility::FMappedFile>(CachePath);
+    }
+    catch (const std::exception&)
+    {
+        return nullptr;
+    }
+
+    const auto Data = File->GetData();
+    MeshCacheHeader Header = {};
+    if (Data.size() < sizeof(Header)) return nullptr;
+    std::memcpy(&Header, Data.data(), sizeof(Header));
+    if (Header.Magic != CacheMagic || Header.Version != CacheVersion || Header.SourceKey != SourceKey)
+    {
+        LOG_DEBUG("网格缓存已过期: {}", CachePath.string());
+        return nullptr;
+    }
+
+    auto Corrupted = [&CachePath]()
+    {
+        LOG_WARN("网格缓存已损坏，将重新导入: {}", CachePath.string());
+        return nullptr;
+    };
+
+    const std::size_t MeshletArrayCount = ylt::reflection::members_count_v<Assets::MeshletBuffers>;
+    const std::size_t ExpectedSectionCount = Model::VertexStreamCount + 2 + MeshletArrayCount;
+    if (Header.SectionCount != ExpectedSectionCount ||
+        (Data.size() - sizeof(Header)) / sizeof(MeshCacheSection) < Header.SectionCount)
+    {
+        return Corrupted();
+    }
+
+    std::vector<MeshCacheSection> Sections(Header.SectionCount);
+    std::memcpy(Sections.data(), Data.data() + sizeof(Header), Sections.size() * sizeof(MeshCacheSection));
+    std::vector<std::span<const std::byte>> SectionData;
+    SectionData.reserve(Sections.size());
+    for (const auto& Section : Sections)
+    {
+        if (Section.Offset % SectionAlignment != 0 || Section.Offset > Data.size() || Data.size() - Section.Offset < Section.Size)
+        {
+            return Corrupted();
+        }
+        SectionData.push_back(std::as_bytes(Data.subspan(Section.Offset, Section.Size)));
+    }
+
+    auto NewModel = std::make_unique<Model>();
+    std::size_t SectionIdx = 0;
+
+    const auto Strides = GetVertexStreamStrides();
+    for (std::size_t Stream = 0; Stream < Model::VertexStreamCount; ++Stream, ++SectionIdx)
+    {
+        if (SectionData[SectionIdx].size() != static_cast<std::size_t>(Header.VertexCount) * Strides[Stream]) return Corrupted();
+        NewModel->MappedVertexStreams[Stream] = SectionData[SectionIdx];
+    }
+
+    if ((Header.IndexStride != 2 && Header.IndexStride != 4) ||
+        SectionData[SectionIdx].size() != static_cast<std::size_t>(Header.IndexCount) * Header.IndexStride)
+    {
+        return Corrupted();
+    }
+    NewModel->MappedIndices = SectionData[SectionIdx++];
+    NewModel->bMappedIndices16 = Header.IndexStride == 2;
+
+    // LOD与meshlet数据量很小，拷贝出来以便直接使用
+    const auto LODData = SectionData[SectionIdx++];
+    if (LODData.size() % sizeof(Assets::MeshLOD) != 0) return Corrupted();
+    auto& LODChain = NewModel->LODChain;
+    LODChain.Levels.resize(LODData.size() / sizeof(Assets::MeshLOD));
+    std::memcpy(LODChain.Levels.data(), LODData.data(), LODData.size());
+    LODChain.BoundingSphere = Math::Vec4(Header.BoundingSphere[0], Header.BoundingSphere[1], Header.BoundingSphere[2], Header.BoundingSphere[3]);
+    NewModel->Quantization.PositionScale = Math::Vec4(Header.PositionScale[0], Header.PositionScale[1], Header.PositionScale[2], Header.PositionScale[3]);
+    NewModel->Quantization.PositionBias = Math::Vec4(Header.PositionBias[0], Header.PositionBias[1], Header.PositionBias[2], Header.PositionBias[3]);
+
+    bool bMeshletValid = true;
+    ylt::reflection::for_each(NewModel->Meshlets, [&](auto& Field, auto Name, auto Index)
+    {
+        using ValueType = typename std::remove_cvref_t<decltype(Field)>::value_type;
+        const auto ArrayData = SectionData[SectionIdx + Index];
+        if (ArrayData.size() % sizeof(ValueType) != 0)
+        {
+            bMeshletValid = false;
+            return;
+        }
+        Field.resize(ArrayData.size() / sizeof(ValueType));
+        std::memcpy(Field.data(), ArrayData.data(), ArrayData.size());
+    });
+    if (!bMeshletValid) return Corrupted();
+
+    NewModel->MappedFile = std::move(File);
+    return NewModel;
+}
+
+void FMeshCache::Store(const std::filesystem::path& CachePath, std::uint64_t SourceKey, const Model& InModel)
+{
+    std::vector<std::span<const std::byte>> SectionData;
+    for (std::size_t Stream = 0; Stream < Model::VertexStreamCount; ++Stream)
+    {
+        SectionData.push_back(InModel.GetVertexStream(Stream));
+    }
+    SectionData.push_back(InModel.GetIndexData());
+    SectionData.push_back(std::as_bytes(std::span(InModel.LODChain.Levels)));
+    ylt::reflection::for_each(InModel.Meshlets, [&SectionData](auto& Field, auto Name, auto Index)
+    {
+        SectionData.push_back(std::as_bytes(std::span(Field)));
+    });
+
+    const std::size_t IndexStride = InModel.Is16BitIndex() ? sizeof(uint16_t) : sizeof(uint32_t);
+    const auto& Sphere = InModel.LODChain.BoundingSphere;
+    const auto& Scale = InModel.Quantization.PositionScale;
+    const auto& Bias = InModel.Quantization.PositionBias;
+    const MeshCacheHeader Header =
+    {
+        .Magic = CacheMagic,
+        .Version = CacheVersion,
+        .SourceKey = SourceKey,
+        .VertexCount = static_cast<std::uint32_t>(SectionData[0].size() / GetVertexStreamStrides()[0]),
+        .IndexCount = static_cast<std::uint32_t>(InModel.GetIndexData().size() / IndexStride),
+        .IndexStride = static_cast<std::uint32_t>(IndexStride),
+        .SectionCount = static_cast<std::uint32_t>(SectionData.size()),
+        .BoundingSphere = { Sphere.x(), Sphere.y(), Sphere.z(), Sphere.w() },
+        .PositionScale = { Scale.x(), Scale.y(), Scale.z(), Scale.w() },
+        .PositionBias = { Bias.x(), Bias.y(), Bias.z(), Bias.w() },
+    };
+
+    std::vector<MeshCacheSection> Sections(SectionData.size());
+    std::size_t Offset = AlignUp(sizeof(Header) + Sections.size() * sizeof(MeshCacheSection));
+    for (std::size_t Idx = 0; Idx < SectionData.size(); ++Idx)
+    {
+        Sections[Idx] = { Offset, SectionData[Idx].size() };
+        Offset = AlignUp(Offset + SectionData[Idx].size());
+    }
+
+    std::vector<char> Buffer(Offset, 0);
+    std::memcpy(Buffer.data(), &Header, sizeof(Header));
+    std::memcpy(Buffer.data() + sizeof(Header), Sections.data(), Sections.size() * sizeof(MeshCacheSection));
+    for (std::size_t Idx = 0; Idx < SectionData.size(); ++Idx)
+    {
+        if (SectionData[Idx].empty()) continue;
+        std::memcpy(Buffer.data() + Sections[Idx].Offset, SectionData[Idx].data(), SectionData[Idx].size());
+    }
+
+    std::error_code ErrorCode;
+    std::filesystem::create_directories(CachePath.parent_path(), ErrorCode);
+
+    // 先写临时文件再重命名，避免其他进程读到写了一半的缓存
+    auto TempFilePath = CachePath;
+    TempFilePath += ".tmp";
+    {
+        std::ofstream File(TempFilePath, std::ios::binary | std::ios::trunc);
+        if (!File.is_open() || !File.write(Buffer.data(), static_cast<std::streamsize>(Buffer.size())))
+        {
+            LOG_WARN("写入网格缓存失败: {}", TempFilePath.string());
+            return;
+        }
+    }
+    std::filesystem::rename(TempFilePath, CachePath, ErrorCode);
+    if (ErrorCode)
+    {
+        LOG_WARN("写入网格缓存失败: {}, {}", CachePath.string(), ErrorCode.message());
+        std::filesystem::remove(TempFilePath, ErrorCode);
+    }
+}
@@ -0,0 +1,357 @@
+#include "MeshGeometry.hh"
+
+#include "Logger.hh"
+#include "ThreadPool.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define MESH_GEOMETRY_SSE 1
+#include <immintrin.h>
+#else
+#define MESH_GEOMETRY_SSE 0
+#endif
+
+using namespace SilverBell;
+using namespace SilverBell::Assets;
+
+namespace
+{
+    // 单个块太小时并行的收益抵不上调度开销
+    constexpr std::size_t MinChunkSize = 1 << 16;
+
+    void CheckTriangleList(std::span<const uint32_t> Indices, std::size_t VertexCount)
+    {
+        if (Indices.size() % 3 != 0)
+        {
+            LOG_ERROR("索引数量不是3的倍数: {}", Indices.size());
+            throw std::runtime_error("Index count must be a multiple of 3");
+        }
+        if (std::ranges::any_of(Indices, [VertexCount](uint32_t Index) { return Index >= VertexCount; }))
+        {
+            LOG_ERROR("索引超出顶点数量: {}", VertexCount);
+            throw std::runtime_error("Index out of range");
+        }
+    }
+
+    std::size_t GetChunkCount(std::size_t Count)
+    {
+        const std::size_t ThreadCount = Utility::FThreadPool::Instance().GetThreadCount();
+        return std::clamp<std::size_t>(Count / MinChunkSize, 1, (ThreadCount + 1) * 4);
+    }
+
+    // 把[0, Count)切分为GetChunkCount(Count)块在线程池上执行，Body(Chunk, Begin, End)
+    template<typename Func>
+    void ParallelChunks(std::size_t Count, Func&& Body)
+    {
+        const std::size_t ChunkCount = GetChunkCount(Count);
+        Utility::FThreadPool::Instance().ParallelFor(ChunkCount, [&](std::size_t Chunk)
+        {
+            Body(Chunk, Count * Chunk / ChunkCount, Count * (Chunk + 1) / ChunkCount);
+        });
+    }
+
+#if MESH_GEOMETRY_SSE
+    // 读取4个连续的Vec3并转置为x/y/z三个向量
+    void LoadTransposed(const float* Data, __m128& X, __m128& Y, __m128& Z)
+    {
+        const __m128 A = _mm_loadu_ps(Data);      // x0 y0 z0 x1
+        const __m128 B = _mm_loadu_ps(Data + 4);  // y1 z1 x2 y2
+        const __m128 C = _mm_loadu_ps(Data + 8);  // z2 x3 y3 z3
+        X = _mm_shuffle_ps(A, _mm_shuffle_ps(B, C, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        Y = _mm_shuffle_ps(_mm_shuffle_ps(A, B, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(B, C, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        Z = _mm_shuffle_ps(_mm_shuffle_ps(A, B, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(C, C, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    }
+
+    float HorizontalMin(__m128 Value)
+    {
+        Value = _mm_min_ps(Value, _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(2, 3, 0, 1)));
+        Value = _mm_min_ps(Value, _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(Value);
+    }
+
+    float HorizontalMax(__m128 Value)
+    {
+        Value = _mm_max_ps(Value, _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(2, 3, 0, 1)));
+        Value = _mm_max_ps(Value, _mm_shuffle_ps(Value, Value, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(Value);
+    }
+#endif
+
+    BoundingBox ComputeBoundingBoxRange(std::span<const Math::Vec3> Positions)
+    {
+        Math::Vec3 Min = Math::Vec3::Constant(std::numeric_limits<float>::max());
+        Math::Vec3 Max = Math::Vec3::Constant(std::numeric_limits<float>::lowest());
+        std::size_t Idx = 0;
+#if MESH_GEOMETRY_SSE
+        __m128 MinX = _mm_set1_ps(Min.x()), MinY = MinX, MinZ = MinX;
+        __m128 MaxX = _mm_set1_ps(Max.x()), MaxY = MaxX, MaxZ = MaxX;
+        const float* Data = Positions.data()->data();
+        for (; Idx + 4 <= Positions.size(); Idx += 4)
+        {
+            __m128 X, Y, Z;
+            LoadTransposed(Data + Idx * 3, X, Y, Z);
+            MinX = _mm_min_ps(MinX, X); MaxX = _mm_max_ps(MaxX, X);
+            MinY = _mm_min_ps(MinY, Y); MaxY = _mm_max_ps(MaxY, Y);
+            MinZ = _mm_min_ps(MinZ, Z); MaxZ = _mm_max_ps(MaxZ, Z);
+        }
+        Min = Math::Vec3(HorizontalMin(MinX), HorizontalMin(MinY), HorizontalMin(MinZ));
+        Max = Math::Vec3(HorizontalMax(MaxX), HorizontalMax(MaxY), HorizontalMax(MaxZ));
+#endif
+        for (; Idx < Positions.size(); ++Idx)
+        {
+            Min = Min.cwiseMin(Positions[Idx]);
+            Max = Max.cwiseMax(Positions[Idx]);
+        }
+        return { Min, Max };
+    }
+
+    float ComputeMaxSquaredDistanceRange(std::span<const Math::Vec3> Positions, const Math::Vec3& Center)
+    {
+        float MaxDistance = 0.0f;
+        std::size_t Idx = 0;
+#if MESH_GEOMETRY_SSE
+        const __m128 CenterX = _mm_set1_ps(Center.x());
+        const __m128 CenterY = _mm_set1_ps(Center.y());
+        const __m128 CenterZ = _mm_set1_ps(Center.z());
+        __m128 MaxDistance4 = _mm_setzero_ps();
+        const float* Data = Positions.data()->data();
+        for (; Idx + 4 <= Positions.size(); Idx += 4)
+        {
+            __m128 X, Y, Z;
+            LoadTransposed(Data + Idx * 3, X, Y, Z);
+            X = _mm_sub_ps(X, CenterX);
+            Y = _mm_sub_ps(Y, CenterY);
+            Z = _mm_sub_ps(Z, CenterZ);
+            const __m128 Distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(X, X), _mm_mul_ps(Y, Y)), _mm_mul_ps(Z, Z));
+            MaxDistance4 = _mm_max_ps(MaxDistance4, Distance);
+        }
+        MaxDistance = HorizontalMax(MaxDistance4);
+#endif
+        for (; Idx < Positions.size(); ++Idx)
+        {
+            MaxDistance = std::max(MaxDistance, (Positions[Idx] - Center).squaredNorm());
+        }
+        return MaxDistance;
+    }
+
+    // 未归一化的面法线，长度为三角形面积的两倍，即面积权重
+    std::vector<Math::Vec3> ComputeFaceNormals(std::span<const uint32_t> Indices, std::span<const Math::Vec3> Positions)
+    {
+        const std::size_t TriangleCount = Indices.size() / 3;
+        std::vector<Math::Vec3> FaceNormals(TriangleCount);
+        ParallelChunks(TriangleCount, [&](std::size_t Chunk, std::size_t Begin, std::size_t End)
+        {
+            std::size_t Triangle = Begin;
+#if MESH_GEOMETRY_SSE
+            for (; Triangle + 4 <= End; Triangle += 4)
+            {
+                // 三角形的顶点不连续，逐个收集为x/y/z向量
+                auto Gather = [&](uint32_t Corner, int Axis)
+                {
+                    const uint32_t* Tri = Indices.data() + Triangle * 3 + Corner;
+                    return _mm_setr_ps(Positions[Tri[0]][Axis], Positions[Tri[3]][Axis], Positions[Tri[6]][Axis], Positions[Tri[9]][Axis]);
+                };
+                const __m128 X0 = Gather(0, 0), Y0 = Gather(0, 1), Z0 = Gather(0, 2);
+                const __m128 E1X = _mm_sub_ps(Gather(1, 0), X0), E1Y = _mm_sub_ps(Gather(1, 1), Y0), E1Z = _mm_sub_ps(Gather(1, 2), Z0);
+                const __m128 E2X = _mm_sub_ps(Gather(2, 0), X0), E2Y = _mm_sub_ps(Gather(2, 1), Y0), E2Z = _mm_sub_ps(Gather(2, 2), Z0);
+
+                alignas(16) float NormalX[4], NormalY[4], NormalZ[4];
+                _mm_store_ps(NormalX, _mm_sub_ps(_mm_mul_ps(E1Y, E2Z), _mm_mul_ps(E1Z, E2Y)));
+                _mm_store_ps(NormalY, _mm_sub_ps(_mm_mul_ps(E1Z, E2X), _mm_mul_ps(E1X, E2Z)));
+                _mm_store_ps(NormalZ, _mm_sub_ps(_mm_mul_ps(E1X, E2Y), _mm_mul_ps(E1Y, E2X)));
+                for (int Lane = 0; Lane < 4; ++Lane)
+                {
+                    FaceNormals[Triangle + Lane] = Math::Vec3(NormalX[Lane], NormalY[Lane], NormalZ[Lane]);
+                }
+            }
+#endif
+            for (; Triangle < End; ++Triangle)
+            {
+                const Math::Vec3& P0 = Positions[Indices[Triangle * 3]];
+                FaceNormals[Triangle] = (Positions[Indices[Triangle * 3 + 1]] - P0).cross(Positions[Indices[Triangle * 3 + 2]] - P0);
+            }
+        });
+        return FaceNormals;
+    }
+
+    // 顶点到角点(索引数组下标)的邻接表，第v个顶点的角点为Corners[Offsets[v], Offsets[v + 1])
+    struct VertexCornerAdjacency
+    {
+        std::vector<uint32_t> Offsets;
+        std::vector<uint32_t> Corners;
+
+        VertexCornerAdjacency(std::span<const uint32_t> Indices, std::size_t VertexCount)
+            : Offsets(VertexCount + 1, 0)
+            , Corners(Indices.size())
+        {
+            for (const uint32_t Index : Indices) ++Offsets[Index + 1];
+            for (std::size_t Vertex = 0; Vertex < VertexCount; ++Vertex) Offsets[Vertex + 1] += Offsets[Vertex];
+            std::vector<uint32_t> Cursor(Offsets.begin(), Offsets.end() - 1);
+            for (uint32_t Corner = 0; Corner < Indices.size(); ++Corner)
+            {
+                Corners[Cursor[Indices[Corner]]++] = Corner;
+            }
+        }
+
+        std::span<const uint32_t> GetCorners(std::size_t Vertex) const
+        {
+            return std::span(Corners).subspan(Offsets[Vertex], Offsets[Vertex + 1] - Offsets[Vertex]);
+        }
+    };
+
+    // 与Normal垂直的任意单位向量
+    Math::Vec3 AnyPerpendicular(const Math::Vec3& Normal)
+    {
+        const Math::Vec3 Axis = std::abs(Normal.x()) < 0.9f ? Math::Vec3::UnitX() : Math::Vec3::UnitY();
+        return Normal.cross(Axis).normalized();
+    }
+}
+
+BoundingBox FMeshGeometry::ComputeBoundingBox(std::span<const Math::Vec3> Positions)
+{
+    if (Positions.empty()) return {};
+
+    std::vector<BoundingBox> Partials(GetChunkCount(Positions.size()));
+    ParallelChunks(Positions.size(), [&](std::size_t Chunk, std::size_t Begin, std::size_t End)
+    {
+        Partials[Chunk] = ComputeBoundingBoxRange(Positions.subspan(Begin, End - Begin));
+    });
+
+    BoundingBox Result = Partials[0];
+    for (const BoundingBox& Partial : Partials)
+    {
+        Result.Min = Result.Min.cwiseMin(Partial.Min);
+        Result.Max = Result.Max.cwiseMax(Partial.Max);
+    }
+    return Result;
+}
+
+Math::Vec4 FMeshGeometry::ComputeBoundingSphere(std::span<const Math::Vec3> Positions)
+{
+    if (Positions.empty()) return Math::Vec4::Zero();
+
+    const Math::Vec3 Center = ComputeBoundingBox(Positions).GetCenter();
+    std::vector<float> Partials(GetChunkCount(Positions.size()), 0.0f);
+    ParallelChunks(Positions.size(), [&](std::size_t Chunk, std::size_t Begin, std::size_t End)
+    {
+        Partials[Chunk] = ComputeMaxSquaredDistanceRange(Positions.subspan(Begin, End - Begin), Center);
+    });
+    const float Radius = std::sqrt(*std::ranges::max_element(Partials));
+    return { Center.x(), Center.y(), Center.z(), Radius };
+}
+
+std::vector<Math::Vec3> FMeshGeometry::ComputeNormals(std::span<const uint32_t> Indices, std::span<const Math::Vec3> Positions)
+{
+    CheckTriangleList(Indices, Positions.size());
+
+    const auto FaceNormals = ComputeFaceNormals(Indices, Positions);
+    const VertexCornerAdjacency Adjacency(Indices, Positions.size());
+
+    std::vector<Math::Vec3> Normals(Positions.size());
+    ParallelChunks(Positions.size(), [&](std::size_t Chunk, std::size_t Begin, std::size_t End)
+    {
+        for (std::size_t Vertex = Begin; Vertex < End; ++Vertex)
+        {
+            Math::Vec3 Sum = Math::Vec3::Zero();
+            for (const uint32_t Corner : Adjacency.GetCorners(Vertex))
+            {
+                Sum += FaceNormals[Corner / 3];
+            }
+            const float Length = Sum.norm();
+            Normals[Vertex] = Length > 0.0f ? Math::Vec3(Sum / Length) : Math::Vec3::UnitZ();
+        }
+    });
+    return Normals;
+}
+
+std::vector<Math::Vec4> FMeshGeometry::ComputeTangents(std::span<const uint32_t> Indices, std::span<const Math::Vec3> Positions,
+    std::span<const Math::Vec3> Normals, std::span<const Math::Vec2> Texcoords)
+{
+    CheckTriangleList(Indices, Positions.size());
+    if (Normals.size() != Positions.size() || Texcoords.size() != Positions.size())
+    {
+        LOG_ERROR("法线或纹理坐标数量与顶点数量不一致: {}, {}, {}", Positions.size(), Normals.size(), Texcoords.size());
+        throw std::runtime_error("Vertex attribute count mismatch");
+    }
+
+    // 逐三角形由纹理坐标的偏导求出切线与副切线，只保留方向
+    const std::size_t TriangleCount = Indices.size() / 3;
+    std::vector<Math::Vec3> FaceTangents(TriangleCount);
+    std::vector<Math::Vec3> FaceBitangents(TriangleCount);
+    ParallelChunks(TriangleCount, [&](std::size_t Chunk, std::size_t Begin, std::size_t End)
+    {
+        for (std::size_t Triangle = Begin; Triangle < End; ++Triangle)
+        {
+            const uint32_t* Tri = Indices.data() + Triangle * 3;
+            const Math::Vec3 Edge1 = Positions[Tri[1]] - Positions[Tri[0]];
+            const Math::Vec3 Edge2 = Positions[Tri[2]] - Positions[Tri[0]];
+            const Math::Vec2 DeltaUV1 = Texcoords[Tri[1]] - Texcoords[Tri[0]];
+            const Math::Vec2 DeltaUV2 = Texcoords[Tri[2]] - Texcoords[Tri[0]];
+
+            // 与MikkTSpace一致，按纹理坐标面积的符号确定朝向，不除以面积本身
+            const float SignedArea = DeltaUV1.x() * DeltaUV2.y() - DeltaUV2.x() * DeltaUV1.y();
+            const float Sign = SignedArea < 0.0f ? -1.0f : 1.0f;
+            const Math::Vec3 Tangent = (Edge1 * DeltaUV2.y() - Edge2 * DeltaUV1.y()) * Sign;
+            const Math::Vec3 Bitangent = (Edge2 * DeltaUV1.x() - Edge1 * DeltaUV2.x()) * Sign;
+            const bool bDegenerate = SignedArea == 0.0f;
+            FaceTangents[Triangle] = bDegenerate ? Math::Vec3::Zero() : Tangent.normalized();
+            FaceBitangents[Triangle] = bDegenerate ? Math::Vec3::Zero() : Bitangent.normalized();
+        }
+    });
+
+    const VertexCornerAdjacency Adjacency(Indices, Positions.size());
+    std::vector<Math::Vec4> Tangents(Positions.size());
+    ParallelChunks(Positions.size(), [&](std::size_t Chunk, std::size_t Begin, std::size_t End)
+    {
+        for (std::size_t Vertex = Begin; Vertex < End; ++Vertex)
+        {
+            const Math::Vec3& Normal = Normals[Vertex];
+            Math::Vec3 TangentSum = Math::Vec3::Zero();
+            Math::Vec3 BitangentSum = Math::Vec3::Zero();
+            for (const uint32_t Corner : Adjacency.GetCorners(Vertex))
+            {
+                const uint32_t Triangle = Corner / 3;
+                if (FaceTangents[Triangle].isZero()) continue;
+
+                // 角点处两条边的夹角作为权重
+                const uint32_t* Tri = Indices.data() + Triangle * 3;
+                const uint32_t CornerInTriangle = Corner % 3;
+                const Math::Vec3 EdgeA = Positions[Tri[(CornerInTriangle + 1) % 3]] - Positions[Vertex];
+                const Math::Vec3 EdgeB = Positions[Tri[(CornerInTriangle + 2) % 3]] - Positions[Vertex];
+                const float LengthProduct = EdgeA.norm() * EdgeB.norm();
+                if (LengthProduct <= 0.0f) continue;
+                const float Angle = std::acos(std::clamp(EdgeA.dot(EdgeB) / LengthProduct, -1.0f, 1.0f));
+
+                // 投影到顶点法线的切平面
+                const Math::Vec3 Tangent = FaceTangents[Triangle] - Normal * Normal.dot(FaceTangents[Triangle]);
+                const Math::Vec3 Bitangent = FaceBitangents[Triangle] - Normal * Normal.dot(FaceBitangents[Triangle]);
+                if (const float Length = Tangent.norm(); Length > 0.0f) TangentSum += Tangent * (Angle / Length);
+                if (const float Length = Bitangent.norm(); Length > 0.0f) BitangentSum += Bitangent * (Angle / Length);
+            }
+
+            // 汇总后再做一次正交化，消除加权平均引入的法线分量
+            Math::Vec3 Tangent = TangentSum - Normal * Normal.dot(TangentSum);
+            const float Length = Tangent.norm();
+            Tangent = Length > 1e-12f ? Math::Vec3(Tangent / Length) : AnyPerpendicular(Normal);
+            const float Handedness = Normal.cross(Tangent).dot(BitangentSum) < 0.0f ? -1.0f : 1.0f;
+            Tangents[Vertex] = Math::Vec4(Tangent.x(), Tangent.y(), Tangent.z(), Handedness);
+        }
+    });
+    return Tangents;
+}
+
+void FMeshGeometry::ComputeVertexFrames(Mesh& InOutMesh)
+{
+    if (InOutMesh.Normals.size() != InOutMesh.Positions.size())
+    {
+        InOutMesh.Normals = ComputeNormals(InOutMesh.Indices, InOutMesh.Positions);
+    }
+    if (InOutMesh.Texcoords.size() == InOutMesh.Positions.size())
+    {
+        InOutMesh.Tangents = ComputeTangents(InOutMesh.Indices, InOutMesh.Positions, InOutMesh.Normals, InOutMesh.Texcoords);
+    }
+}
@@ -0,0 +1,453 @@
+#include "MeshProcessing.hh"
+
+#include "Logger.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+using namespace SilverBell;
+using namespace SilverBell::Assets;
+
+namespace
+{
+    constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    void CheckTriangleList(std::span<const uint32_t> Indices)
+    {
+        if (Indices.size() % 3 != 0)
+        {
+            LOG_ERROR("索引数量不是3的倍数: {}", Indices.size());
+            throw std::runtime_error("Index count must be a multiple of 3");
+        }
+    }
+}
+
+float FMeshProcessing::ComputeACMR(std::span<const uint32_t> Indices, std::size_t VertexCount, uint32_t CacheSize)
+{
+    CheckTriangleList(Indices);
+    if (Indices.empty()) return 0.0f;
+
+    // 记录顶点进入缓存时的时间戳，时间只在未命中时前进，差值不超过缓存大小即仍在FIFO中
+    std::vector<uint32_t> CacheTime(VertexCount, 0);
+    uint32_t Time = CacheSize + 1;
+    uint32_t MissCount = 0;
+    for (const uint32_t Index : Indices)
+    {
+        if (Time - CacheTime[Index] > CacheSize)
+        {
+            CacheTime[Index] = Time++;
+            ++MissCount;
+        }
+    }
+    return static_cast<float>(MissCount) / static_cast<float>(Indices.size() / 3);
+}
+
+std::vector<uint32_t> FMeshProcessing::OptimizeVertexCache(std::span<uint32_t> Indices, std::size_t VertexCount, uint32_t CacheSize)
+{
+    CheckTriangleList(Indices);
+    const std::size_t TriangleCount = Indices.size() / 3;
+    if (TriangleCount == 0) return {};
+
+    // 顶点到相邻三角形的压缩邻接表
+    std::vector<uint32_t> LiveCount(VertexCount, 0);
+    for (const uint32_t Index : Indices)
+    {
+        ++LiveCount[Index];
+    }
+    std::vector<uint32_t> AdjacencyOffsets(VertexCount + 1, 0);
+    std::inclusive_scan(LiveCount.begin(), LiveCount.end(), AdjacencyOffsets.begin() + 1);
+    std::vector<uint32_t> Adjacency(Indices.size());
+    {
+        std::vector<uint32_t> Cursor(AdjacencyOffsets.begin(), AdjacencyOffsets.end() - 1);
+        for (std::size_t Idx = 0; Idx < Indices.size(); ++Idx)
+        {
+            Adjacency[Cursor[Indices[Idx]]++] = static_cast<uint32_t>(Idx / 3);
+        }
+    }
+
+    std::vector<uint32_t> CacheTime(VertexCount, 0);
+    uint32_t Time = CacheSize + 1;
+    std::vector<bool> Emitted(TriangleCount, false);
+    std::vector<uint32_t> DeadEndStack;
+    std::vector<uint32_t> Candidates;
+    std::vector<uint32_t> Output;
+    Output.reserve(Indices.size());
+    std::vector<uint32_t> ClusterOffsets;
+    uint32_t InputCursor = 0;
+
+    auto IsInCache = [&](uint32_t Vertex) { return Time - CacheTime[Vertex] <= CacheSize; };
+
+    // 当前扇形没有可继续的顶点时，先回溯最近输出的顶点，再按输入顺序寻找还有未输出三角形的顶点
+    auto SkipDeadEnd = [&]() -> uint32_t
+    {
+        while (!DeadEndStack.empty())
+        {
+            const uint32_t Vertex = DeadEndStack.back();
+            DeadEndStack.pop_back();
+            if (LiveCount[Vertex] > 0) return Vertex;
+        }
+        while (InputCursor < VertexCount)
+        {
+            const uint32_t Vertex = InputCursor++;
+            if (LiveCount[Vertex] > 0) return Vertex;
+        }
+        return InvalidIndex;
+    };
+
+    uint32_t Fanning = SkipDeadEnd();
+    ClusterOffsets.push_back(0);
+    while (Fanning != InvalidIndex)
+    {
+        Candidates.clear();
+        for (uint32_t Adj = AdjacencyOffsets[Fanning]; Adj < AdjacencyOffsets[Fanning + 1]; ++Adj)
+        {
+            const uint32_t Triangle = Adjacency[Adj];
+            if (Emitted[Triangle]) continue;
+            Emitted[Triangle] = true;
+
+            for (uint32_t Corner = 0; Corner < 3; ++Corner)
+            {
+                const uint32_t Vertex = Indices[Triangle * 3 + Corner];
+                Output.push_back(Vertex);
+                DeadEndStack.push_back(Vertex);
+                Candidates.push_back(Vertex);
+                --LiveCount[Vertex];
+                if (!IsInCache(Vertex))
+                {
+                    CacheTime[Vertex] = Time++;
+                }
+            }
+        }
+
+        // 选择扇形结束后仍留在缓存中且最早进入缓存的顶点作为下一个扇心
+        uint32_t Next = InvalidIndex;
+        int64_t BestPriority = -1;
+        for (const uint32_t Vertex : Candidates)
+        {
+            if (LiveCount[Vertex] == 0) continue;
+            int64_t Priority = 0;
+            if (Time - CacheTime[Vertex] + 2 * LiveCount[Vertex] <= CacheSize)
+            {
+                Priority = Time - CacheTime[Vertex];
+            }
+            if (Priority > BestPriority)
+            {
+                BestPriority = Priority;
+                Next = Vertex;
+            }
+        }
+
+        if (Next == InvalidIndex)
+        {
+            Next = SkipDeadEnd();
+            // 新扇心已不在缓存中，缓存相当于被刷新，这里是簇的边界
+            if (Next != InvalidIndex && !IsInCache(Next) && Output.size() / 3 != ClusterOffsets.back())
+            {
+                ClusterOffsets.push_back(static_cast<uint32_t>(Output.size() / 3));
+            }
+        }
+        Fanning = Next;
+    }
+
+    std::ranges::copy(Output, Indices.begin());
+    return ClusterOffsets;
+}
+
+bool FMeshProcessing::OptimizeOverdraw(std::span<uint32_t> Indices, std::span<const Math::Vec3> Positions,
+    std::span<const uint32_t> ClusterOffsets, float Threshold, uint32_t CacheSize)
+{
+    CheckTriangleList(Indices);
+    const std::size_t TriangleCount = Indices.size() / 3;
+    if (ClusterOffsets.size() < 2) return false;
+
+    struct ClusterInfo
+    {
+        uint32_t Begin;
+        uint32_t End;
+        Math::Vec3 Centroid;
+        Math::Vec3 Normal;
+    };
+
+    // 以面积加权求每个簇的中心与平均法线
+    std::vector<ClusterInfo> Clusters(ClusterOffsets.size());
+    Math::Vec3 MeshCentroid = Math::Vec3::Zero();
+    float MeshArea = 0.0f;
+    for (std::size_t Cluster = 0; Cluster < ClusterOffsets.size(); ++Cluster)
+    {
+        ClusterInfo& Info = Clusters[Cluster];
+        Info.Begin = ClusterOffsets[Cluster];
+        Info.End = Cluster + 1 < ClusterOffsets.size() ? ClusterOffsets[Cluster + 1] : static_cast<uint32_t>(TriangleCount);
+        Info.Centroid = Math::Vec3::Zero();
+        Info.Normal = Math::Vec3::Zero();
+
+        float ClusterArea = 0.0f;
+        for (uint32_t Triangle = Info.Begin; Triangle < Info.End; ++Triangle)
+        {
+            const Math::Vec3& P0 = Positions[Indices[Triangle * 3 + 0]];
+            const Math::Vec3& P1 = Positions[Indices[Triangle * 3 + 1]];
+            const Math::Vec3& P2 = Positions[Indices[Triangle * 3 + 2]];
+            const Math::Vec3 Cross = (P1 - P0).cross(P2 - P0);
+            const float Area = Cross.norm();
+            Info.Centroid += (P0 + P1 + P2) * (Area / 3.0f);
+            Info.Normal += Cross;
+            ClusterArea += Area;
+        }
+
+        MeshCentroid += Info.Centroid;
+        MeshArea += ClusterArea;
+        if (ClusterArea > 0.0f)
+        {
+            Info.Centroid /= ClusterArea;
+        }
+    }
+    if (MeshArea > 0.0f)
+    {
+        MeshCentroid /= MeshArea;
+    }
+
+    // 簇中心相对网格中心的方向与簇法线越一致，簇越靠外，越应该先绘制
+    std::vector<std::pair<float, uint32_t>> SortKeys(Clusters.size());
+    for (std::size_t Cluster = 0; Cluster < Clusters.size(); ++Cluster)
+    {
+        const ClusterInfo& Info = Clusters[Cluster];
+        SortKeys[Cluster] = { (Info.Centroid - MeshCentroid).dot(Info.Normal.normalized()), static_cast<uint32_t>(Cluster) };
+    }
+    std::ranges::stable_sort(SortKeys, std::ranges::greater{}, &std::pair<float, uint32_t>::first);
+
+    std::vector<uint32_t> Sorted;
+    Sorted.reserve(Indices.size());
+    for (const auto& Key : SortKeys)
+    {
+        const ClusterInfo& Info = Clusters[Key.second];
+        Sorted.insert(Sorted.end(), Indices.begin() + Info.Begin * 3, Indices.begin() + Info.End * 3);
+    }
+
+    const float ACMRBefore = ComputeACMR(Indices, Positions.size(), CacheSize);
+    const float ACMRAfter = ComputeACMR(Sorted, Positions.size(), CacheSize);
+    if (ACMRAfter > ACMRBefore * Threshold)
+    {
+        LOG_DEBUG("重叠绘制排序使ACMR从{:.3f}升至{:.3f}，超出阈值，放弃排序", ACMRBefore, ACMRAfter);
+        return false;
+    }
+
+    std::ranges::copy(Sorted, Indices.begin());
+    return true;
+}
+
+VertexCacheReport FMeshProcessing::OptimizeIndexOrder(std::span<uint32_t> Indices, std::span<const Math::Vec3> Positions,
+    float OverdrawThreshold, uint32_t CacheSize)
+{
+    VertexCacheReport Report;
+    Report.ACMRBefore = ComputeACMR(Indices, Positions.size(), CacheSize);
+
+    const auto ClusterOffsets = OptimizeVertexCache(Indices, Positions.size(), CacheSize);
+    Report.ClusterCount = ClusterOffsets.size();
+    Report.bOverdrawSorted = OptimizeOverdraw(Indices, Positions, ClusterOffsets, OverdrawThreshold, CacheSize);
+
+    Report.ACMRAfter = ComputeACMR(Indices, Positions.size(), CacheSize);
+    return Report;
+}
+
+std::vector<uint32_t> FMeshProcessing::OptimizeVertexFetch(std::span<uint32_t> Indices, std::size_t VertexCount)
+{
+    std::vector<uint32_t> Remap(VertexCount, InvalidIndex);
+    uint32_t NextVertex = 0;
+    for (uint32_t& Index : Indices)
+    {
+        if (Remap[Index] == InvalidIndex)
+        {
+            Remap[Index] = NextVertex++;
+        }
+        Index = Remap[Index];
+    }
+    for (uint32_t& NewIndex : Remap)
+    {
+        if (NewIndex == InvalidIndex)
+        {
+            NewIndex = NextVertex++;
+        }
+    }
+    return Remap;
+}
+
+namespace
+{
+    // 近似最小包围球，先取相距较远的两点作为初始直径，再逐点扩张
+    Math::Vec4 ComputeBoundingSphere(std::span<const uint32_t> Vertices, std::span<const Math::Vec3> Positions)
+    {
+        const Math::Vec3& First = Positions[Vertices[0]];
+        auto Farthest = [&](const Math::Vec3& From)
+        {
+            uint32_t Result = Vertices[0];
+            float MaxDistance = -1.0f;
+            for (const uint32_t Vertex : Vertices)
+            {
+                const float Distance = (Positions[Vertex] - From).squaredNorm();
+                if (Distance > MaxDistance)
+                {
+                    MaxDistance = Distance;
+                    Result = Vertex;
+                }
+            }
+            return Result;
+        };
+        const Math::Vec3& PointA = Positions[Farthest(First)];
+        const Math::Vec3& PointB = Positions[Farthest(PointA)];
+
+        Math::Vec3 Center = (PointA + PointB) * 0.5f;
+        float Radius = (PointA - PointB).norm() * 0.5f;
+        for (const uint32_t Vertex : Vertices)
+        {
+            const float Distance = (Positions[Vertex] - Center).norm();
+            if (Distance > Radius)
+            {
+                const float NewRadius = (Radius + Distance) * 0.5f;
+                Center += (Positions[Vertex] - Center) * ((NewRadius - Radius) / Distance);
+                Radius = NewRadius;
+            }
+        }
+        return { Center.x(), Center.y(), Center.z(), Radius };
+    }
+}
+
+MeshletBuffers FMeshProcessing::BuildMeshlets(std::span<const uint32_t> Indices, std::span<const Math::Vec3> Positions,
+    uint32_t MaxVertices, uint32_t MaxTriangles)
+{
+    CheckTriangleList(Indices);
+    if (MaxVertices < 3 || MaxVertices > 256 || MaxTriangles == 0)
+    {
+        LOG_ERROR("meshlet上限无效，顶点上限: {}，三角形上限: {}", MaxVertices, MaxTriangles);
+        throw std::runtime_error("Invalid meshlet limits");
+    }
+
+    MeshletBuffers Result;
+    const std::size_t TriangleCount = Indices.size() / 3;
+    const std::size_t EstimatedCount = TriangleCount / MaxTriangles + 1;
+    Result.VertexOffsets.reserve(EstimatedCount);
+    Result.VertexCounts.reserve(EstimatedCount);
+    Result.TriangleOffsets.reserve(EstimatedCount);
+    Result.TriangleCounts.reserve(EstimatedCount);
+    Result.BoundingSpheres.reserve(EstimatedCount);
+    Result.ConeApexes.reserve(EstimatedCount);
+    Result.ConeAxisCutoffs.reserve(EstimatedCount);
+    Result.LocalIndices.reserve(Indices.size());
+
+    // 网格顶点在当前meshlet中的局部编号
+    std::vector<uint32_t> LocalSlot(Positions.size(), InvalidIndex);
+    uint32_t VertexOffset = 0;
+    uint32_t TriangleOffset = 0;
+
+    auto FinishMeshlet = [&]()
+    {
+        const uint32_t VertexCount = static_cast<uint32_t>(Result.VertexIndices.size()) - VertexOffset;
+        const uint32_t MeshletTriangleCount = static_cast<uint32_t>(Result.LocalIndices.size() / 3) - TriangleOffset;
+        if (MeshletTriangleCount == 0) return;
+
+        const std::span<const uint32_t> Vertices(Result.VertexIndices.data() + VertexOffset, VertexCount);
+        const std::span<const uint8_t> Triangles(Result.LocalIndices.data() + TriangleOffset * 3, MeshletTriangleCount * 3);
+        const Math::Vec4 Sphere = ComputeBoundingSphere(Vertices, Positions);
+        const Math::Vec3 Center = Sphere.head<3>();
+
+        // 法线锥，轴为三角形法线的平均方向，截止值取能包住所有法线的最大夹角
+        std::vector<Math::Vec3> Normals;
+        Normals.reserve(MeshletTriangleCount);
+        Math::Vec3 Axis = Math::Vec3::Zero();
+        for (uint32_t Triangle = 0; Triangle < MeshletTriangleCount; ++Triangle)
+        {
+            const Math::Vec3& P0 = Positions[Vertices[Triangles[Triangle * 3 + 0]]];
+            const Math::Vec3& P1 = Positions[Vertices[Triangles[Triangle * 3 + 1]]];
+            const Math::Vec3& P2 = Positions[Vertices[Triangles[Triangle * 3 + 2]]];
+            const Math::Vec3 Normal = (P1 - P0).cross(P2 - P0);
+            const float Length = Normal.norm();
+            // 退化三角形不可见，不参与法线锥
+            if (Length <= 0.0f) continue;
+            Normals.push_back(Normal / Length);
+            Axis += Normals.back();
+        }
+
+        Math::Vec4 ConeApex(Center.x(), Center.y(), Center.z(), 0.0f);
+        Math::Vec4 ConeAxisCutoff(0.0f, 0.0f, 0.0f, 1.0f);
+        const float AxisLength = Axis.norm();
+        if (AxisLength > 0.0f)
+        {
+            Axis /= AxisLength;
+            float MinDot = 1.0f;
+            for (const auto& Normal : Normals)
+            {
+                MinDot = std::min(MinDot, Normal.dot(Axis));
+            }
+            ConeAxisCutoff.head<3>() = Axis;
+            if (MinDot > 0.0f)
+            {
+                // 锥顶沿轴的反方向后退，直到所有三角形平面都在锥顶前方，使透视下的测试保守
+                float MaxOffset = 0.0f;
+                std::size_t NormalIdx = 0;
+                for (uint32_t Triangle = 0; Triangle < MeshletTriangleCount; ++Triangle)
+                {
+                    const Math::Vec3& P0 = Positions[Vertices[Triangles[Triangle * 3 + 0]]];
+                    const Math::Vec3& P1 = Positions[Vertices[Triangles[Triangle * 3 + 1]]];
+                    const Math::Vec3& P2 = Positions[Vertices[Triangles[Triangle * 3 + 2]]];
+                    if ((P1 - P0).cross(P2 - P0).norm() <= 0.0f) continue;
+                    const Math::Vec3& Normal = Normals[NormalIdx++];
+                    MaxOffset = std::max(MaxOffset, (Center - P0).dot(Normal) / Normal.dot(Axis));
+                }
+                ConeApex.head<3>() = Center - Axis * MaxOffset;
+                ConeAxisCutoff.w() = std::sqrt(1.0f - MinDot * MinDot);
+            }
+        }
+
+        Result.VertexOffsets.push_back(VertexOffset);
+        Result.VertexCounts.push_back(VertexCount);
+        Result.TriangleOffsets.push_back(TriangleOffset);
+        Result.TriangleCounts.push_back(MeshletTriangleCount);
+        Result.BoundingSpheres.push_back(Sphere);
+        Result.ConeApexes.push_back(ConeApex);
+        Result.ConeAxisCutoffs.push_back(ConeAxisCutoff);
+
+        for (const uint32_t Vertex : Vertices)
+        {
+            LocalSlot[Vertex] = InvalidIndex;
+        }
+        VertexOffset = static_cast<uint32_t>(Result.VertexIndices.size());
+        TriangleOffset = static_cast<uint32_t>(Result.LocalIndices.size() / 3);
+    };
+
+    for (std::size_t Triangle = 0; Triangle < TriangleCount; ++Triangle)
+    {
+        const uint32_t* Corners = Indices.data() + Triangle * 3;
+        uint32_t NewVertexCount = 0;
+        for (uint32_t Corner = 0; Corner < 3; ++Corner)
+        {
+            // 同一三角形中重复的顶点只计一次
+            if (LocalSlot[Corners[Corner]] == InvalidIndex && (Corner == 0 || Corners[Corner] != Corners[0])
+                && (Corner < 2 || Corners[Corner] != Corners[1]))
+            {
+                ++NewVertexCount;
+            }
+        }
+
+        const uint32_t CurrentVertexCount = static_cast<uint32_t>(Result.VertexIndices.size()) - VertexOffset;
+        const uint32_t CurrentTriangleCount = static_cast<uint32_t>(Result.LocalIndices.size() / 3) - TriangleOffset;
+        if (CurrentVertexCount + NewVertexCount > MaxVertices || CurrentTriangleCount + 1 > MaxTriangles)
+        {
+            FinishMeshlet();
+        }
+
+        for (uint32_t Corner = 0; Corner < 3; ++Corner)
+        {
+            uint32_t& Slot = LocalSlot[Corners[Corner]];
+            if (Slot == InvalidIndex)
+            {
+                Slot = static_cast<uint32_t>(Result.VertexIndices.size()) - VertexOffset;
+                Result.VertexIndices.push_back(Corners[Corner]);
+            }
+            Result.LocalIndices.push_back(static_cast<uint8_t>(Slot));
+        }
+    }
+    FinishMeshlet();
+
+    return Result;
+}
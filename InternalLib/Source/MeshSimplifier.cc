@@ -0,0 +1,286 @@
+#include "MeshSimplifier.hh"
+
+#include "Logger.hh"
+#include "MeshGeometry.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace SilverBell;
+using namespace SilverBell::Assets;
+
+namespace
+{
+    // 对称4x4矩阵的二次型，误差为到一组平面的加权平方距离之和
+    struct Quadric
+    {
+        double A00 = 0, A01 = 0, A02 = 0, A11 = 0, A12 = 0, A22 = 0;
+        double B0 = 0, B1 = 0, B2 = 0;
+        double C = 0;
+        double Weight = 0;
+
+        static Quadric FromPlane(const Eigen::Vector3d& Normal, double Distance, double Weight)
+        {
+            Quadric Q;
+            Q.A00 = Normal.x() * Normal.x() * Weight;
+            Q.A01 = Normal.x() * Normal.y() * Weight;
+            Q.A02 = Normal.x() * Normal.z() * Weight;
+            Q.A11 = Normal.y() * Normal.y() * Weight;
+            Q.A12 = Normal.y() * Normal.z() * Weight;
+            Q.A22 = Normal.z() * Normal.z() * Weight;
+            Q.B0 = Normal.x() * Distance * Weight;
+            Q.B1 = Normal.y() * Distance * Weight;
+            Q.B2 = Normal.z() * Distance * Weight;
+            Q.C = Distance * Distance * Weight;
+            Q.Weight = Weight;
+            return Q;
+        }
+
+        Quadric& operator+=(const Quadric& Other)
+        {
+            A00 += Other.A00; A01 += Other.A01; A02 += Other.A02;
+            A11 += Other.A11; A12 += Other.A12; A22 += Other.A22;
+            B0 += Other.B0; B1 += Other.B1; B2 += Other.B2;
+            C += Other.C;
+            Weight += Other.Weight;
+            return *this;
+        }
+
+        // 返回加权平均的平方距离
+        double Evaluate(const Math::Vec3& Point) const
+        {
+            const double X = Point.x(), Y = Point.y(), Z = Point.z();
+            const double Result = A00 * X * X + A11 * Y * Y + A22 * Z * Z
+                + 2.0 * (A01 * X * Y + A02 * X * Z + A12 * Y * Z)
+                + 2.0 * (B0 * X + B1 * Y + B2 * Z) + C;
+            return Weight > 0.0 ? std::max(Result, 0.0) / Weight : 0.0;
+        }
+    };
+
+    struct Collapse
+    {
+        uint32_t From;
+        uint32_t To;
+        double Cost;
+    };
+
+    uint64_t MakeEdgeKey(uint32_t A, uint32_t B)
+    {
+        return A < B ? (uint64_t(A) << 32) | B : (uint64_t(B) << 32) | A;
+    }
+}
+
+std::vector<uint32_t> FMeshSimplifier::Simplify(std::span<const uint32_t> Indices, std::span<const Math::Vec3> Positions,
+    std::size_t TargetIndexCount, float TargetError, float* OutError)
+{
+    if (Indices.size() % 3 != 0)
+    {
+        LOG_ERROR("索引数量不是3的倍数: {}", Indices.size());
+        throw std::runtime_error("Index count must be a multiple of 3");
+    }
+
+    const std::size_t VertexCount = Positions.size();
+    std::vector<uint32_t> Result(Indices.begin(), Indices.end());
+
+    // 每个顶点累积相邻三角形平面的二次型，以面积为权重
+    std::vector<Quadric> Quadrics(VertexCount);
+    for (std::size_t Triangle = 0; Triangle < Result.size() / 3; ++Triangle)
+    {
+        const uint32_t* Corners = Result.data() + Triangle * 3;
+        const Eigen::Vector3d P0 = Positions[Corners[0]].cast<double>();
+        const Eigen::Vector3d P1 = Positions[Corners[1]].cast<double>();
+        const Eigen::Vector3d P2 = Positions[Corners[2]].cast<double>();
+        Eigen::Vector3d Normal = (P1 - P0).cross(P2 - P0);
+        const double DoubleArea = Normal.norm();
+        if (DoubleArea <= 0.0) continue;
+        Normal /= DoubleArea;
+
+        const Quadric Q = Quadric::FromPlane(Normal, -Normal.dot(P0), DoubleArea * 0.5);
+        for (uint32_t Corner = 0; Corner < 3; ++Corner)
+        {
+            Quadrics[Corners[Corner]] += Q;
+        }
+    }
+
+    // 只被一个三角形使用的边是开放边界或纹理接缝，端点锁定不参与坍缩
+    std::vector<bool> Locked(VertexCount, false);
+    {
+        std::unordered_map<uint64_t, uint32_t> EdgeUseCount;
+        EdgeUseCount.reserve(Result.size());
+        for (std::size_t Idx = 0; Idx < Result.size(); Idx += 3)
+        {
+            for (uint32_t Corner = 0; Corner < 3; ++Corner)
+            {
+                ++EdgeUseCount[MakeEdgeKey(Result[Idx + Corner], Result[Idx + (Corner + 1) % 3])];
+            }
+        }
+        for (const auto& [Key, Count] : EdgeUseCount)
+        {
+            if (Count != 1) continue;
+            Locked[static_cast<uint32_t>(Key >> 32)] = true;
+            Locked[static_cast<uint32_t>(Key)] = true;
+        }
+    }
+
+    const double MaxCost = static_cast<double>(TargetError) * TargetError;
+    double ResultCost = 0.0;
+    std::vector<uint64_t> Edges;
+    std::vector<Collapse> Collapses;
+    std::vector<uint32_t> AdjacencyOffsets(VertexCount + 1);
+    std::vector<uint32_t> Adjacency;
+    std::vector<uint32_t> Remap(VertexCount);
+    std::vector<bool> Touched(VertexCount);
+
+    // 每一轮按代价从小到大执行互不相邻的坍缩，直到达到目标数量或没有代价足够低的坍缩
+    while (Result.size() > TargetIndexCount)
+    {
+        Edges.clear();
+        for (std::size_t Idx = 0; Idx < Result.size(); Idx += 3)
+        {
+            for (uint32_t Corner = 0; Corner < 3; ++Corner)
+            {
+                Edges.push_back(MakeEdgeKey(Result[Idx + Corner], Result[Idx + (Corner + 1) % 3]));
+            }
+        }
+        std::ranges::sort(Edges);
+        const auto [UniqueEnd, EdgesEnd] = std::ranges::unique(Edges);
+        Edges.erase(UniqueEnd, EdgesEnd);
+
+        Collapses.clear();
+        for (const uint64_t Key : Edges)
+        {
+            const uint32_t A = static_cast<uint32_t>(Key >> 32);
+            const uint32_t B = static_cast<uint32_t>(Key);
+            Quadric Combined = Quadrics[A];
+            Combined += Quadrics[B];
+            const double CostAToB = Locked[A] ? std::numeric_limits<double>::max() : Combined.Evaluate(Positions[B]);
+            const double CostBToA = Locked[B] ? std::numeric_limits<double>::max() : Combined.Evaluate(Positions[A]);
+            if (CostAToB <= CostBToA && CostAToB <= MaxCost)
+            {
+                Collapses.push_back({ A, B, CostAToB });
+            }
+            else if (CostBToA < CostAToB && CostBToA <= MaxCost)
+            {
+                Collapses.push_back({ B, A, CostBToA });
+            }
+        }
+        if (Collapses.empty()) break;
+        std::ranges::sort(Collapses, {}, &Collapse::Cost);
+
+        // 顶点到三角形的邻接表，用于翻转检测
+        std::ranges::fill(AdjacencyOffsets, 0);
+        for (const uint32_t Index : Result)
+        {
+            ++AdjacencyOffsets[Index + 1];
+        }
+        std::inclusive_scan(AdjacencyOffsets.begin(), AdjacencyOffsets.end(), AdjacencyOffsets.begin());
+        Adjacency.resize(Result.size());
+        {
+            std::vector<uint32_t> Cursor(AdjacencyOffsets.begin(), AdjacencyOffsets.end() - 1);
+            for (std::size_t Idx = 0; Idx < Result.size(); ++Idx)
+            {
+                Adjacency[Cursor[Result[Idx]]++] = static_cast<uint32_t>(Idx / 3);
+            }
+        }
+
+        // 坍缩后From周围的三角形法线反向说明网格发生了折叠
+        auto WouldFlip = [&](uint32_t From, uint32_t To)
+        {
+            for (uint32_t Adj = AdjacencyOffsets[From]; Adj < AdjacencyOffsets[From + 1]; ++Adj)
+            {
+                const uint32_t* Corners = Result.data() + Adjacency[Adj] * 3;
+                if (Corners[0] == To || Corners[1] == To || Corners[2] == To) continue;
+
+                const Math::Vec3& P0 = Positions[Corners[0]];
+                const Math::Vec3& P1 = Positions[Corners[1]];
+                const Math::Vec3& P2 = Positions[Corners[2]];
+                const Math::Vec3 OldNormal = (P1 - P0).cross(P2 - P0);
+                const Math::Vec3& N0 = Corners[0] == From ? Positions[To] : P0;
+                const Math::Vec3& N1 = Corners[1] == From ? Positions[To] : P1;
+                const Math::Vec3& N2 = Corners[2] == From ? Positions[To] : P2;
+                const Math::Vec3 NewNormal = (N1 - N0).cross(N2 - N0);
+                if (NewNormal.dot(OldNormal) <= 0.0f) return true;
+            }
+            return false;
+        };
+
+        std::iota(Remap.begin(), Remap.end(), 0u);
+        std::fill(Touched.begin(), Touched.end(), false);
+        const std::size_t TargetTriangleCount = TargetIndexCount / 3;
+        std::size_t TriangleCount = Result.size() / 3;
+        std::size_t CollapseCount = 0;
+        for (const Collapse& Candidate : Collapses)
+        {
+            if (TriangleCount <= TargetTriangleCount) break;
+            if (Touched[Candidate.From] || Touched[Candidate.To]) continue;
+            if (WouldFlip(Candidate.From, Candidate.To)) continue;
+
+            Remap[Candidate.From] = Candidate.To;
+            Quadrics[Candidate.To] += Quadrics[Candidate.From];
+            ResultCost = std::max(ResultCost, Candidate.Cost);
+            ++CollapseCount;
+
+            // 同一轮中不再修改From的一环邻域，保证翻转检测使用的邻接关系仍然有效
+            for (uint32_t Adj = AdjacencyOffsets[Candidate.From]; Adj < AdjacencyOffsets[Candidate.From + 1]; ++Adj)
+            {
+                const uint32_t* Corners = Result.data() + Adjacency[Adj] * 3;
+                const bool bContainsTo = Corners[0] == Candidate.To || Corners[1] == Candidate.To || Corners[2] == Candidate.To;
+                TriangleCount -= bContainsTo ? 1 : 0;
+                Touched[Corners[0]] = Touched[Corners[1]] = Touched[Corners[2]] = true;
+            }
+        }
+        if (CollapseCount == 0) break;
+
+        // 应用坍缩并移除退化三角形
+        std::size_t WriteIdx = 0;
+        for (std::size_t Idx = 0; Idx < Result.size(); Idx += 3)
+        {
+            const uint32_t A = Remap[Result[Idx + 0]];
+            const uint32_t B = Remap[Result[Idx + 1]];
+            const uint32_t C = Remap[Result[Idx + 2]];
+            if (A == B || B == C || A == C) continue;
+            Result[WriteIdx++] = A;
+            Result[WriteIdx++] = B;
+            Result[WriteIdx++] = C;
+        }
+        Result.resize(WriteIdx);
+    }
+
+    if (OutError != nullptr)
+    {
+        *OutError = static_cast<float>(std::sqrt(ResultCost));
+    }
+    return Result;
+}
+
+MeshLODChain FMeshSimplifier::BuildLODChain(std::span<const uint32_t> Indices, std::span<const Math::Vec3> Positions,
+    const MeshLODSettings& Settings)
+{
+    MeshLODChain Chain;
+    Chain.BoundingSphere = FMeshGeometry::ComputeBoundingSphere(Positions);
+    Chain.Indices.assign(Indices.begin(), Indices.end());
+    Chain.Levels.push_back({ 0, static_cast<uint32_t>(Indices.size()), 0.0f });
+
+    const float TargetError = Settings.MaxRelativeError * Chain.BoundingSphere.w();
+    std::vector<uint32_t> Previous(Indices.begin(), Indices.end());
+    float AccumulatedError = 0.0f;
+    while (Chain.Levels.size() < Settings.MaxLevelCount)
+    {
+        const std::size_t TargetIndexCount = static_cast<std::size_t>(Previous.size() / 3 * Settings.ReductionRatio) * 3;
+        float LevelError = 0.0f;
+        auto Simplified = Simplify(Previous, Positions, TargetIndexCount, TargetError, &LevelError);
+        // 减少不到一成时继续生成层级意义不大
+        if (Simplified.empty() || Simplified.size() * 10 > Previous.size() * 9) break;
+
+        // 每一层从上一层简化而来，误差逐层累加得到相对原始网格的保守上界
+        AccumulatedError += LevelError;
+        Chain.Levels.push_back({ static_cast<uint32_t>(Chain.Indices.size()), static_cast<uint32_t>(Simplified.size()), AccumulatedError });
+        Chain.Indices.insert(Chain.Indices.end(), Simplified.begin(), Simplified.end());
+        Previous = std::move(Simplified);
+    }
+    return Chain;
+}
@@ -0,0 +1,329 @@
+#include "MipGenerator.hh"
+
+#include "Logger.hh"
+#include "ThreadPool.hh"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define MIP_GENERATOR_SSE 1
+#include <immintrin.h>
+#else
+#define MIP_GENERATOR_SSE 0
+#endif
+
+using namespace SilverBell;
+using namespace SilverBell::Assets;
+
+namespace
+{
+    constexpr uint32_t BytesPerPixel = 4;
+
+    // 单个块的目标像素太少时并行的收益抵不上调度开销
+    constexpr std::size_t MinChunkPixels = 1 << 14;
+
+    // Kaiser窗的半径(目标像素)与形状参数
+    constexpr double KaiserRadius = 3.0;
+    constexpr double KaiserAlpha = 4.0;
+
+    double SRGBToLinear(double Value)
+    {
+        return Value <= 0.04045 ? Value / 12.92 : std::pow((Value + 0.055) / 1.055, 2.4);
+    }
+
+    struct ColorTables
+    {
+        // 8位值到线性值
+        std::array<float, 256> SRGBToLinear = {};
+        std::array<float, 256> UnormToLinear = {};
+        // 编码空间中(b + 0.5) / 255对应的线性值，线性值不小于的阈值个数即为在编码空间中舍入的结果
+        std::array<float, 255> SRGBThresholds = {};
+
+        ColorTables()
+        {
+            for (uint32_t Value = 0; Value < 256; ++Value)
+            {
+                SRGBToLinear[Value] = static_cast<float>(::SRGBToLinear(Value / 255.0));
+                UnormToLinear[Value] = static_cast<float>(Value / 255.0);
+            }
+            for (uint32_t Value = 0; Value < 255; ++Value)
+            {
+                SRGBThresholds[Value] = static_cast<float>(::SRGBToLinear((Value + 0.5) / 255.0));
+            }
+        }
+    };
+
+    const ColorTables& GetColorTables()
+    {
+        static const ColorTables Tables;
+        return Tables;
+    }
+
+    // 一个轴上每个目标坐标的源下标与权重，每个目标坐标固定TapCount个采样，不足的以权重0补齐
+    struct AxisTaps
+    {
+        uint32_t TapCount = 0;
+        std::vector<uint32_t> Indices;
+        std::vector<float> Weights;
+    };
+
+    double BesselI0(double X)
+    {
+        double Sum = 1.0;
+        double Term = 1.0;
+        for (int K = 1; Term > Sum * 1e-12; ++K)
+        {
+            const double Half = X / (2.0 * K);
+            Term *= Half * Half;
+            Sum += Term;
+        }
+        return Sum;
+    }
+
+    // T为到目标像素中心的距离，单位为目标像素
+    double KaiserWeight(double T)
+    {
+        if (std::abs(T) >= KaiserRadius) return 0.0;
+        const double Sinc = T == 0.0 ? 1.0 : std::sin(std::numbers::pi * T) / (std::numbers::pi * T);
+        const double Ratio = T / KaiserRadius;
+        return Sinc * BesselI0(KaiserAlpha * std::sqrt(1.0 - Ratio * Ratio)) / BesselI0(KaiserAlpha);
+    }
+
+    AxisTaps BuildAxisTaps(uint32_t SrcSize, uint32_t DstSize, EMipFilter Filter)
+    {
+        // 源像素j覆盖[j, j + 1)，目标像素x覆盖源坐标[x * Scale, (x + 1) * Scale)
+        const double Scale = static_cast<double>(SrcSize) / DstSize;
+        auto GetRange = [&](uint32_t X) -> std::pair<int64_t, int64_t>
+        {
+            if (Filter == EMipFilter::Box)
+            {
+                return { static_cast<int64_t>(std::floor(X * Scale)), static_cast<int64_t>(std::ceil((X + 1) * Scale)) };
+            }
+            const double Center = (X + 0.5) * Scale;
+            return { static_cast<int64_t>(std::floor(Center - KaiserRadius * Scale)), static_cast<int64_t>(std::ceil(Center + KaiserRadius * Scale)) };
+        };
+
+        AxisTaps Taps;
+        for (uint32_t X = 0; X < DstSize; ++X)
+        {
+            const auto [Begin, End] = GetRange(X);
+            Taps.TapCount = std::max(Taps.TapCount, static_cast<uint32_t>(End - Begin));
+        }
+        Taps.Indices.resize(static_cast<std::size_t>(DstSize) * Taps.TapCount);
+        Taps.Weights.resize(Taps.Indices.size());
+
+        std::vector<double> Weights(Taps.TapCount);
+        for (uint32_t X = 0; X < DstSize; ++X)
+        {
+            const auto [Begin, End] = GetRange(X);
+            double Sum = 0.0;
+            for (int64_t Source = Begin; Source < End; ++Source)
+            {
+                const double Weight = Filter == EMipFilter::Box
+                    ? std::min<double>(Source + 1, (X + 1) * Scale) - std::max<double>(Source, X * Scale)
+                    : KaiserWeight((Source + 0.5 - (X + 0.5) * Scale) / Scale);
+                Weights[Source - Begin] = Weight;
+                Sum += Weight;
+            }
+
+            const std::size_t Base = static_cast<std::size_t>(X) * Taps.TapCount;
+            for (uint32_t Tap = 0; Tap < Taps.TapCount; ++Tap)
+            {
+                // 超出边缘的采样钳制到边缘像素
+                const int64_t Source = std::min<int64_t>(Begin + Tap, End - 1);
+                Taps.Indices[Base + Tap] = static_cast<uint32_t>(std::clamp<int64_t>(Source, 0, SrcSize - 1));
+                Taps.Weights[Base + Tap] = Begin + Tap < End ? static_cast<float>(Weights[Tap] / Sum) : 0.0f;
+            }
+        }
+        return Taps;
+    }
+
+    void DecodeRow(const unsigned char* Src, uint32_t Width, bool bSRGB, float* Dst)
+    {
+        const ColorTables& Tables = GetColorTables();
+        const std::array<float, 256>& ColorTable = bSRGB ? Tables.SRGBToLinear : Tables.UnormToLinear;
+        for (std::size_t Idx = 0; Idx < static_cast<std::size_t>(Width) * BytesPerPixel; Idx += BytesPerPixel)
+        {
+            Dst[Idx] = ColorTable[Src[Idx]];
+            Dst[Idx + 1] = ColorTable[Src[Idx + 1]];
+            Dst[Idx + 2] = ColorTable[Src[Idx + 2]];
+            Dst[Idx + 3] = Tables.UnormToLinear[Src[Idx + 3]];
+        }
+    }
+
+    unsigned char EncodeUnorm(float Value)
+    {
+        return static_cast<unsigned char>(std::lround(std::clamp(Value, 0.0f, 1.0f) * 255.0f));
+    }
+
+    void EncodeRow(const float* Src, uint32_t Width, bool bSRGB, unsigned char* Dst)
+    {
+        const std::array<float, 255>& Thresholds = GetColorTables().SRGBThresholds;
+        auto EncodeColor = [&](float Value)
+        {
+            if (!bSRGB) return EncodeUnorm(Value);
+            return static_cast<unsigned char>(std::upper_bound(Thresholds.begin(), Thresholds.end(), Value) - Thresholds.begin());
+        };
+        for (std::size_t Idx = 0; Idx < static_cast<std::size_t>(Width) * BytesPerPixel; Idx += BytesPerPixel)
+        {
+            Dst[Idx] = EncodeColor(Src[Idx]);
+            Dst[Idx + 1] = EncodeColor(Src[Idx + 1]);
+            Dst[Idx + 2] = EncodeColor(Src[Idx + 2]);
+            Dst[Idx + 3] = EncodeUnorm(Src[Idx + 3]);
+        }
+    }
+
+    // 横向滤波，Dst[x] = Σ Weights[x][k] * Src[Indices[x][k]]，每个像素为4个float
+    void FilterRow(const float* Src, const AxisTaps& Taps, uint32_t DstWidth, float* Dst)
+    {
+        for (uint32_t X = 0; X < DstWidth; ++X)
+        {
+            const uint32_t* Indices = Taps.Indices.data() + static_cast<std::size_t>(X) * Taps.TapCount;
+            const float* Weights = Taps.Weights.data() + static_cast<std::size_t>(X) * Taps.TapCount;
+#if MIP_GENERATOR_SSE
+            __m128 Sum = _mm_setzero_ps();
+            for (uint32_t Tap = 0; Tap < Taps.TapCount; ++Tap)
+            {
+                Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_set1_ps(Weights[Tap]), _mm_loadu_ps(Src + Indices[Tap] * BytesPerPixel)));
+            }
+            _mm_storeu_ps(Dst + X * BytesPerPixel, Sum);
+#else
+            float Sum[BytesPerPixel] = {};
+            for (uint32_t Tap = 0; Tap < Taps.TapCount; ++Tap)
+            {
+                for (uint32_t Channel = 0; Channel < BytesPerPixel; ++Channel)
+                {
+                    Sum[Channel] += Weights[Tap] * Src[Indices[Tap] * BytesPerPixel + Channel];
+                }
+            }
+            std::memcpy(Dst + X * BytesPerPixel, Sum, sizeof(Sum));
+#endif
+        }
+    }
+
+    // 纵向滤波，Dst[i] = Σ Weights[k] * Rows[k][i]
+    void BlendRows(std::span<const float* const> Rows, const float* Weights, uint32_t Width, float* Dst)
+    {
+        const std::size_t Count = static_cast<std::size_t>(Width) * BytesPerPixel;
+        std::size_t Idx = 0;
+#if MIP_GENERATOR_SSE
+        for (; Idx + 4 <= Count; Idx += 4)
+        {
+            __m128 Sum = _mm_setzero_ps();
+            for (std::size_t Tap = 0; Tap < Rows.size(); ++Tap)
+            {
+                Sum = _mm_add_ps(Sum, _mm_mul_ps(_mm_set1_ps(Weights[Tap]), _mm_loadu_ps(Rows[Tap] + Idx)));
+            }
+            _mm_storeu_ps(Dst + Idx, Sum);
+        }
+#endif
+        for (; Idx < Count; ++Idx)
+        {
+            float Sum = 0.0f;
+            for (std::size_t Tap = 0; Tap < Rows.size(); ++Tap)
+            {
+                Sum += Weights[Tap] * Rows[Tap][Idx];
+            }
+            Dst[Idx] = Sum;
+        }
+    }
+
+    void GenerateLevel(const unsigned char* Src, const MipLevel& SrcLevel, unsigned char* Dst, const MipLevel& DstLevel,
+                       const MipGenerateOptions& Options)
+    {
+        const AxisTaps ColumnTaps = BuildAxisTaps(SrcLevel.Width, DstLevel.Width, Options.Filter);
+        const AxisTaps RowTaps = BuildAxisTaps(SrcLevel.Height, DstLevel.Height, Options.Filter);
+        const std::size_t SrcStride = static_cast<std::size_t>(SrcLevel.Width) * BytesPerPixel;
+        const std::size_t DstStride = static_cast<std::size_t>(DstLevel.Width) * BytesPerPixel;
+
+        const std::size_t ThreadCount = Utility::FThreadPool::Instance().GetThreadCount();
+        const std::size_t ChunkCount = std::clamp<std::size_t>(static_cast<std::size_t>(DstLevel.Width) * DstLevel.Height / MinChunkPixels,
+                                                               1, std::min<std::size_t>((ThreadCount + 1) * 4, DstLevel.Height));
+        Utility::FThreadPool::Instance().ParallelFor(ChunkCount, [&](std::size_t Chunk)
+        {
+            const uint32_t Begin = static_cast<uint32_t>(DstLevel.Height * Chunk / ChunkCount);
+            const uint32_t End = static_cast<uint32_t>(DstLevel.Height * (Chunk + 1) / ChunkCount);
+            if (Begin == End) return;
+
+            // 先把该块用到的源行横向滤波到目标宽度，块之间只重复计算边界处的少量行
+            const auto [MinRow, MaxRow] = std::ranges::minmax(std::span(RowTaps.Indices).subspan(
+                static_cast<std::size_t>(Begin) * RowTaps.TapCount, static_cast<std::size_t>(End - Begin) * RowTaps.TapCount));
+            std::vector<float> SourceRow(SrcStride);
+            std::vector<float> Filtered((MaxRow - MinRow + 1) * DstStride);
+            for (uint32_t Row = MinRow; Row <= MaxRow; ++Row)
+            {
+                DecodeRow(Src + Row * SrcStride, SrcLevel.Width, Options.bSRGB, SourceRow.data());
+                FilterRow(SourceRow.data(), ColumnTaps, DstLevel.Width, Filtered.data() + (Row - MinRow) * DstStride);
+            }
+
+            std::vector<float> OutputRow(DstStride);
+            std::vector<const float*> Rows(RowTaps.TapCount);
+            for (uint32_t Y = Begin; Y < End; ++Y)
+            {
+                const std::size_t Base = static_cast<std::size_t>(Y) * RowTaps.TapCount;
+                for (uint32_t Tap = 0; Tap < RowTaps.TapCount; ++Tap)
+                {
+                    Rows[Tap] = Filtered.data() + (RowTaps.Indices[Base + Tap] - MinRow) * DstStride;
+                }
+                BlendRows(Rows, RowTaps.Weights.data() + Base, DstLevel.Width, OutputRow.data());
+                EncodeRow(OutputRow.data(), DstLevel.Width, Options.bSRGB, Dst + Y * DstStride);
+            }
+        });
+    }
+}
+
+uint32_t FMipGenerator::GetMipLevelCount(uint32_t Width, uint32_t Height)
+{
+    return static_cast<uint32_t>(std::bit_width(std::max({ Width, Height, 1u })));
+}
+
+MipChain FMipGenerator::AllocateChain(uint32_t Width, uint32_t Height, uint32_t LevelCount)
+{
+    if (Width == 0 || Height == 0)
+    {
+        LOG_ERROR("mip链的尺寸不能为0: {}x{}", Width, Height);
+        throw std::runtime_error("Mip chain size must be non-zero");
+    }
+
+    const uint32_t FullLevelCount = GetMipLevelCount(Width, Height);
+    LevelCount = LevelCount == 0 ? FullLevelCount : std::min(LevelCount, FullLevelCount);
+
+    MipChain Chain;
+    Chain.Levels.resize(LevelCount);
+    std::size_t Offset = 0;
+    for (MipLevel& Level : Chain.Levels)
+    {
+        Level.Width = Width;
+        Level.Height = Height;
+        Level.Offset = Offset;
+        Level.Size = static_cast<std::size_t>(Width) * Height * BytesPerPixel;
+        Offset += Level.Size;
+        Width = std::max(Width / 2, 1u);
+        Height = std::max(Height / 2, 1u);
+    }
+    Chain.Pixels.resize(Offset);
+    return Chain;
+}
+
+void FMipGenerator::GenerateLevels(MipChain& Chain, const MipGenerateOptions& Options)
+{
+    for (std::size_t Level = 1; Level < Chain.Levels.size(); ++Level)
+    {
+        GenerateLevel(Chain.Pixels.data() + Chain.Levels[Level - 1].Offset, Chain.Levels[Level - 1],
+                      Chain.Pixels.data() + Chain.Levels[Level].Offset, Chain.Levels[Level], Options);
+    }
+}
+
+MipChain FMipGenerator::Generate(const unsigned char* Pixels, uint32_t Width, uint32_t Height, const MipGenerateOptions& Options)
+{
+    MipChain Chain = AllocateChain(Width, Height);
+    std::memcpy(Chain.Pixels.data(), Pixels, Chain.Levels[0].Size);
+    GenerateLevels(Chain, Options);
+    return Chain;
+}
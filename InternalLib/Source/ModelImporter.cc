@@ -1,66 +1,138 @@
 #include "ModelImporter.hh"
 
-#define TINYOBJLOADER_IMPLEMENTATION
+#include "Hash.hh"
 #include "Logger.hh"
-#include <tinyobjloader/tiny_obj_loader.h>
+#include "MeshCache.hh"
+#include "MeshGeometry.hh"
+#include "MeshProcessing.hh"
+#include "ObjParser.hh"
+
+#include <algorithm>
+#include <unordered_map>
 
 using namespace SilverBell;
 
-Model* FModelImporter::ImporterModel(std::string_view FilePath)
+namespace
 {
-    tinyobj::attrib_t Attributes;
-    std::vector<tinyobj::shape_t> Shapes;
-    std::vector<tinyobj::material_t> Materials;
-    std::string Warn;
-    std::string Error;
+    // 顶点焊接的键，位置/纹理坐标/法线下标三元组
+    struct ObjCornerHasher
+    {
+        std::size_t operator()(const ObjCorner& Key) const noexcept
+        {
+            return static_cast<std::size_t>(Algorithm::HashFunction::Hash64(&Key, sizeof(Key)));
+        }
+    };
+}
 
-    std::string FullPath = std::string(PROJECT_ROOT_PATH) + std::string(FilePath);
+std::unique_ptr<Model> FModelImporter::ImporterModel(std::string_view FilePath, const Assets::MeshLODSettings& LODSettings)
+{
+    const std::filesystem::path FullPath = std::string(PROJECT_ROOT_PATH) + std::string(FilePath);
 
-    if (!tinyobj::LoadObj(&Attributes, &Shapes, &Materials, &Warn, &Error, FullPath.c_str()))
+    // 源文件与导入参数都没有变化时直接映射上次导入的结果
+    const auto CachePath = FMeshCache::GetCachePath(FullPath);
+    const auto SourceKey = FMeshCache::ComputeSourceKey(FullPath, LODSettings);
+    if (SourceKey.has_value())
     {
-        LOG_WARN("模型加载失败: {}, {}", Warn, Error);
-        return nullptr;
+        if (auto CachedModel = FMeshCache::Load(CachePath, *SourceKey))
+        {
+            LOG_INFO("从网格缓存加载模型: {}", FilePath);
+            return CachedModel;
+        }
     }
 
-    uint32_t SizeCount = 0;
-    Model* ImportedModel = new Model;
-    for (const auto& Shape : Shapes)
+    const auto Parsed = FObjParser::Parse(FullPath);
+    if (!Parsed.has_value())
     {
-        SizeCount += static_cast<uint32_t>(Shape.mesh.indices.size());
+        LOG_WARN("模型加载失败: {}", FilePath);
+        return nullptr;
     }
-   // ImportedModel.MeshIndices.Indices.resize(SizeCount);
-    ImportedModel->MeshData.Positions.resize(SizeCount);
-    ImportedModel->MeshData.Color.resize(SizeCount);
-    ImportedModel->MeshData.TexCoord.resize(SizeCount);
 
-    uint32_t CurrentIdx = 0;
-    for (const auto& Shape : Shapes)
+    const std::size_t SizeCount = Parsed->Corners.size();
+    auto ImportedModel = std::make_unique<Model>();
+    auto& MeshData = ImportedModel->MeshData;
+    // OBJ中每个面角点都引用独立的位置/纹理坐标/法线下标，相同下标三元组的角点是同一个顶点
+    std::unordered_map<ObjCorner, uint32_t, ObjCornerHasher> UniqueVertices;
+    UniqueVertices.reserve(SizeCount);
+    std::vector<uint32_t> Indices;
+    Indices.reserve(SizeCount);
+    MeshData.Positions.reserve(SizeCount);
+    MeshData.Color.reserve(SizeCount);
+    MeshData.TexCoord.reserve(SizeCount);
+    // 只有所有角点都带法线时才使用源文件的法线，否则全部重新计算
+    const bool bSourceNormals = std::ranges::all_of(Parsed->Corners, [](const ObjCorner& Corner) { return Corner.Normal >= 0; });
+    std::vector<Math::Vec3> Normals;
+    if (bSourceNormals) Normals.reserve(SizeCount);
+
+    for (const ObjCorner& Corner : Parsed->Corners)
     {
-        for (size_t Idx = 0; Idx < Shape.mesh.indices.size(); ++Idx)
-        {
+        auto [Iter, bInserted] = UniqueVertices.try_emplace(Corner, static_cast<uint32_t>(MeshData.Positions.size()));
+        Indices.push_back(Iter->second);
+        if (!bInserted) continue;
 
-            const tinyobj::index_t& Vertex = Shape.mesh.indices[Idx];
-            ImportedModel->MeshData.Positions[CurrentIdx] = Math::Vec3(
-                Attributes.vertices[3 * Vertex.vertex_index + 0],
-                Attributes.vertices[3 * Vertex.vertex_index + 1],
-                Attributes.vertices[3 * Vertex.vertex_index + 2]
-            );
-            if (Vertex.texcoord_index >= 0)
-            {
-                ImportedModel->MeshData.TexCoord[CurrentIdx] = Math::Vec2(
-                    Attributes.texcoords[2 * Vertex.texcoord_index + 0],
-                    1.0f - Attributes.texcoords[2 * Vertex.texcoord_index + 1]
-                );
-            }
-            else
-            {
-                ImportedModel->MeshData.TexCoord[CurrentIdx] = Math::Vec2(0.0f, 0.0f);
-            }
-            ImportedModel->MeshData.Color[CurrentIdx] = Math::Vec3(1.0f, 1.0f, 1.0f);
-
-            ++CurrentIdx;
+        MeshData.Positions.push_back(Parsed->Positions[Corner.Position]);
+        if (Corner.Texcoord >= 0)
+        {
+            const Math::Vec2& Texcoord = Parsed->Texcoords[Corner.Texcoord];
+            MeshData.TexCoord.emplace_back(Texcoord.x(), 1.0f - Texcoord.y());
+        }
+        else
+        {
+            MeshData.TexCoord.emplace_back(0.0f, 0.0f);
         }
+        MeshData.Color.emplace_back(1.0f, 1.0f, 1.0f);
+        if (bSourceNormals)
+        {
+            Normals.push_back(Parsed->Normals[Corner.Normal].normalized());
+        }
+    }
+
+    // 顶点着色是稠密网格的瓶颈，重排三角形提高后变换缓存命中率，再按新顺序重排顶点提高拉取的局部性
+    const auto Report = Assets::FMeshProcessing::OptimizeIndexOrder(Indices, MeshData.Positions);
+    const auto Remap = Assets::FMeshProcessing::OptimizeVertexFetch(Indices, MeshData.Positions.size());
+    Assets::FMeshProcessing::RemapVertices(MeshData.Positions, Remap);
+    Assets::FMeshProcessing::RemapVertices(MeshData.Color, Remap);
+    Assets::FMeshProcessing::RemapVertices(MeshData.TexCoord, Remap);
+    Assets::FMeshProcessing::RemapVertices(Normals, Remap);
+
+    ImportedModel->Meshlets = Assets::FMeshProcessing::BuildMeshlets(Indices, MeshData.Positions);
+
+    // 简化后的层级打乱了三角形顺序，逐层重新做顶点缓存优化
+    auto& LODChain = ImportedModel->LODChain;
+    LODChain = Assets::FMeshSimplifier::BuildLODChain(Indices, MeshData.Positions, LODSettings);
+    for (std::size_t Level = 1; Level < LODChain.Levels.size(); ++Level)
+    {
+        const auto& LOD = LODChain.Levels[Level];
+        Assets::FMeshProcessing::OptimizeVertexCache(
+            std::span(LODChain.Indices).subspan(LOD.IndexOffset, LOD.IndexCount), MeshData.Positions.size());
     }
+    ImportedModel->MeshIndices.Assign(LODChain.Indices, MeshData.Positions.size());
+    std::vector<uint32_t>().swap(LODChain.Indices);
 
+    // 源文件没有法线时按最精细层级的三角形计算，随顶点流一起量化上传
+    if (!bSourceNormals)
+    {
+        Normals = Assets::FMeshGeometry::ComputeNormals(Indices, MeshData.Positions);
+    }
+    LOG_INFO("顶点法线: {}", bSourceNormals ? "源文件" : "计算");
+
+    // 以上处理都需要全精度位置，最后再量化为上传格式
+    ImportedModel->RenderData = Assets::FVertexQuantization::Quantize(MeshData, Normals, ImportedModel->Quantization);
+    LOG_INFO("模型加载完成: {}，顶点数: {} -> {}，索引数: {}，索引宽度: {}位", FilePath, SizeCount,
+        MeshData.Positions.size(), Indices.size(), ImportedModel->MeshIndices.Is16Bit() ? 16 : 32);
+    LOG_INFO("顶点缓存优化: ACMR {:.3f} -> {:.3f}，簇数量: {}，重叠绘制排序: {}", Report.ACMRBefore, Report.ACMRAfter,
+        Report.ClusterCount, Report.bOverdrawSorted);
+    LOG_INFO("meshlet数量: {}", ImportedModel->Meshlets.GetMeshletCount());
+    for (std::size_t Level = 0; Level < LODChain.Levels.size(); ++Level)
+    {
+        LOG_INFO("LOD{}: 三角形数: {}，误差: {:.5f}", Level, LODChain.Levels[Level].IndexCount / 3, LODChain.Levels[Level].Error);
+    }
+
+    // 切线只在使用法线贴图时需要，目前没有着色器读取，不计算也不缓存
+    ImportedModel->MeshData = {};
+
+    if (SourceKey.has_value())
+    {
+        FMeshCache::Store(CachePath, *SourceKey, *ImportedModel);
+    }
     return ImportedModel;
 }
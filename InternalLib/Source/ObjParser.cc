@@ -0,0 +1,321 @@
+#include "ObjParser.hh"
+
+#include "Logger.hh"
+#include "MappedFile.hh"
+#include "ThreadPool.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+
+using namespace SilverBell;
+
+namespace
+{
+    // 单个块太小时并行的收益抵不上调度开销
+    constexpr std::size_t MinChunkSize = 1 << 20;
+
+    struct ObjChunk
+    {
+        std::vector<Math::Vec3> Positions;
+        std::vector<Math::Vec2> Texcoords;
+        std::vector<Math::Vec3> Normals;
+        std::vector<ObjCorner> Corners;
+        // 负数下标相对于当前已读取的数量，块内只能先按块内数量换算，合并时再加上之前所有块的数量
+        // 每项为 角点编号 * 3 + 分量
+        std::vector<uint32_t> RelativeFixups;
+        // 第一处格式错误所在的块内行号，从1开始，0表示没有错误
+        std::size_t ErrorLine = 0;
+    };
+
+    const char* SkipSpaces(const char* Cursor, const char* End)
+    {
+        while (Cursor < End && (*Cursor == ' ' || *Cursor == '\t')) ++Cursor;
+        return Cursor;
+    }
+
+    bool ParseFloat(const char*& Cursor, const char* End, float& Value)
+    {
+        Cursor = SkipSpaces(Cursor, End);
+        // from_chars不接受前导加号
+        if (Cursor < End && *Cursor == '+') ++Cursor;
+        const auto [Ptr, Error] = std::from_chars(Cursor, End, Value);
+        if (Error != std::errc()) return false;
+        Cursor = Ptr;
+        return true;
+    }
+
+    template<int N>
+    bool ParseFloats(const char* Cursor, const char* End, float (&Values)[N])
+    {
+        for (float& Value : Values)
+        {
+            if (!ParseFloat(Cursor, End, Value)) return false;
+        }
+        return true;
+    }
+
+    // 把OBJ从1开始的下标换算为从0开始，负数下标按相对当前数量换算并记录需要修正
+    bool ResolveIndex(int32_t RawIndex, std::size_t LocalCount, int32_t& Index, bool& bRelative)
+    {
+        if (RawIndex > 0)
+        {
+            Index = RawIndex - 1;
+            bRelative = false;
+            return true;
+        }
+        if (RawIndex < 0)
+        {
+            Index = static_cast<int32_t>(LocalCount) + RawIndex;
+            bRelative = true;
+            return true;
+        }
+        return false;
+    }
+
+    bool ParseFace(const char* Cursor, const char* End, ObjChunk& Chunk, std::vector<ObjCorner>& Polygon, std::vector<uint8_t>& PolygonRelative)
+    {
+        Polygon.clear();
+        PolygonRelative.clear();
+        while (true)
+        {
+            Cursor = SkipSpaces(Cursor, End);
+            if (Cursor >= End) break;
+
+            // 角点格式为 v、v/vt、v//vn 或 v/vt/vn
+            ObjCorner Corner;
+            uint8_t RelativeMask = 0;
+            const std::size_t LocalCounts[] = { Chunk.Positions.size(), Chunk.Texcoords.size(), Chunk.Normals.size() };
+            int32_t* Components[] = { &Corner.Position, &Corner.Texcoord, &Corner.Normal };
+            for (int Component = 0; Component < 3; ++Component)
+            {
+                if (Component > 0)
+                {
+                    if (Cursor >= End || *Cursor != '/') break;
+                    ++Cursor;
+                    // v//vn 中省略的纹理坐标
+                    if (Cursor < End && *Cursor == '/') continue;
+                }
+
+                int32_t RawIndex = 0;
+                const auto [Ptr, Error] = std::from_chars(Cursor, End, RawIndex);
+                if (Error != std::errc()) return false;
+                Cursor = Ptr;
+
+                bool bRelative = false;
+                if (!ResolveIndex(RawIndex, LocalCounts[Component], *Components[Component], bRelative)) return false;
+                RelativeMask |= bRelative ? uint8_t(1u << Component) : uint8_t(0);
+            }
+            if (Cursor < End && *Cursor != ' ' && *Cursor != '\t') return false;
+
+            Polygon.push_back(Corner);
+            PolygonRelative.push_back(RelativeMask);
+        }
+        if (Polygon.size() < 3) return false;
+
+        // 扇形三角化
+        auto EmitCorner = [&](std::size_t PolygonIdx)
+        {
+            const uint32_t Slot = static_cast<uint32_t>(Chunk.Corners.size());
+            Chunk.Corners.push_back(Polygon[PolygonIdx]);
+            for (uint32_t Component = 0; Component < 3; ++Component)
+            {
+                if (PolygonRelative[PolygonIdx] & (1u << Component))
+                {
+                    Chunk.RelativeFixups.push_back(Slot * 3 + Component);
+                }
+            }
+        };
+        for (std::size_t Idx = 1; Idx + 1 < Polygon.size(); ++Idx)
+        {
+            EmitCorner(0);
+            EmitCorner(Idx);
+            EmitCorner(Idx + 1);
+        }
+        return true;
+    }
+
+    void ParseChunk(std::string_view Text, ObjChunk& Chunk)
+    {
+        std::vector<ObjCorner> Polygon;
+        std::vector<uint8_t> PolygonRelative;
+        std::size_t LineNumber = 0;
+        const char* Cursor = Text.data();
+        const char* const TextEnd = Text.data() + Text.size();
+        while (Cursor < TextEnd)
+        {
+            ++LineNumber;
+            const char* LineEnd = static_cast<const char*>(std::memchr(Cursor, '\n', TextEnd - Cursor));
+            if (LineEnd == nullptr) LineEnd = TextEnd;
+            const char* const NextLine = LineEnd < TextEnd ? LineEnd + 1 : TextEnd;
+            if (LineEnd > Cursor && LineEnd[-1] == '\r') --LineEnd;
+
+            const char* Line = SkipSpaces(Cursor, LineEnd);
+            Cursor = NextLine;
+            if (LineEnd - Line < 2) continue;
+
+            bool bValid = true;
+            if (Line[0] == 'v' && (Line[1] == ' ' || Line[1] == '\t'))
+            {
+                float Values[3];
+                bValid = ParseFloats(Line + 2, LineEnd, Values);
+                if (bValid) Chunk.Positions.emplace_back(Values[0], Values[1], Values[2]);
+            }
+            else if (Line[0] == 'v' && Line[1] == 't' && LineEnd - Line > 2 && (Line[2] == ' ' || Line[2] == '\t'))
+            {
+                float Values[2];
+                bValid = ParseFloats(Line + 3, LineEnd, Values);
+                if (bValid) Chunk.Texcoords.emplace_back(Values[0], Values[1]);
+            }
+            else if (Line[0] == 'v' && Line[1] == 'n' && LineEnd - Line > 2 && (Line[2] == ' ' || Line[2] == '\t'))
+            {
+                float Values[3];
+                bValid = ParseFloats(Line + 3, LineEnd, Values);
+                if (bValid) Chunk.Normals.emplace_back(Values[0], Values[1], Values[2]);
+            }
+            else if (Line[0] == 'f' && (Line[1] == ' ' || Line[1] == '\t'))
+            {
+                bValid = ParseFace(Line + 2, LineEnd, Chunk, Polygon, PolygonRelative);
+            }
+
+            if (!bValid)
+            {
+                Chunk.ErrorLine = LineNumber;
+                return;
+            }
+        }
+    }
+
+    // 按大小均分后把每个切分点推到下一行的开头
+    std::vector<std::string_view> SplitLines(std::string_view Text, std::size_t ChunkCount)
+    {
+        std::vector<std::string_view> Chunks;
+        Chunks.reserve(ChunkCount);
+        std::size_t Begin = 0;
+        for (std::size_t Idx = 1; Idx <= ChunkCount && Begin < Text.size(); ++Idx)
+        {
+            std::size_t End = Idx == ChunkCount ? Text.size() : std::max(Begin, Text.size() * Idx / ChunkCount);
+            if (End < Text.size())
+            {
+                End = Text.find('\n', End);
+                End = End == std::string_view::npos ? Text.size() : End + 1;
+            }
+            Chunks.push_back(Text.substr(Begin, End - Begin));
+            Begin = End;
+        }
+        return Chunks;
+    }
+}
+
+std::optional<ObjData> FObjParser::Parse(const std::filesystem::path& FilePath)
+{
+    try
+    {
+        Utility::FMappedFile File(FilePath);
+        const auto Data = File.GetData();
+        auto Result = ParseText(std::string_view(Data.data(), Data.size()));
+        if (!Result.has_value())
+        {
+            LOG_WARN("OBJ文件解析失败: {}", FilePath.string());
+        }
+        return Result;
+    }
+    catch (const std::exception& Exception)
+    {
+        LOG_WARN("OBJ文件读取失败: {}, {}", FilePath.string(), Exception.what());
+        return std::nullopt;
+    }
+}
+
+std::optional<ObjData> FObjParser::ParseText(std::string_view Text)
+{
+    auto& ThreadPool = Utility::FThreadPool::Instance();
+    const std::size_t ChunkCount = std::clamp<std::size_t>(Text.size() / MinChunkSize, 1, (ThreadPool.GetThreadCount() + 1) * 4);
+    const auto Texts = SplitLines(Text, ChunkCount);
+
+    std::vector<ObjChunk> Chunks(Texts.size());
+    ThreadPool.ParallelFor(Texts.size(), [&](std::size_t Idx)
+    {
+        ParseChunk(Texts[Idx], Chunks[Idx]);
+    });
+
+    // 每个块在合并结果中的起始位置
+    struct ChunkBase
+    {
+        std::size_t Positions = 0;
+        std::size_t Texcoords = 0;
+        std::size_t Normals = 0;
+        std::size_t Corners = 0;
+    };
+    std::vector<ChunkBase> Bases(Chunks.size() + 1);
+    std::size_t LineBase = 0;
+    for (std::size_t Idx = 0; Idx < Chunks.size(); ++Idx)
+    {
+        const ObjChunk& Chunk = Chunks[Idx];
+        if (Chunk.ErrorLine != 0)
+        {
+            LOG_WARN("OBJ格式错误，行号: {}", LineBase + Chunk.ErrorLine);
+            return std::nullopt;
+        }
+        LineBase += std::count(Texts[Idx].begin(), Texts[Idx].end(), '\n');
+
+        Bases[Idx + 1].Positions = Bases[Idx].Positions + Chunk.Positions.size();
+        Bases[Idx + 1].Texcoords = Bases[Idx].Texcoords + Chunk.Texcoords.size();
+        Bases[Idx + 1].Normals = Bases[Idx].Normals + Chunk.Normals.size();
+        Bases[Idx + 1].Corners = Bases[Idx].Corners + Chunk.Corners.size();
+    }
+
+    ObjData Result;
+    const ChunkBase& Total = Bases.back();
+    Result.Positions.resize(Total.Positions);
+    Result.Texcoords.resize(Total.Texcoords);
+    Result.Normals.resize(Total.Normals);
+    Result.Corners.resize(Total.Corners);
+
+    std::atomic<bool> bIndexOutOfRange = false;
+    ThreadPool.ParallelFor(Chunks.size(), [&](std::size_t Idx)
+    {
+        ObjChunk& Chunk = Chunks[Idx];
+        const ChunkBase& Base = Bases[Idx];
+        std::ranges::copy(Chunk.Positions, Result.Positions.begin() + Base.Positions);
+        std::ranges::copy(Chunk.Texcoords, Result.Texcoords.begin() + Base.Texcoords);
+        std::ranges::copy(Chunk.Normals, Result.Normals.begin() + Base.Normals);
+
+        for (const uint32_t Fixup : Chunk.RelativeFixups)
+        {
+            ObjCorner& Corner = Chunk.Corners[Fixup / 3];
+            int32_t* Component = nullptr;
+            switch (Fixup % 3)
+            {
+            case 0: Component = &Corner.Position; *Component += static_cast<int32_t>(Base.Positions); break;
+            case 1: Component = &Corner.Texcoord; *Component += static_cast<int32_t>(Base.Texcoords); break;
+            default: Component = &Corner.Normal; *Component += static_cast<int32_t>(Base.Normals); break;
+            }
+            // 相对下标越过了文件开头，换算后的-1不能当作省略处理
+            if (*Component < 0)
+            {
+                bIndexOutOfRange = true;
+            }
+        }
+
+        for (const ObjCorner& Corner : Chunk.Corners)
+        {
+            if (Corner.Position < 0 || Corner.Position >= static_cast<int64_t>(Total.Positions)
+                || Corner.Texcoord < -1 || Corner.Texcoord >= static_cast<int64_t>(Total.Texcoords)
+                || Corner.Normal < -1 || Corner.Normal >= static_cast<int64_t>(Total.Normals))
+            {
+                bIndexOutOfRange = true;
+                break;
+            }
+        }
+        std::ranges::copy(Chunk.Corners, Result.Corners.begin() + Base.Corners);
+    });
+
+    if (bIndexOutOfRange)
+    {
+        LOG_WARN("OBJ面引用了不存在的顶点");
+        return std::nullopt;
+    }
+    return Result;
+}
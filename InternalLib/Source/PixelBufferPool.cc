@@ -0,0 +1,119 @@
+#include "PixelBufferPool.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+using namespace SilverBell::Utility;
+
+FPixelBufferPool& FPixelBufferPool::Instance()
+{
+    static FPixelBufferPool sInstance;
+    return sInstance;
+}
+
+FPixelBufferPool::FPixelBufferPool(std::size_t InMaxRetainedBytes)
+    : MaxRetainedBytes(InMaxRetainedBytes)
+{
+}
+
+FPixelBufferPool::~FPixelBufferPool()
+{
+    Trim();
+}
+
+void* FPixelBufferPool::Allocate(std::size_t Size)
+{
+    // 级别按负载大小选择，2的幂大小的请求恰好落在对应级别
+    const std::size_t ClassShift = std::bit_width(std::max(Size, std::size_t{ 1 }) - 1);
+    if (ClassShift < MinClassShift || ClassShift > MaxClassShift)
+    {
+        // malloc保证的对齐在64位平台上为16字节
+        void* Block = std::malloc(std::max(Size, std::size_t{ 1 }));
+        if (Block == nullptr) return nullptr;
+        std::scoped_lock Lock(Mutex);
+        LiveBlocks.emplace(Block, BlockInfo{ .SizeClass = DirectClass, .Size = Size });
+        return Block;
+    }
+
+    const std::uint32_t SizeClass = static_cast<std::uint32_t>(ClassShift - MinClassShift);
+    const std::size_t BlockSize = std::size_t{ 1 } << ClassShift;
+    {
+        std::scoped_lock Lock(Mutex);
+        auto& Blocks = FreeBlocks[SizeClass];
+        if (!Blocks.empty())
+        {
+            void* Block = Blocks.back();
+            Blocks.pop_back();
+            RetainedBytes -= BlockSize;
+            LiveBlocks.emplace(Block, BlockInfo{ .SizeClass = SizeClass, .Size = BlockSize });
+            return Block;
+        }
+    }
+
+    void* Block = std::malloc(BlockSize);
+    if (Block == nullptr) return nullptr;
+    std::scoped_lock Lock(Mutex);
+    LiveBlocks.emplace(Block, BlockInfo{ .SizeClass = SizeClass, .Size = BlockSize });
+    return Block;
+}
+
+void* FPixelBufferPool::Reallocate(void* Block, std::size_t Size)
+{
+    if (Block == nullptr) return Allocate(Size);
+
+    BlockInfo Info;
+    {
+        std::scoped_lock Lock(Mutex);
+        Info = LiveBlocks.at(Block);
+    }
+    const std::size_t Capacity = Info.Size;
+    if (Info.SizeClass != DirectClass && Size <= Capacity) return Block;
+
+    void* NewBlock = Allocate(Size);
+    if (NewBlock == nullptr) return nullptr;
+    std::memcpy(NewBlock, Block, std::min(Capacity, Size));
+    Free(Block);
+    return NewBlock;
+}
+
+void FPixelBufferPool::Free(void* Block)
+{
+    if (Block == nullptr) return;
+
+    {
+        std::scoped_lock Lock(Mutex);
+        const auto Iter = LiveBlocks.find(Block);
+        const BlockInfo Info = Iter->second;
+        LiveBlocks.erase(Iter);
+        if (Info.SizeClass != DirectClass && RetainedBytes + Info.Size <= MaxRetainedBytes)
+        {
+            FreeBlocks[Info.SizeClass].push_back(Block);
+            RetainedBytes += Info.Size;
+            return;
+        }
+    }
+    std::free(Block);
+}
+
+void FPixelBufferPool::Trim()
+{
+    std::scoped_lock Lock(Mutex);
+    for (auto& Blocks : FreeBlocks)
+    {
+        for (void* Block : Blocks)
+        {
+            std::free(Block);
+        }
+        Blocks.clear();
+    }
+    RetainedBytes = 0;
+}
+
+std::size_t FPixelBufferPool::GetRetainedBytes() const
+{
+    std::scoped_lock Lock(Mutex);
+    return RetainedBytes;
+}
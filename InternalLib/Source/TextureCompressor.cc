@@ -0,0 +1,668 @@
+#include "TextureCompressor.hh"
+
+#include "Logger.hh"
+#include "ThreadPool.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define TEXTURE_COMPRESSOR_SSE 1
+#include <immintrin.h>
+#else
+#define TEXTURE_COMPRESSOR_SSE 0
+#endif
+
+using namespace SilverBell;
+using namespace SilverBell::Assets;
+
+namespace
+{
+    constexpr uint32_t BlockDim = 4;
+    constexpr uint32_t BlockPixelCount = BlockDim * BlockDim;
+    constexpr uint32_t ChannelCount = 4;
+
+    // 单个块行数太少时并行的收益抵不上调度开销
+    constexpr std::size_t MinChunkBlocks = 1 << 10;
+
+    struct QualitySettings
+    {
+        // 固定索引求端点的最大轮数
+        uint32_t RefineIterations;
+        // 是否再以包围盒对角线为初始端点搜索一次
+        bool bTryBoundingBox;
+    };
+
+    QualitySettings GetQualitySettings(ECompressionQuality Quality)
+    {
+        switch (Quality)
+        {
+        case ECompressionQuality::Fast: return { 0, false };
+        case ECompressionQuality::High: return { 8, true };
+        default: return { 2, false };
+        }
+    }
+
+    using Color = std::array<float, ChannelCount>;
+
+    // 4x4块按通道分开存储，值域[0, 255]
+    struct BlockPixels
+    {
+        alignas(16) float Channels[ChannelCount][BlockPixelCount];
+    };
+
+    void LoadBlock(const unsigned char* Pixels, uint32_t Width, uint32_t Height, uint32_t BlockX, uint32_t BlockY, BlockPixels& Block)
+    {
+        for (uint32_t Y = 0; Y < BlockDim; ++Y)
+        {
+            const uint32_t SourceY = std::min(BlockY * BlockDim + Y, Height - 1);
+            for (uint32_t X = 0; X < BlockDim; ++X)
+            {
+                const uint32_t SourceX = std::min(BlockX * BlockDim + X, Width - 1);
+                const unsigned char* Pixel = Pixels + (static_cast<std::size_t>(SourceY) * Width + SourceX) * ChannelCount;
+                for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+                {
+                    Block.Channels[Channel][Y * BlockDim + X] = Pixel[Channel];
+                }
+            }
+        }
+    }
+
+    // 每个像素选择加权平方误差最小的调色板项，返回总误差
+    float FindClosestIndices(const BlockPixels& Block, std::span<const Color> Palette, const Color& Weights, uint8_t* Indices)
+    {
+        float TotalError = 0.0f;
+#if TEXTURE_COMPRESSOR_SSE
+        for (uint32_t Group = 0; Group < BlockPixelCount; Group += 4)
+        {
+            __m128 Pixel[ChannelCount];
+            for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+            {
+                Pixel[Channel] = _mm_load_ps(Block.Channels[Channel] + Group);
+            }
+
+            __m128 BestError = _mm_set1_ps(std::numeric_limits<float>::max());
+            __m128 BestIndex = _mm_setzero_ps();
+            for (uint32_t Entry = 0; Entry < Palette.size(); ++Entry)
+            {
+                __m128 Error = _mm_setzero_ps();
+                for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+                {
+                    const __m128 Diff = _mm_sub_ps(Pixel[Channel], _mm_set1_ps(Palette[Entry][Channel]));
+                    Error = _mm_add_ps(Error, _mm_mul_ps(_mm_mul_ps(Diff, Diff), _mm_set1_ps(Weights[Channel])));
+                }
+                const __m128 Closer = _mm_cmplt_ps(Error, BestError);
+                BestError = _mm_min_ps(Error, BestError);
+                BestIndex = _mm_or_ps(_mm_and_ps(Closer, _mm_set1_ps(static_cast<float>(Entry))), _mm_andnot_ps(Closer, BestIndex));
+            }
+
+            alignas(16) float Errors[4];
+            alignas(16) float Best[4];
+            _mm_store_ps(Errors, BestError);
+            _mm_store_ps(Best, BestIndex);
+            for (uint32_t Lane = 0; Lane < 4; ++Lane)
+            {
+                Indices[Group + Lane] = static_cast<uint8_t>(Best[Lane]);
+                TotalError += Errors[Lane];
+            }
+        }
+#else
+        for (uint32_t Pixel = 0; Pixel < BlockPixelCount; ++Pixel)
+        {
+            float BestError = std::numeric_limits<float>::max();
+            for (uint32_t Entry = 0; Entry < Palette.size(); ++Entry)
+            {
+                float Error = 0.0f;
+                for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+                {
+                    const float Diff = Block.Channels[Channel][Pixel] - Palette[Entry][Channel];
+                    Error += Diff * Diff * Weights[Channel];
+                }
+                if (Error < BestError)
+                {
+                    BestError = Error;
+                    Indices[Pixel] = static_cast<uint8_t>(Entry);
+                }
+            }
+            TotalError += BestError;
+        }
+#endif
+        return TotalError;
+    }
+
+    Color Clamp255(const Color& Value)
+    {
+        Color Result;
+        for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+        {
+            Result[Channel] = std::clamp(Value[Channel], 0.0f, 255.0f);
+        }
+        return Result;
+    }
+
+    // 权重为0的通道不参与计算
+    void ComputeBoundingBoxEndpoints(const BlockPixels& Block, const Color& Weights, Color& OutStart, Color& OutEnd)
+    {
+        for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+        {
+            const auto [Min, Max] = std::minmax_element(Block.Channels[Channel], Block.Channels[Channel] + BlockPixelCount);
+            OutStart[Channel] = Weights[Channel] > 0.0f ? *Min : 0.0f;
+            OutEnd[Channel] = Weights[Channel] > 0.0f ? *Max : 0.0f;
+        }
+    }
+
+    // 块内颜色在主轴(协方差矩阵最大特征值对应的方向)上投影的两端，颜色都相同时两端点重合
+    void ComputePrincipalEndpoints(const BlockPixels& Block, const Color& Weights, Color& OutStart, Color& OutEnd)
+    {
+        Color Mean = {};
+        for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+        {
+            if (Weights[Channel] <= 0.0f) continue;
+            for (uint32_t Pixel = 0; Pixel < BlockPixelCount; ++Pixel) Mean[Channel] += Block.Channels[Channel][Pixel];
+            Mean[Channel] /= BlockPixelCount;
+        }
+
+        float Covariance[ChannelCount][ChannelCount] = {};
+        for (uint32_t Pixel = 0; Pixel < BlockPixelCount; ++Pixel)
+        {
+            Color Offset;
+            for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+            {
+                Offset[Channel] = Weights[Channel] > 0.0f ? Block.Channels[Channel][Pixel] - Mean[Channel] : 0.0f;
+            }
+            for (uint32_t Row = 0; Row < ChannelCount; ++Row)
+            {
+                for (uint32_t Column = 0; Column < ChannelCount; ++Column) Covariance[Row][Column] += Offset[Row] * Offset[Column];
+            }
+        }
+
+        // 幂迭代，从方差最大的通道对应的行开始
+        uint32_t MaxChannel = 0;
+        for (uint32_t Channel = 1; Channel < ChannelCount; ++Channel)
+        {
+            if (Covariance[Channel][Channel] > Covariance[MaxChannel][MaxChannel]) MaxChannel = Channel;
+        }
+        Color Axis;
+        std::copy_n(Covariance[MaxChannel], ChannelCount, Axis.begin());
+        for (int Iteration = 0; Iteration < 8; ++Iteration)
+        {
+            Color Next = {};
+            for (uint32_t Row = 0; Row < ChannelCount; ++Row)
+            {
+                for (uint32_t Column = 0; Column < ChannelCount; ++Column) Next[Row] += Covariance[Row][Column] * Axis[Column];
+            }
+            const float Scale = std::max({ std::abs(Next[0]), std::abs(Next[1]), std::abs(Next[2]), std::abs(Next[3]) });
+            if (Scale <= 0.0f) break;
+            for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel) Axis[Channel] = Next[Channel] / Scale;
+        }
+
+        float LengthSquared = 0.0f;
+        for (const float Value : Axis) LengthSquared += Value * Value;
+        if (LengthSquared <= 1e-12f)
+        {
+            OutStart = OutEnd = Mean;
+            return;
+        }
+
+        float MinProjection = std::numeric_limits<float>::max();
+        float MaxProjection = std::numeric_limits<float>::lowest();
+        for (uint32_t Pixel = 0; Pixel < BlockPixelCount; ++Pixel)
+        {
+            float Projection = 0.0f;
+            for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+            {
+                if (Weights[Channel] > 0.0f) Projection += (Block.Channels[Channel][Pixel] - Mean[Channel]) * Axis[Channel];
+            }
+            MinProjection = std::min(MinProjection, Projection);
+            MaxProjection = std::max(MaxProjection, Projection);
+        }
+        for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+        {
+            OutStart[Channel] = Mean[Channel] + Axis[Channel] * MinProjection / LengthSquared;
+            OutEnd[Channel] = Mean[Channel] + Axis[Channel] * MaxProjection / LengthSquared;
+        }
+        OutStart = Clamp255(OutStart);
+        OutEnd = Clamp255(OutEnd);
+    }
+
+    /*
+     * 固定索引，求使 Σ|(1 - t) * Start + t * End - Pixel|² 最小的两个端点，t为索引对应的插值系数
+     * 所有像素的t相同时方程退化，返回false
+     */
+    bool RefineEndpoints(const BlockPixels& Block, const uint8_t* Indices, std::span<const float> IndexWeights, Color& OutStart, Color& OutEnd)
+    {
+        float A = 0.0f, B = 0.0f, C = 0.0f;
+        Color StartSum = {}, EndSum = {};
+        for (uint32_t Pixel = 0; Pixel < BlockPixelCount; ++Pixel)
+        {
+            const float T = IndexWeights[Indices[Pixel]];
+            const float S = 1.0f - T;
+            A += S * S;
+            B += S * T;
+            C += T * T;
+            for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+            {
+                StartSum[Channel] += S * Block.Channels[Channel][Pixel];
+                EndSum[Channel] += T * Block.Channels[Channel][Pixel];
+            }
+        }
+
+        const float Determinant = A * C - B * B;
+        if (std::abs(Determinant) < 1e-6f) return false;
+        for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+        {
+            OutStart[Channel] = (C * StartSum[Channel] - B * EndSum[Channel]) / Determinant;
+            OutEnd[Channel] = (A * EndSum[Channel] - B * StartSum[Channel]) / Determinant;
+        }
+        OutStart = Clamp255(OutStart);
+        OutEnd = Clamp255(OutEnd);
+        return true;
+    }
+
+    template<typename Quantized>
+    struct EncodedBlock
+    {
+        Quantized Endpoints = {};
+        uint8_t Indices[BlockPixelCount] = {};
+        float Error = std::numeric_limits<float>::max();
+    };
+
+    /*
+     * 两端点插值格式的通用编码流程
+     * Codec提供通道权重Weights、各索引的插值系数IndexWeights、
+     * ForEachQuantized(Start, End, Visit)枚举端点量化的候选，BuildPalette(Quantized, Palette)由量化端点生成调色板
+     */
+    template<typename Codec>
+    EncodedBlock<typename Codec::Quantized> EncodeBlock(const BlockPixels& Block, const Codec& BlockCodec, const QualitySettings& Settings)
+    {
+        EncodedBlock<typename Codec::Quantized> Best;
+        std::array<Color, Codec::PaletteSize> Palette;
+
+        auto Evaluate = [&](const Color& Start, const Color& End)
+        {
+            BlockCodec.ForEachQuantized(Start, End, [&](const typename Codec::Quantized& Endpoints)
+            {
+                BlockCodec.BuildPalette(Endpoints, Palette);
+                uint8_t Indices[BlockPixelCount];
+                const float Error = FindClosestIndices(Block, Palette, BlockCodec.Weights, Indices);
+                if (Error < Best.Error)
+                {
+                    Best.Endpoints = Endpoints;
+                    std::copy_n(Indices, BlockPixelCount, Best.Indices);
+                    Best.Error = Error;
+                }
+            });
+        };
+
+        auto Search = [&](Color Start, Color End)
+        {
+            Evaluate(Start, End);
+            for (uint32_t Iteration = 0; Iteration < Settings.RefineIterations && Best.Error > 0.0f; ++Iteration)
+            {
+                if (!RefineEndpoints(Block, Best.Indices, BlockCodec.IndexWeights, Start, End)) break;
+                const float PreviousError = Best.Error;
+                Evaluate(Start, End);
+                if (Best.Error >= PreviousError) break;
+            }
+        };
+
+        Color Start, End;
+        ComputePrincipalEndpoints(Block, BlockCodec.Weights, Start, End);
+        Search(Start, End);
+        if (Settings.bTryBoundingBox && Best.Error > 0.0f)
+        {
+            ComputeBoundingBoxEndpoints(Block, BlockCodec.Weights, Start, End);
+            Search(Start, End);
+        }
+        return Best;
+    }
+
+    // BC1的RGB565端点，4色模式，调色板为 C0、C1、(2C0 + C1) / 3、(C0 + 2C1) / 3
+    struct BC1Codec
+    {
+        struct Quantized
+        {
+            uint16_t Color0;
+            uint16_t Color1;
+        };
+
+        static constexpr uint32_t PaletteSize = 4;
+        static constexpr Color Weights = { 1.0f, 1.0f, 1.0f, 0.0f };
+        static constexpr std::array<float, PaletteSize> IndexWeights = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+        static uint16_t Quantize(const Color& Value)
+        {
+            const auto R = static_cast<uint16_t>(std::lround(Value[0] * 31.0f / 255.0f));
+            const auto G = static_cast<uint16_t>(std::lround(Value[1] * 63.0f / 255.0f));
+            const auto B = static_cast<uint16_t>(std::lround(Value[2] * 31.0f / 255.0f));
+            return static_cast<uint16_t>((R << 11) | (G << 5) | B);
+        }
+
+        static Color Expand(uint16_t Value)
+        {
+            const uint32_t R = (Value >> 11) & 31u;
+            const uint32_t G = (Value >> 5) & 63u;
+            const uint32_t B = Value & 31u;
+            return { static_cast<float>((R << 3) | (R >> 2)), static_cast<float>((G << 2) | (G >> 4)), static_cast<float>((B << 3) | (B >> 2)), 0.0f };
+        }
+
+        template<typename Func>
+        void ForEachQuantized(const Color& Start, const Color& End, Func&& Visit) const
+        {
+            Visit(Quantized{ Quantize(Start), Quantize(End) });
+        }
+
+        void BuildPalette(const Quantized& Endpoints, std::array<Color, PaletteSize>& Palette) const
+        {
+            const Color Color0 = Expand(Endpoints.Color0);
+            const Color Color1 = Expand(Endpoints.Color1);
+            for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+            {
+                Palette[0][Channel] = Color0[Channel];
+                Palette[1][Channel] = Color1[Channel];
+                Palette[2][Channel] = (2.0f * Color0[Channel] + Color1[Channel]) / 3.0f;
+                Palette[3][Channel] = (Color0[Channel] + 2.0f * Color1[Channel]) / 3.0f;
+            }
+        }
+
+        // Color0 > Color1时才是4色模式，否则交换端点并对应交换索引；两端点相同时只用索引0
+        static void Write(const EncodedBlock<Quantized>& Encoded, unsigned char* Output)
+        {
+            uint16_t Color0 = Encoded.Endpoints.Color0;
+            uint16_t Color1 = Encoded.Endpoints.Color1;
+            const uint32_t IndexMask = Color0 < Color1 ? 1u : 0u;
+            if (Color0 < Color1) std::swap(Color0, Color1);
+
+            uint32_t IndexBits = 0;
+            if (Color0 != Color1)
+            {
+                for (uint32_t Pixel = 0; Pixel < BlockPixelCount; ++Pixel)
+                {
+                    IndexBits |= (Encoded.Indices[Pixel] ^ IndexMask) << (Pixel * 2);
+                }
+            }
+            std::memcpy(Output, &Color0, sizeof(Color0));
+            std::memcpy(Output + 2, &Color1, sizeof(Color1));
+            std::memcpy(Output + 4, &IndexBits, sizeof(IndexBits));
+        }
+    };
+
+    // BC4的单通道8位端点，8值模式，调色板为 A0、A1、((8 - i) * A0 + (i - 1) * A1) / 7
+    struct BC4Codec
+    {
+        struct Quantized
+        {
+            uint8_t Value0;
+            uint8_t Value1;
+        };
+
+        static constexpr uint32_t PaletteSize = 8;
+        static constexpr std::array<float, PaletteSize> IndexWeights =
+        {
+            0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f
+        };
+
+        uint32_t Channel;
+        Color Weights = {};
+
+        explicit BC4Codec(uint32_t InChannel)
+            : Channel(InChannel)
+        {
+            Weights[Channel] = 1.0f;
+        }
+
+        template<typename Func>
+        void ForEachQuantized(const Color& Start, const Color& End, Func&& Visit) const
+        {
+            Visit(Quantized{ static_cast<uint8_t>(std::lround(Start[Channel])), static_cast<uint8_t>(std::lround(End[Channel])) });
+        }
+
+        void BuildPalette(const Quantized& Endpoints, std::array<Color, PaletteSize>& Palette) const
+        {
+            for (uint32_t Entry = 0; Entry < PaletteSize; ++Entry)
+            {
+                Palette[Entry] = {};
+                Palette[Entry][Channel] = Endpoints.Value0 + (Endpoints.Value1 - Endpoints.Value0) * IndexWeights[Entry];
+            }
+        }
+
+        // Value0 > Value1时才是8值模式，否则交换端点，索引0与1互换，其余i变为9 - i；两端点相同时只用索引0
+        static void Write(const EncodedBlock<Quantized>& Encoded, unsigned char* Output)
+        {
+            uint8_t Value0 = Encoded.Endpoints.Value0;
+            uint8_t Value1 = Encoded.Endpoints.Value1;
+            const bool bSwap = Value0 < Value1;
+            if (bSwap) std::swap(Value0, Value1);
+
+            uint64_t IndexBits = 0;
+            if (Value0 != Value1)
+            {
+                for (uint32_t Pixel = 0; Pixel < BlockPixelCount; ++Pixel)
+                {
+                    uint64_t Index = Encoded.Indices[Pixel];
+                    if (bSwap) Index = Index < 2 ? Index ^ 1u : 9u - Index;
+                    IndexBits |= Index << (Pixel * 3);
+                }
+            }
+            Output[0] = Value0;
+            Output[1] = Value1;
+            for (uint32_t Byte = 0; Byte < 6; ++Byte)
+            {
+                Output[2 + Byte] = static_cast<unsigned char>(IndexBits >> (Byte * 8));
+            }
+        }
+    };
+
+    // BC7模式6，端点为RGBA各7位加每个端点1个共享的P位，16级插值
+    struct BC7Mode6Codec
+    {
+        struct Quantized
+        {
+            uint8_t Endpoints[2][ChannelCount];
+            uint8_t PBits[2];
+        };
+
+        static constexpr uint32_t PaletteSize = 16;
+        static constexpr std::array<uint32_t, PaletteSize> InterpolationWeights = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+        static constexpr Color Weights = { 1.0f, 1.0f, 1.0f, 1.0f };
+        static constexpr std::array<float, PaletteSize> IndexWeights = []()
+        {
+            std::array<float, PaletteSize> Result = {};
+            for (uint32_t Entry = 0; Entry < PaletteSize; ++Entry) Result[Entry] = InterpolationWeights[Entry] / 64.0f;
+            return Result;
+        }();
+
+        // 不透明的块两个P位都取1，Alpha端点才能精确为255
+        bool bOpaque = false;
+
+        static uint32_t Expand(uint8_t Value, uint8_t PBit)
+        {
+            return (static_cast<uint32_t>(Value) << 1) | PBit;
+        }
+
+        // 尝试各种P位组合，端点中各通道的舍入受P位影响
+        template<typename Func>
+        void ForEachQuantized(const Color& Start, const Color& End, Func&& Visit) const
+        {
+            for (uint8_t Combination = bOpaque ? 3 : 0; Combination < 4; ++Combination)
+            {
+                Quantized Endpoints;
+                Endpoints.PBits[0] = Combination & 1;
+                Endpoints.PBits[1] = Combination >> 1;
+                for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+                {
+                    Endpoints.Endpoints[0][Channel] = static_cast<uint8_t>(std::clamp<long>(std::lround((Start[Channel] - Endpoints.PBits[0]) / 2.0f), 0, 127));
+                    Endpoints.Endpoints[1][Channel] = static_cast<uint8_t>(std::clamp<long>(std::lround((End[Channel] - Endpoints.PBits[1]) / 2.0f), 0, 127));
+                }
+                Visit(Endpoints);
+            }
+        }
+
+        void BuildPalette(const Quantized& Endpoints, std::array<Color, PaletteSize>& Palette) const
+        {
+            for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+            {
+                const uint32_t Value0 = Expand(Endpoints.Endpoints[0][Channel], Endpoints.PBits[0]);
+                const uint32_t Value1 = Expand(Endpoints.Endpoints[1][Channel], Endpoints.PBits[1]);
+                for (uint32_t Entry = 0; Entry < PaletteSize; ++Entry)
+                {
+                    const uint32_t Weight = InterpolationWeights[Entry];
+                    Palette[Entry][Channel] = static_cast<float>(((64 - Weight) * Value0 + Weight * Value1 + 32) >> 6);
+                }
+            }
+        }
+
+        // 第一个像素的索引最高位隐含为0，为1时交换端点并翻转所有索引
+        static void Write(const EncodedBlock<Quantized>& Encoded, unsigned char* Output)
+        {
+            Quantized Endpoints = Encoded.Endpoints;
+            uint8_t Indices[BlockPixelCount];
+            std::copy_n(Encoded.Indices, BlockPixelCount, Indices);
+            if (Indices[0] & 8u)
+            {
+                std::swap(Endpoints.Endpoints[0], Endpoints.Endpoints[1]);
+                std::swap(Endpoints.PBits[0], Endpoints.PBits[1]);
+                for (uint8_t& Index : Indices) Index = static_cast<uint8_t>(15u - Index);
+            }
+
+            uint64_t Bits[2] = {};
+            uint32_t Position = 0;
+            auto Put = [&Bits, &Position](uint64_t Value, uint32_t Count)
+            {
+                for (uint32_t Bit = 0; Bit < Count; ++Bit, ++Position)
+                {
+                    Bits[Position / 64] |= ((Value >> Bit) & 1u) << (Position % 64);
+                }
+            };
+
+            Put(1u << 6, 7);
+            for (uint32_t Channel = 0; Channel < ChannelCount; ++Channel)
+            {
+                Put(Endpoints.Endpoints[0][Channel], 7);
+                Put(Endpoints.Endpoints[1][Channel], 7);
+            }
+            Put(Endpoints.PBits[0], 1);
+            Put(Endpoints.PBits[1], 1);
+            for (uint32_t Pixel = 0; Pixel < BlockPixelCount; ++Pixel)
+            {
+                Put(Indices[Pixel], Pixel == 0 ? 3 : 4);
+            }
+            std::memcpy(Output, Bits, sizeof(Bits));
+        }
+    };
+
+    void CompressBlock(const BlockPixels& Block, ETextureFormat Format, const QualitySettings& Settings, unsigned char* Output)
+    {
+        switch (Format)
+        {
+        case ETextureFormat::BC1:
+            BC1Codec::Write(EncodeBlock(Block, BC1Codec{}, Settings), Output);
+            break;
+        case ETextureFormat::BC3:
+            BC4Codec::Write(EncodeBlock(Block, BC4Codec(3), Settings), Output);
+            BC1Codec::Write(EncodeBlock(Block, BC1Codec{}, Settings), Output + 8);
+            break;
+        case ETextureFormat::BC5:
+            BC4Codec::Write(EncodeBlock(Block, BC4Codec(0), Settings), Output);
+            BC4Codec::Write(EncodeBlock(Block, BC4Codec(1), Settings), Output + 8);
+            break;
+        case ETextureFormat::BC7:
+        {
+            BC7Mode6Codec Codec;
+            Codec.bOpaque = std::all_of(Block.Channels[3], Block.Channels[3] + BlockPixelCount, [](float Alpha) { return Alpha == 255.0f; });
+            BC7Mode6Codec::Write(EncodeBlock(Block, Codec, Settings), Output);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+uint32_t FTextureCompressor::GetBlockBytes(ETextureFormat Format)
+{
+    switch (Format)
+    {
+    case ETextureFormat::RGBA8: return 4;
+    case ETextureFormat::BC1: return 8;
+    case ETextureFormat::BC3:
+    case ETextureFormat::BC5:
+    case ETextureFormat::BC7: return 16;
+    }
+    LOG_ERROR("未知的纹理格式: {}", static_cast<uint32_t>(Format));
+    throw std::runtime_error("Unknown texture format");
+}
+
+std::size_t FTextureCompressor::GetLevelSize(ETextureFormat Format, uint32_t Width, uint32_t Height)
+{
+    if (!IsBlockCompressed(Format)) return static_cast<std::size_t>(Width) * Height * GetBlockBytes(Format);
+    const std::size_t BlockCountX = (Width + BlockDim - 1) / BlockDim;
+    const std::size_t BlockCountY = (Height + BlockDim - 1) / BlockDim;
+    return BlockCountX * BlockCountY * GetBlockBytes(Format);
+}
+
+void FTextureCompressor::CompressLevel(std::span<const unsigned char> Pixels, uint32_t Width, uint32_t Height,
+                                       ETextureFormat Format, ECompressionQuality Quality, std::span<unsigned char> Output)
+{
+    if (Pixels.size() < static_cast<std::size_t>(Width) * Height * ChannelCount || Output.size() < GetLevelSize(Format, Width, Height))
+    {
+        LOG_ERROR("压缩纹理的输入或输出大小不足: {}x{}", Width, Height);
+        throw std::runtime_error("Texture compression buffer is too small");
+    }
+    if (!IsBlockCompressed(Format))
+    {
+        std::memcpy(Output.data(), Pixels.data(), GetLevelSize(Format, Width, Height));
+        return;
+    }
+
+    const QualitySettings Settings = GetQualitySettings(Quality);
+    const uint32_t BlockBytes = GetBlockBytes(Format);
+    const uint32_t BlockCountX = (Width + BlockDim - 1) / BlockDim;
+    const uint32_t BlockCountY = (Height + BlockDim - 1) / BlockDim;
+
+    const std::size_t ThreadCount = Utility::FThreadPool::Instance().GetThreadCount();
+    const std::size_t ChunkCount = std::clamp<std::size_t>(static_cast<std::size_t>(BlockCountX) * BlockCountY / MinChunkBlocks,
+                                                           1, std::min<std::size_t>((ThreadCount + 1) * 4, BlockCountY));
+    Utility::FThreadPool::Instance().ParallelFor(ChunkCount, [&](std::size_t Chunk)
+    {
+        const uint32_t Begin = static_cast<uint32_t>(BlockCountY * Chunk / ChunkCount);
+        const uint32_t End = static_cast<uint32_t>(BlockCountY * (Chunk + 1) / ChunkCount);
+        BlockPixels Block;
+        for (uint32_t BlockY = Begin; BlockY < End; ++BlockY)
+        {
+            for (uint32_t BlockX = 0; BlockX < BlockCountX; ++BlockX)
+            {
+                LoadBlock(Pixels.data(), Width, Height, BlockX, BlockY, Block);
+                CompressBlock(Block, Format, Settings,
+                              Output.data() + (static_cast<std::size_t>(BlockY) * BlockCountX + BlockX) * BlockBytes);
+            }
+        }
+    });
+}
+
+MipChain FTextureCompressor::Compress(const MipChain& Mips, ETextureFormat Format, ECompressionQuality Quality)
+{
+    MipChain Result;
+    Result.Levels.resize(Mips.Levels.size());
+    std::size_t Offset = 0;
+    for (std::size_t Level = 0; Level < Mips.Levels.size(); ++Level)
+    {
+        MipLevel& Compressed = Result.Levels[Level];
+        Compressed.Width = Mips.Levels[Level].Width;
+        Compressed.Height = Mips.Levels[Level].Height;
+        Compressed.Offset = Offset;
+        Compressed.Size = GetLevelSize(Format, Compressed.Width, Compressed.Height);
+        Offset += Compressed.Size;
+    }
+    Result.Pixels.resize(Offset);
+
+    for (std::size_t Level = 0; Level < Mips.Levels.size(); ++Level)
+    {
+        CompressLevel(Mips.GetLevelData(Level), Mips.Levels[Level].Width, Mips.Levels[Level].Height, Format, Quality, Result.GetLevelData(Level));
+    }
+    return Result;
+}
@@ -0,0 +1,91 @@
+#include "TextureCooker.hh"
+
+#include "Hash.hh"
+#include "ImageImporter.hh"
+#include "Logger.hh"
+
+#include <format>
+
+using namespace SilverBell;
+using namespace SilverBell::Assets;
+
+namespace
+{
+    const std::filesystem::path TextureCacheDirectory = PROJECT_ROOT_PATH "Intermediate/TextureCache";
+}
+
+std::filesystem::path FTextureCooker::GetCachePath(const std::filesystem::path& SourcePath)
+{
+    const auto PathHash = Algorithm::HashFunction::Hash64(SourcePath.lexically_normal());
+    return TextureCacheDirectory / std::format("{:016x}.sbtex", PathHash);
+}
+
+std::optional<std::uint64_t> FTextureCooker::ComputeSourceKey(const std::filesystem::path& SourcePath, const TextureCookSettings& Settings)
+{
+    // 对源文件内容求哈希对大文件代价太高，以修改时间和大小判断是否变化
+    std::error_code ErrorCode;
+    const auto WriteTime = std::filesystem::last_write_time(SourcePath, ErrorCode);
+    if (ErrorCode) return std::nullopt;
+    const auto FileSize = std::filesystem::file_size(SourcePath, ErrorCode);
+    if (ErrorCode) return std::nullopt;
+
+    // 设置中有填充字节，逐个字段组合
+    using Algorithm::HashFunction;
+    std::uint64_t Key = HashFunction::HashCombine(static_cast<std::uint64_t>(CookVersion),
+        static_cast<std::uint64_t>(WriteTime.time_since_epoch().count()));
+    Key = HashFunction::HashCombine(Key, static_cast<std::uint64_t>(FileSize));
+    Key = HashFunction::HashCombine(Key, static_cast<std::uint64_t>(Settings.Format));
+    Key = HashFunction::HashCombine(Key, static_cast<std::uint64_t>(Settings.Quality));
+    Key = HashFunction::HashCombine(Key, static_cast<std::uint64_t>(Settings.bGenerateMips));
+    Key = HashFunction::HashCombine(Key, static_cast<std::uint64_t>(Settings.MipOptions.Filter));
+    Key = HashFunction::HashCombine(Key, static_cast<std::uint64_t>(Settings.MipOptions.bSRGB));
+    return Key;
+}
+
+std::optional<CookedTexture> FTextureCooker::Cook(std::string_view FilePath, const TextureCookSettings& Settings)
+{
+    if (!Settings.bGenerateMips && FTextureCompressor::IsBlockCompressed(Settings.Format))
+    {
+        LOG_WARN("块压缩纹理无法在GPU上生成mip，仍在导入时生成: {}", FilePath);
+    }
+    const bool bGenerateMips = Settings.bGenerateMips || FTextureCompressor::IsBlockCompressed(Settings.Format);
+
+    const std::filesystem::path FullPath = std::string(PROJECT_ROOT_PATH) + std::string(FilePath);
+    const auto CachePath = GetCachePath(FullPath);
+    const auto SourceKey = ComputeSourceKey(FullPath, Settings);
+    if (SourceKey.has_value())
+    {
+        CookedTexture Cached;
+        if (FAssetSerializer::LoadFromFile(CachePath, Cached) && Cached.SourceKey == *SourceKey)
+        {
+            LOG_INFO("从纹理缓存加载纹理: {}", FilePath);
+            return Cached;
+        }
+    }
+
+    // 先读取尺寸分配mip链，第0级直接解码到链中
+    const std::string_view FilePaths[] = { FilePath };
+    const auto Queried = FImageImporter::QueryImages(FilePaths);
+    if (!Queried[0].has_value()) return std::nullopt;
+
+    MipChain Mips = FMipGenerator::AllocateChain(Queried[0]->Width, Queried[0]->Height, bGenerateMips ? 0 : 1);
+    const std::span<std::byte> Destinations[] = { std::as_writable_bytes(Mips.GetLevelData(0)) };
+    if (!FImageImporter::ImportImages(FilePaths, Destinations)[0].has_value()) return std::nullopt;
+    FMipGenerator::GenerateLevels(Mips, Settings.MipOptions);
+
+    CookedTexture Result;
+    Result.SourceKey = SourceKey.value_or(0);
+    Result.Format = Settings.Format;
+    if (FTextureCompressor::IsBlockCompressed(Settings.Format))
+    {
+        Mips = FTextureCompressor::Compress(Mips, Settings.Format, Settings.Quality);
+    }
+    Result.Levels = std::move(Mips.Levels);
+    Result.Data = std::move(Mips.Pixels);
+
+    if (SourceKey.has_value())
+    {
+        FAssetSerializer::SaveToFile(CachePath, Result);
+    }
+    return Result;
+}
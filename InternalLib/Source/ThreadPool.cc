@@ -0,0 +1,81 @@
+#include "ThreadPool.hh"
+
+#include "Logger.hh"
+
+using namespace SilverBell::Utility;
+
+namespace
+{
+    thread_local bool tIsWorkerThread = false;
+}
+
+FThreadPool& FThreadPool::Instance()
+{
+    static FThreadPool sInstance(std::max(1u, std::thread::hardware_concurrency()) - 1u);
+    return sInstance;
+}
+
+FThreadPool::FThreadPool(std::uint32_t ThreadCount)
+{
+    Workers.reserve(ThreadCount);
+    for (std::uint32_t Idx = 0; Idx < ThreadCount; ++Idx)
+    {
+        Workers.emplace_back(&FThreadPool::WorkerLoop, this);
+    }
+    LOG_DEBUG("线程池已启动，工作线程数量: {}", ThreadCount);
+}
+
+FThreadPool::~FThreadPool()
+{
+    {
+        std::scoped_lock Lock(Mutex);
+        bStopping = true;
+    }
+    Condition.notify_all();
+    for (auto& Worker : Workers)
+    {
+        Worker.join();
+    }
+}
+
+bool FThreadPool::IsWorkerThread()
+{
+    return tIsWorkerThread;
+}
+
+void FThreadPool::Push(std::function<void()> Task)
+{
+    {
+        std::scoped_lock Lock(Mutex);
+        // 没有工作线程或正在析构时直接在调用线程上执行，否则任务永远不会执行，对应的future也永远不会就绪
+        if (!Workers.empty() && !bStopping)
+        {
+            Tasks.push_back(std::move(Task));
+            Task = nullptr;
+        }
+    }
+    if (Task)
+    {
+        Task();
+        return;
+    }
+    Condition.notify_one();
+}
+
+void FThreadPool::WorkerLoop()
+{
+    tIsWorkerThread = true;
+    while (true)
+    {
+        std::function<void()> Task;
+        {
+            std::unique_lock Lock(Mutex);
+            Condition.wait(Lock, [this]() { return bStopping || !Tasks.empty(); });
+            // 退出前把队列里剩余的任务执行完，保证所有future都能就绪
+            if (Tasks.empty()) return;
+            Task = std::move(Tasks.front());
+            Tasks.pop_front();
+        }
+        Task();
+    }
+}
@@ -0,0 +1,188 @@
+#include "VertexQuantization.hh"
+
+#include "MeshGeometry.hh"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+using namespace SilverBell;
+using namespace SilverBell::Assets;
+
+namespace
+{
+    constexpr float SnormMax = 32767.0f;
+
+    // 退化为平面或点的网格在该轴上仍需非零的缩放
+    constexpr float MinExtent = 1e-6f;
+
+    int16_t ToSnorm16(float Value)
+    {
+        return static_cast<int16_t>(std::lround(std::clamp(Value, -1.0f, 1.0f) * SnormMax));
+    }
+
+    // 与Vulkan的SNORM转换规则一致，-32768与-32767都映射为-1
+    float FromSnorm16(int16_t Value)
+    {
+        return std::max(static_cast<float>(Value) / SnormMax, -1.0f);
+    }
+
+    uint8_t ToUnorm8(float Value)
+    {
+        return static_cast<uint8_t>(std::lround(std::clamp(Value, 0.0f, 1.0f) * 255.0f));
+    }
+
+    float SignNotZero(float Value)
+    {
+        return Value >= 0.0f ? 1.0f : -1.0f;
+    }
+}
+
+QuantizationParams FVertexQuantization::ComputePositionParams(std::span<const Math::Vec3> Positions)
+{
+    QuantizationParams Params;
+    if (Positions.empty()) return Params;
+
+    const BoundingBox Bounds = FMeshGeometry::ComputeBoundingBox(Positions);
+    const Math::Vec3 Center = Bounds.GetCenter();
+    const Math::Vec3 Extent = Bounds.GetExtent().cwiseMax(Math::Vec3::Constant(MinExtent));
+    // 编码时w固定为1，使解码结果 w * 0 + 1 恒为1，可直接参与矩阵变换
+    Params.PositionScale = Math::Vec4(Extent.x(), Extent.y(), Extent.z(), 0.0f);
+    Params.PositionBias = Math::Vec4(Center.x(), Center.y(), Center.z(), 1.0f);
+    return Params;
+}
+
+QuantizedPosition FVertexQuantization::EncodePosition(const Math::Vec3& Position, const QuantizationParams& Params)
+{
+    return
+    {
+        .X = ToSnorm16((Position.x() - Params.PositionBias.x()) / Params.PositionScale.x()),
+        .Y = ToSnorm16((Position.y() - Params.PositionBias.y()) / Params.PositionScale.y()),
+        .Z = ToSnorm16((Position.z() - Params.PositionBias.z()) / Params.PositionScale.z()),
+        .W = static_cast<int16_t>(SnormMax),
+    };
+}
+
+Math::Vec3 FVertexQuantization::DecodePosition(const QuantizedPosition& Position, const QuantizationParams& Params)
+{
+    return
+    {
+        FromSnorm16(Position.X) * Params.PositionScale.x() + Params.PositionBias.x(),
+        FromSnorm16(Position.Y) * Params.PositionScale.y() + Params.PositionBias.y(),
+        FromSnorm16(Position.Z) * Params.PositionScale.z() + Params.PositionBias.z(),
+    };
+}
+
+OctahedralNormal FVertexQuantization::EncodeNormal(const Math::Vec3& Normal)
+{
+    // 投影到八面体|x|+|y|+|z|=1上，下半球沿对角线折叠到上半球的外侧
+    const float L1Norm = std::abs(Normal.x()) + std::abs(Normal.y()) + std::abs(Normal.z());
+    if (L1Norm <= 0.0f) return { 0, 0 };
+
+    float X = Normal.x() / L1Norm;
+    float Y = Normal.y() / L1Norm;
+    if (Normal.z() < 0.0f)
+    {
+        const float FoldedX = (1.0f - std::abs(Y)) * SignNotZero(X);
+        const float FoldedY = (1.0f - std::abs(X)) * SignNotZero(Y);
+        X = FoldedX;
+        Y = FoldedY;
+    }
+    return { ToSnorm16(X), ToSnorm16(Y) };
+}
+
+Math::Vec3 FVertexQuantization::DecodeNormal(const OctahedralNormal& Normal)
+{
+    const float X = FromSnorm16(Normal.X);
+    const float Y = FromSnorm16(Normal.Y);
+    Math::Vec3 Result(X, Y, 1.0f - std::abs(X) - std::abs(Y));
+    const float Fold = std::max(-Result.z(), 0.0f);
+    Result.x() += Result.x() >= 0.0f ? -Fold : Fold;
+    Result.y() += Result.y() >= 0.0f ? -Fold : Fold;
+    return Result.normalized();
+}
+
+std::vector<OctahedralNormal> FVertexQuantization::EncodeNormals(std::span<const Math::Vec3> Normals)
+{
+    std::vector<OctahedralNormal> Result(Normals.size());
+    std::ranges::transform(Normals, Result.begin(), &FVertexQuantization::EncodeNormal);
+    return Result;
+}
+
+uint16_t FVertexQuantization::FloatToHalf(float Value)
+{
+    const uint32_t Bits = std::bit_cast<uint32_t>(Value);
+    const uint16_t Sign = static_cast<uint16_t>((Bits >> 16) & 0x8000u);
+    const int32_t Exponent = static_cast<int32_t>((Bits >> 23) & 0xFFu);
+    uint32_t Mantissa = Bits & 0x7FFFFFu;
+
+    // 无穷大与NaN，NaN保留为静默NaN
+    if (Exponent == 0xFF) return Sign | 0x7C00u | (Mantissa != 0 ? 0x200u : 0u);
+
+    const int32_t HalfExponent = Exponent - 127 + 15;
+    if (HalfExponent >= 0x1F) return Sign | 0x7C00u;
+
+    if (HalfExponent <= 0)
+    {
+        // 半精度的非规格化数，小于最小非规格化数一半的值舍入为0
+        if (HalfExponent < -10) return Sign;
+        Mantissa |= 0x800000u;
+        const uint32_t Shift = static_cast<uint32_t>(14 - HalfExponent);
+        uint32_t Half = Mantissa >> Shift;
+        const uint32_t Remainder = Mantissa & ((1u << Shift) - 1);
+        const uint32_t Halfway = 1u << (Shift - 1);
+        if (Remainder > Halfway || (Remainder == Halfway && (Half & 1u))) ++Half;
+        return static_cast<uint16_t>(Sign | Half);
+    }
+
+    // 尾数进位会自然进到指数上，最大值进位后恰好为无穷大
+    uint32_t Half = (static_cast<uint32_t>(HalfExponent) << 10) | (Mantissa >> 13);
+    const uint32_t Remainder = Mantissa & 0x1FFFu;
+    if (Remainder > 0x1000u || (Remainder == 0x1000u && (Half & 1u))) ++Half;
+    return static_cast<uint16_t>(Sign | Half);
+}
+
+float FVertexQuantization::HalfToFloat(uint16_t Value)
+{
+    const uint32_t Sign = static_cast<uint32_t>(Value & 0x8000u) << 16;
+    const uint32_t Exponent = (Value >> 10) & 0x1Fu;
+    const uint32_t Mantissa = Value & 0x3FFu;
+
+    if (Exponent == 0x1F) return std::bit_cast<float>(Sign | 0x7F800000u | (Mantissa << 13));
+    if (Exponent == 0)
+    {
+        const float Magnitude = std::ldexp(static_cast<float>(Mantissa), -24);
+        return Sign ? -Magnitude : Magnitude;
+    }
+    return std::bit_cast<float>(Sign | ((Exponent + 127 - 15) << 23) | (Mantissa << 13));
+}
+
+ColorRGBA8 FVertexQuantization::EncodeColor(const Math::Vec3& Color)
+{
+    return { ToUnorm8(Color.x()), ToUnorm8(Color.y()), ToUnorm8(Color.z()), 255 };
+}
+
+QuantizedMesh FVertexQuantization::Quantize(const BaseMesh& Mesh, std::span<const Math::Vec3> Normals, QuantizationParams& OutParams)
+{
+    OutParams = ComputePositionParams(Mesh.Positions);
+
+    QuantizedMesh Result;
+    Result.Positions.resize(Mesh.Positions.size());
+    std::ranges::transform(Mesh.Positions, Result.Positions.begin(), [&OutParams](const Math::Vec3& Position)
+    {
+        return EncodePosition(Position, OutParams);
+    });
+
+    Result.Color.resize(Mesh.Color.size());
+    std::ranges::transform(Mesh.Color, Result.Color.begin(), &FVertexQuantization::EncodeColor);
+
+    Result.TexCoord.resize(Mesh.TexCoord.size());
+    std::ranges::transform(Mesh.TexCoord, Result.TexCoord.begin(), [](const Math::Vec2& TexCoord)
+    {
+        return HalfTexcoord{ FloatToHalf(TexCoord.x()), FloatToHalf(TexCoord.y()) };
+    });
+
+    Result.Normal = EncodeNormals(Normals);
+    return Result;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "RendererMarco.hh"
+
+#include "Mixins.hh"
+#include "RenderResource.hh"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <Volk/volk.h>
+#include <vma/vk_mem_alloc.h>
+
+namespace SilverBell::Renderer
+{
+    // 几何缓冲区中的一段范围
+    struct GeometryAllocation
+    {
+        static constexpr uint32_t InvalidPage = std::numeric_limits<uint32_t>::max();
+
+        uint32_t PageIndex = InvalidPage;
+        // 已按申请的对齐调整过的偏移，单位为字节
+        VkDeviceSize Offset = 0;
+        VkDeviceSize Size = 0;
+        VmaVirtualAllocation Handle = VK_NULL_HANDLE;
+
+        bool IsValid() const { return PageIndex != InvalidPage; }
+    };
+
+    struct GeometryArenaStatistics
+    {
+        std::size_t PageCount = 0;
+        std::size_t AllocationCount = 0;
+        VkDeviceSize UsedBytes = 0;
+        VkDeviceSize ReservedBytes = 0;
+    };
+
+    /*
+     * 全局几何缓冲区
+     * 顶点与索引数据共用少数几个大的设备本地缓冲区(页)，每页由VMA虚拟块(TLSF)管理子分配，
+     * 网格只持有页号与偏移，绘制时按页绑定一次缓冲区并通过偏移区分网格，便于合并为多重绘制
+     */
+    class RENDERER_API FGeometryArena : public NonCopyable
+    {
+    public:
+        static constexpr VkDeviceSize DefaultPageSize = 64ull * 1024 * 1024;
+
+        explicit FGeometryArena(VmaAllocator InMemoryAllocator, VkDeviceSize InPageSize = DefaultPageSize);
+
+        ~FGeometryArena();
+
+        // 对齐可以不是2的幂，例如顶点步长，现有页放不下时创建新页，超过页大小的申请独占一页
+        GeometryAllocation Allocate(VkDeviceSize Size, VkDeviceSize Alignment);
+
+        // 调用方需保证GPU已不再使用该范围
+        void Free(GeometryAllocation& Allocation);
+
+        VkBuffer GetBuffer(uint32_t PageIndex) const { return Pages[PageIndex].Buffer.BufferHandle; }
+
+        GeometryArenaStatistics GetStatistics() const;
+
+        // 销毁所有页，必须在VMA分配器销毁之前调用
+        void Destroy();
+
+    private:
+        struct Page
+        {
+            VMABufferCache Buffer;
+            VmaVirtualBlock Block = VK_NULL_HANDLE;
+        };
+
+        uint32_t CreatePage(VkDeviceSize Size);
+
+        VmaAllocator MemoryAllocator;
+        VkDeviceSize PageSize;
+        std::vector<Page> Pages;
+    };
+}
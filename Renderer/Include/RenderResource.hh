@@ -1,12 +1,18 @@
 #pragma once
 
 #include "Logger.hh"
+#include "Mesh.hh"
 
 #include <Volk/volk.h>
 #include <vma/vk_mem_alloc.h>
 
 #include <ylt/reflection/member_value.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <span>
+
 namespace SilverBell::Renderer
 {
     // C++ 17 inline变量
@@ -25,29 +31,107 @@ namespace SilverBell::Renderer
         { sizeof(double) * 4, VK_FORMAT_R64G64B64A64_SFLOAT },
     };
 
-    // 获取顶点属性描述
-    template<typename T, std::size_t I = ylt::reflection::members_count_v<T>>
-    [[nodiscard]] constexpr std::array<VkVertexInputAttributeDescription, I> GetAttributeDescriptions(const T& iMesh)
+    // 顶点流的元素类型，容器取其value_type
+    template<typename T>
+    struct VertexElementType { using Type = T; };
+
+    template<typename T>
+    requires requires { typename T::value_type; }
+    struct VertexElementType<T> { using Type = typename T::value_type; };
+
+    // 按字节数无法区分的量化顶点类型需要显式指定格式，未特化的类型按VkFormatMap中的浮点格式推断
+    template<typename T>
+    struct VertexFormatOverride {};
+
+    template<> struct VertexFormatOverride<Assets::QuantizedPosition> { static constexpr VkFormat Format = VK_FORMAT_R16G16B16A16_SNORM; };
+    template<> struct VertexFormatOverride<Assets::OctahedralNormal> { static constexpr VkFormat Format = VK_FORMAT_R16G16_SNORM; };
+    template<> struct VertexFormatOverride<Assets::HalfTexcoord> { static constexpr VkFormat Format = VK_FORMAT_R16G16_SFLOAT; };
+    template<> struct VertexFormatOverride<Assets::ColorRGBA8> { static constexpr VkFormat Format = VK_FORMAT_R8G8B8A8_UNORM; };
+
+    // 顶点缓冲布局，编译期选择，可以按pass分别选择以对比性能
+    enum class EVertexLayout : uint8_t
     {
-        std::array<VkVertexInputAttributeDescription, I> AttributeDescriptions = {};
+        // 分离存储 (Separated)，每个成员一个绑定
+        Separated,
+        // 交错存储 (Interleaved)，所有成员打包进一个绑定
+        Interleaved,
+        // 第一个成员(位置)单独一个绑定，其余成员交错存储，深度pass只需绑定位置流
+        PositionSplit,
+    };
+
+    /*
+     * 由反射的顶点结构体推导的缓冲布局
+     * 属性按成员顺序紧凑排列，偏移与步长按4字节对齐，
+     * Separated与PositionSplit布局下绑定0只包含位置
+     */
+    template<typename T, EVertexLayout Layout>
+    struct VertexLayoutInfo
+    {
+        static constexpr std::size_t AttributeCount = ylt::reflection::members_count_v<T>;
+        static constexpr std::size_t BindingCount =
+            Layout == EVertexLayout::Separated ? AttributeCount
+            : Layout == EVertexLayout::Interleaved ? 1
+            : std::min<std::size_t>(AttributeCount, 2);
+
+        std::array<uint32_t, AttributeCount> ElementSizes = {};
+        std::array<uint32_t, AttributeCount> Bindings = {};
+        std::array<uint32_t, AttributeCount> Offsets = {};
+        std::array<uint32_t, BindingCount> Strides = {};
+    };
 
-        ylt::reflection::for_each(iMesh,[&AttributeDescriptions](auto& Field, auto Name, auto Index)
+    template<typename T, EVertexLayout Layout>
+    [[nodiscard]] VertexLayoutInfo<T, Layout> GetVertexLayout()
+    {
+        VertexLayoutInfo<T, Layout> Info;
+        const T Prototype{};
+        ylt::reflection::for_each(Prototype, [&Info](auto& Field, auto Name, auto Index)
         {
             using MemberType = std::remove_cvref_t<decltype(Field)>;
+            Info.ElementSizes[Index] = sizeof(typename VertexElementType<MemberType>::Type);
+        });
 
-            size_t ValueSize;
-            // C++ 20 requires 语法
-            if constexpr (requires { typename MemberType::value_type; })
+        for (std::size_t Attribute = 0; Attribute < Info.AttributeCount; ++Attribute)
+        {
+            uint32_t Binding = 0;
+            if constexpr (Layout == EVertexLayout::Separated)
             {
-                ValueSize = sizeof(typename MemberType::value_type);
+                Binding = static_cast<uint32_t>(Attribute);
             }
-            else
+            else if constexpr (Layout == EVertexLayout::PositionSplit)
             {
-                ValueSize = sizeof(MemberType);
+                Binding = Attribute == 0 ? 0 : 1;
             }
 
-            AttributeDescriptions[Index].binding = Index;
+            uint32_t& Stride = Info.Strides[Binding];
+            Info.Bindings[Attribute] = Binding;
+            Info.Offsets[Attribute] = Stride;
+            Stride = (Stride + Info.ElementSizes[Attribute] + 3) & ~3u;
+        }
+        return Info;
+    }
+
+    // 获取顶点属性描述
+    template<typename T, EVertexLayout Layout = EVertexLayout::Separated, std::size_t I = ylt::reflection::members_count_v<T>>
+    [[nodiscard]] constexpr std::array<VkVertexInputAttributeDescription, I> GetAttributeDescriptions(const T& iMesh)
+    {
+        std::array<VkVertexInputAttributeDescription, I> AttributeDescriptions = {};
+        const auto VertexLayout = GetVertexLayout<T, Layout>();
+
+        ylt::reflection::for_each(iMesh,[&AttributeDescriptions, &VertexLayout](auto& Field, auto Name, auto Index)
+        {
+            using MemberType = std::remove_cvref_t<decltype(Field)>;
+            using ValueType = typename VertexElementType<MemberType>::Type;
+
+            AttributeDescriptions[Index].binding = VertexLayout.Bindings[Index];
             AttributeDescriptions[Index].location = Index;
+            AttributeDescriptions[Index].offset = VertexLayout.Offsets[Index];
+            if constexpr (requires { VertexFormatOverride<ValueType>::Format; })
+            {
+                AttributeDescriptions[Index].format = VertexFormatOverride<ValueType>::Format;
+                return;
+            }
+
+            const size_t ValueSize = sizeof(ValueType);
             auto Finder = VkFormatMap.find(ValueSize);
             if (Finder == VkFormatMap.end())
             {
@@ -55,55 +139,78 @@ namespace SilverBell::Renderer
             }
             AttributeDescriptions[Index].format = Finder != VkFormatMap.end()
                 ? static_cast<VkFormat>(Finder->second) : VK_FORMAT_R32G32B32A32_SFLOAT; // TODO: 根据类型动态设置
-            // 由于顶点属性是 分离存储 (Separated)，每个属性都是单独的数组存储，所以offset就是0
-            AttributeDescriptions[Index].offset = 0;
         });
 
         return AttributeDescriptions;
     }
 
     // 获取顶点属性描述（不传参版本，需要类型T可默认构造）
-    template<typename T, std::size_t I = ylt::reflection::members_count_v<T>>
+    template<typename T, EVertexLayout Layout = EVertexLayout::Separated, std::size_t I = ylt::reflection::members_count_v<T>>
     requires std::default_initializable<T>
     [[nodiscard]] constexpr std::array<VkVertexInputAttributeDescription, I> GetAttributeDescriptions()
     {
-        return GetAttributeDescriptions(T{});
+        return GetAttributeDescriptions<T, Layout, I>(T{});
     }
 
     // 获取顶点绑定描述
-    template<typename T, std::size_t I = ylt::reflection::members_count_v<T>>
-    [[nodiscard]] std::array<VkVertexInputBindingDescription, I> GetBindingDescriptions(const T& iMesh)
+    template<typename T, EVertexLayout Layout = EVertexLayout::Separated, std::size_t I = VertexLayoutInfo<T, Layout>::BindingCount>
+    [[nodiscard]] std::array<VkVertexInputBindingDescription, I> GetBindingDescriptions()
     {
         std::array<VkVertexInputBindingDescription, I> BindingDescription = {};
-        ylt::reflection::for_each(iMesh, [&BindingDescription](auto& Field, auto Name, auto Index)
+        const auto VertexLayout = GetVertexLayout<T, Layout>();
+        for (std::size_t Binding = 0; Binding < I; ++Binding)
         {
-            using MemberType = std::remove_cvref_t<decltype(Field)>;
-
-            size_t ValueSize;
-            if constexpr (requires { typename MemberType::value_type; })
-            {
-                ValueSize = sizeof(typename MemberType::value_type);
-            }
-            else
-            {
-                ValueSize = sizeof(MemberType);
-            }
-
-            BindingDescription[Index].binding = Index;
-            BindingDescription[Index].stride = ValueSize;
-            BindingDescription[Index].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-        });
+            BindingDescription[Binding].binding = static_cast<uint32_t>(Binding);
+            BindingDescription[Binding].stride = VertexLayout.Strides[Binding];
+            BindingDescription[Binding].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        }
 
         return BindingDescription;
     }
 
-    // 获取顶点绑定描述（不传参版本，需要类型T可默认构造）
-    template<typename T, std::size_t I = ylt::reflection::members_count_v<T>>
-    requires std::default_initializable<T>
-    [[nodiscard]] std::array<VkVertexInputBindingDescription, I> GetBindingDescriptions()
+    // 获取顶点绑定描述（按对象推导类型的版本）
+    template<typename T, EVertexLayout Layout = EVertexLayout::Separated, std::size_t I = VertexLayoutInfo<T, Layout>::BindingCount>
+    [[nodiscard]] std::array<VkVertexInputBindingDescription, I> GetBindingDescriptions(const T& iMesh)
+    {
+        return GetBindingDescriptions<T, Layout, I>();
+    }
+
+    /*
+     * 把分离存储的各顶点流按布局写入指定绑定的缓冲，Destination可以直接是映射的暂存缓冲
+     * Streams的顺序与T的成员一致，Destination的大小需为 顶点数 * Strides[Binding]
+     */
+    template<typename T, EVertexLayout Layout>
+    void PackVertexStreams(const VertexLayoutInfo<T, Layout>& VertexLayout,
+                           std::span<const std::span<const std::byte>> Streams,
+                           uint32_t Binding,
+                           std::span<std::byte> Destination)
     {
-        return GetBindingDescriptions(T{});
+        const uint32_t Stride = VertexLayout.Strides[Binding];
+        const std::size_t VertexCount = Streams.empty() ? 0 : Streams[0].size() / VertexLayout.ElementSizes[0];
+        if (Destination.size() < VertexCount * Stride)
+        {
+            LOG_ERROR("顶点缓冲大小不足: {} < {}", Destination.size(), VertexCount * Stride);
+            throw std::runtime_error("Vertex buffer is too small!");
+        }
+
+        for (std::size_t Attribute = 0; Attribute < VertexLayout.AttributeCount; ++Attribute)
+        {
+            if (VertexLayout.Bindings[Attribute] != Binding) continue;
+
+            const uint32_t ElementSize = VertexLayout.ElementSizes[Attribute];
+            const std::byte* Source = Streams[Attribute].data();
+            // 独占整个绑定时布局与分离存储相同，整块拷贝
+            if (ElementSize == Stride)
+            {
+                std::memcpy(Destination.data(), Source, VertexCount * ElementSize);
+                continue;
+            }
+            std::byte* Target = Destination.data() + VertexLayout.Offsets[Attribute];
+            for (std::size_t Vertex = 0; Vertex < VertexCount; ++Vertex)
+            {
+                std::memcpy(Target + Vertex * Stride, Source + Vertex * ElementSize, ElementSize);
+            }
+        }
     }
 
     struct VMABufferCache
@@ -211,6 +318,7 @@ namespace SilverBell::Renderer
     {
         uint32_t Width = 0;
         uint32_t Height = 0;
+        uint32_t MipLevels = 1;
         VkImageTiling Tiling = VK_IMAGE_TILING_OPTIMAL;
         VkFormat Format = VK_FORMAT_R8G8B8A8_UNORM;
         VkImageUsageFlags Usage = 0;
@@ -222,6 +330,7 @@ namespace SilverBell::Renderer
     {
         uint32_t Width = 0;
         uint32_t Height = 0;
+        uint32_t MipLevels = 1;
         VkImage ImageHandle = VK_NULL_HANDLE;
         VmaAllocation Allocation = VK_NULL_HANDLE;
         VmaAllocationInfo AllocationInfo = {};
@@ -237,7 +346,7 @@ namespace SilverBell::Renderer
         ImageInfo.extent.width = static_cast<uint32_t>(CreateInfo.Width);
         ImageInfo.extent.height = static_cast<uint32_t>(CreateInfo.Height);
         ImageInfo.extent.depth = 1;
-        ImageInfo.mipLevels = 1;
+        ImageInfo.mipLevels = CreateInfo.MipLevels;
         ImageInfo.arrayLayers = 1;
         ImageInfo.format = CreateInfo.Format;
         ImageInfo.tiling = CreateInfo.Tiling;
@@ -254,6 +363,7 @@ namespace SilverBell::Renderer
 
         ImageCache.Width = static_cast<uint32_t>(CreateInfo.Width);
         ImageCache.Height = static_cast<uint32_t>(CreateInfo.Height);
+        ImageCache.MipLevels = CreateInfo.MipLevels;
         if (vmaCreateImage(MemoryAllocator,
             &ImageInfo,
             &AllocCreateInfo,
@@ -21,4 +21,15 @@
 #endif
 
 // Release模式下禁用Vulkan调试层，不然会崩溃
-#define VULKAN_DEBUG_ENABLE 1
\ No newline at end of file
+#define VULKAN_DEBUG_ENABLE 1
+
+// 着色器热重载，默认只在调试模式下开启
+#define SHADER_HOT_RELOAD_ENABLE VULKAN_DEBUG_ENABLE
+
+// 着色器优化与调试信息移除，由CMake的SHADER_OPTIMIZE选项按构建配置定义，未定义时只在非调试模式下开启
+#ifndef SHADER_OPTIMIZE_ENABLE
+#define SHADER_OPTIMIZE_ENABLE (!VULKAN_DEBUG_ENABLE)
+#endif
+
+// 从离线生成的着色器包加载着色器，默认只在非调试模式下开启
+#define SHADER_ARCHIVE_ENABLE (!VULKAN_DEBUG_ENABLE)
\ No newline at end of file
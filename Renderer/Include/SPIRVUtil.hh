@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace SilverBell::Renderer
+{
+    /*
+     * SPIR-V二进制处理工具
+     * 只按指令的字数遍历二进制，不解析指令语义
+     */
+    class FSPIRVUtil
+    {
+    public:
+        FSPIRVUtil() = delete;
+        ~FSPIRVUtil() = delete;
+
+        // 统计指令数量，二进制格式不合法时返回0
+        static std::uint32_t CountInstructions(std::span<const std::uint32_t> Binary);
+
+        // 移除调试信息：OpSource系列、OpName、OpMemberName、OpString、OpLine、OpNoLine、OpModuleProcessed，
+        // 以及所有NonSemantic扩展指令集的指令，这些指令都不影响着色器的执行结果
+        static std::vector<std::uint32_t> StripDebugInfo(std::span<const std::uint32_t> Binary);
+    };
+}
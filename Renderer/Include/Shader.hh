@@ -3,6 +3,8 @@
 #include <ylt/reflection/member_value.hpp>
 
 #include <filesystem>
+#include <memory>
+#include <span>
 #include <unordered_set>
 #include <vector>
 
@@ -31,9 +33,14 @@ namespace SilverBell::Renderer
     {
     public:
         bool HasBinary() const { return !SPIRVData.empty(); }
-             
+
+        std::span<const uint32_t> GetBinary() const { return SPIRVData; }
+
+        // SPIR-V二进制的哈希，不同宏组合编译出相同二进制时哈希相同
         auto GetHash() const { return BinaryHash; }
 
+        const ShaderDesc& GetDesc() const { return Desc; }
+
         const auto& GetReflectionInfo() const { return ReflectionInfo; }
 
     private:
@@ -41,13 +48,21 @@ namespace SilverBell::Renderer
         explicit FShader(ShaderDesc iDesc);
 
         ShaderDesc Desc;
-        std::vector<uint32_t> SPIRVData;
-        std::uint64_t BinaryHash;
-
-      /*  friend bool operator==(const FShader& L, const FShader& R)
+        // 由FShader自己持有二进制数据
+        void SetBinary(std::vector<uint32_t> Binary)
         {
-            return L.BinaryHash == R.BinaryHash;
-        }*/
+            auto Owner = std::make_shared<const std::vector<uint32_t>>(std::move(Binary));
+            SPIRVData = *Owner;
+            SPIRVOwner = std::move(Owner);
+        }
+
+        // SPIR-V二进制，可能指向自己持有的数据，也可能直接指向内存映射的着色器包
+        std::span<const uint32_t> SPIRVData;
+        // 保证SPIRVData指向的内存有效，内容相同的二进制由FShaderManager去重，多个FShader共享同一份数据
+        std::shared_ptr<const void> SPIRVOwner;
+        std::uint64_t BinaryHash;
+        // 编译时通过#include引入的所有文件
+        std::vector<std::filesystem::path> Dependencies;
 
         // 这里使用位域，假定一个着色器的资源绑定点不会超过256个
         struct ShaderResourceDesc
@@ -68,18 +83,32 @@ namespace SilverBell::Renderer
             }
         };
 
+        // 推送常量范围
+        struct ShaderPushConstantDesc
+        {
+            uint32_t Offset;             // 起始偏移
+            uint32_t Size;               // 字节大小
+            uint32_t Stage;              // 资源被用到的着色器阶段
+        };
+
         struct
         {
             std::string Name;                                // 着色器名称
             uint8_t Stage;                                   // 着色器阶段
             std::vector<ShaderResourceDesc> Resources;       // 资源绑定信息
+            std::vector<ShaderPushConstantDesc> PushConstants; // 推送常量信息
             std::unordered_set<std::string> DefinedSymbols;  // 定义的宏
             std::vector<uint32_t> InputVariables;            // 输入变量
             std::vector<uint32_t> OutputVariables;           // 输出变量
+            uint32_t InstructionCount = 0;                   // DXC输出的SPIR-V指令数
+            uint32_t FinalInstructionCount = 0;              // 移除调试信息后最终使用的指令数
             // uint32_t LocalSizeX, LocalSizeY, LocalSizeZ;  // 计算着色器工作组大小
         } ReflectionInfo;
 
         friend class FShaderManager;
+        friend class FShaderDiskCache;
+        friend class FShaderArchive;
+        friend class FShaderArchiveWriter;
         friend class std::unique_ptr<FShader>;
     };
 }
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "RendererMarco.hh"
+#include "Shader.hh"
+
+#include "MappedFile.hh"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace SilverBell::Renderer
+{
+    /*
+     * 着色器包文件格式
+     * [文件头][按ShaderDesc哈希排序的索引][4字节对齐的SPIR-V与反射记录]
+     * 运行时整个文件被内存映射，SPIR-V直接从映射的内存传给vkCreateShaderModule，不做任何拷贝
+     */
+    struct ShaderArchiveHeader
+    {
+        std::uint32_t Magic;
+        std::uint32_t Version;
+        std::uint32_t EntryCount;
+        std::uint32_t Reserved;
+    };
+
+    struct ShaderArchiveEntry
+    {
+        std::uint64_t DescHash;          // ShaderDesc::GetHashValue()
+        std::uint64_t BinaryOffset;      // SPIR-V相对文件开头的偏移，4字节对齐
+        std::uint64_t BinarySize;        // SPIR-V字节数
+        std::uint64_t ReflectionOffset;  // 反射记录相对文件开头的偏移
+        std::uint64_t ReflectionSize;    // 反射记录字节数
+    };
+
+    // 离线生成着色器包
+    class RENDERER_API FShaderArchiveWriter
+    {
+    public:
+        // 添加一个编译好的着色器，同一个ShaderDesc只会保留一份
+        void Add(const FShader& Shader);
+
+        // 写入文件，失败时抛出异常
+        void Write(const std::filesystem::path& ArchivePath) const;
+
+        std::size_t GetEntryCount() const { return Records.size(); }
+
+    private:
+        struct Record
+        {
+            std::uint64_t DescHash;
+            std::vector<uint32_t> Binary;
+            std::vector<char> Reflection;
+        };
+        std::vector<Record> Records;
+    };
+
+    // 运行时读取内存映射的着色器包
+    class FShaderArchive
+    {
+    public:
+        // 打开失败或格式不合法时抛出异常
+        explicit FShaderArchive(const std::filesystem::path& ArchivePath);
+
+        static constexpr std::uint32_t ArchiveMagic = 0x41534253; // "SBSA"
+        static constexpr std::uint32_t ArchiveVersion = 1;
+
+        // 二分查找索引，找不到时返回空指针
+        const ShaderArchiveEntry* Find(std::uint64_t DescHash) const;
+
+        // 从着色器包中加载SPIR-V与反射信息，SPIR-V指向映射的内存，由oShader共同持有映射
+        bool Load(const ShaderArchiveEntry& Entry, FShader& oShader) const;
+
+        std::size_t GetEntryCount() const { return Entries.size(); }
+
+    private:
+        std::shared_ptr<Utility::FMappedFile> MappedFile;
+        std::span<const ShaderArchiveEntry> Entries;
+    };
+}
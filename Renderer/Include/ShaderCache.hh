@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Shader.hh"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace SilverBell::Renderer
+{
+    /*
+     * 着色器磁盘缓存
+     * 缓存文件以 ShaderDesc 哈希与编译参数哈希组合成的键命名，文件内记录源文件及所有被包含文件的内容哈希，
+     * 加载时逐一校验，任意一个文件发生变化都会导致缓存失效，从而在热启动时完全跳过DXC与SPIRV-Reflect
+     */
+    class FShaderDiskCache
+    {
+    public:
+        FShaderDiskCache() = delete;
+        ~FShaderDiskCache() = delete;
+
+        // 缓存格式版本，序列化内容变化时需要递增
+        static constexpr std::uint32_t CacheVersion = 3;
+
+        // 尝试从磁盘加载着色器，缓存不存在或已经失效时返回false
+        static bool Load(const std::filesystem::path& CacheDirectory, std::uint64_t CacheKey, std::uint64_t SourceHash, FShader& oShader);
+
+        // 将编译好的着色器写入磁盘
+        static void Store(const std::filesystem::path& CacheDirectory, std::uint64_t CacheKey, std::uint64_t SourceHash, const FShader& Shader);
+
+        // 序列化SPIR-V与反射信息
+        static void Serialize(const FShader& Shader, std::vector<char>& oBuffer);
+
+        // 反序列化SPIR-V与反射信息，数据损坏时返回false
+        static bool Deserialize(std::span<const char> Buffer, FShader& oShader);
+
+        // 只序列化反射信息，着色器包中的SPIR-V单独存放
+        static void SerializeReflection(const FShader& Shader, std::vector<char>& oBuffer);
+
+        static bool DeserializeReflection(std::span<const char> Buffer, FShader& oShader);
+    };
+}
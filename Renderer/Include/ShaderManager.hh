@@ -1,30 +1,169 @@
 #pragma once
 
+#include "FileWatcher.hh"
 #include "Mixins.hh"
+#include "RendererMarco.hh"
 #include "Shader.hh"
+#include "ShaderArchive.hh"
+#include "ShaderStats.hh"
 
 #include <Volk/volk.h>
 
+#include <array>
+#include <functional>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace SilverBell::Renderer
 {
-    class FShaderManager : public NonCopyable
+    // 由着色器反射信息合并生成的管线布局
+    struct PipelineLayoutInfo
+    {
+        VkDevice LogicDevice = VK_NULL_HANDLE;
+        VkPipelineLayout PipelineLayout = VK_NULL_HANDLE;
+        // 按set编号索引，中间缺失的set会填充空布局
+        std::vector<VkDescriptorSetLayout> SetLayouts;
+        // 每个set合并了所有阶段之后的绑定信息，可用于计算描述符池大小
+        std::vector<std::vector<VkDescriptorSetLayoutBinding>> SetBindings;
+        std::vector<VkPushConstantRange> PushConstantRanges;
+    };
+
+    class RENDERER_API FShaderManager : public NonCopyable
     {
     public:
         static FShaderManager& Instance();
 
-        VkShaderModule CreateShaderModule(const ShaderDesc& Desc, VkDevice LogicDevice);
+        // 获取着色器模块并增加引用计数，二进制相同的着色器在同一个设备上共享同一个模块
+        VkShaderModule AcquireShaderModule(const ShaderDesc& Desc, VkDevice LogicDevice);
+
+        // 减少引用计数，计数归零的模块不会立即销毁，重建管线时可以直接复用
+        void ReleaseShaderModule(VkShaderModule ShaderModule);
 
+        // 销毁指定设备上引用计数为零的着色器模块
+        void PurgeUnusedShaderModules(VkDevice LogicDevice);
+
+        // 线程安全，同一个ShaderDesc被多个线程同时请求时只会编译一次，其余线程等待编译结果
         const FShader& GetOrCreateShader(const ShaderDesc& Desc);
 
+        // 在线程池上并行编译一批着色器，每个工作线程使用独立的DXC编译器实例
+        // OnCompleted 在工作线程上调用，编译失败时不会调用，异常通过对应的future抛出
+        std::vector<std::future<const FShader*>> CompileAsync(std::span<const ShaderDesc> Descs,
+            std::function<void(const FShader&)> OnCompleted = {});
+
+        // 合并所有阶段的反射信息，生成描述符集布局与管线布局，相同的布局只会创建一次
+        const PipelineLayoutInfo& GetOrCreatePipelineLayout(std::span<const ShaderDesc> Descs, VkDevice LogicDevice);
+
+        VkDescriptorSetLayout GetOrCreateDescriptorSetLayout(std::span<const VkDescriptorSetLayoutBinding> Bindings, VkDevice LogicDevice);
+
+        // 销毁指定设备上缓存的Vulkan对象，需要在vkDestroyDevice之前调用
+        void DestroyDeviceResources(VkDevice LogicDevice);
+
+        // 挂载离线生成的着色器包，之后包内已有的着色器直接从内存映射中加载，不再读取源文件或调用DXC
+        void MountArchive(const std::filesystem::path& ArchivePath);
+
+        // 统计数据快照，可以在任意线程调用
+        ShaderStatsSnapshot GetStats() const;
+
+        // 将统计数据以JSON格式写入文件
+        void DumpStats(const std::filesystem::path& FilePath) const;
+
+        // 开启着色器热重载，监视所有着色器的源文件及其通过#include引入的文件，文件变化时在后台重新编译受影响的着色器
+        void EnableHotReload();
+
+        // 停止并等待监视线程，再等待已提交的重新编译全部结束
+        // 线程池与本对象都是函数内静态对象，析构顺序不确定，需要在程序退出前显式调用
+        void DisableHotReload();
+
+        // 在帧边界调用，把后台重新编译完成的着色器替换进缓存，返回被替换的ShaderDesc
+        // 被替换下来的旧着色器会保留到下一次调用，调用者需要在此之前用新的着色器重建相关的管线
+        std::vector<ShaderDesc> ConsumeReloadedShaders();
+
     private:
         FShaderManager() = default;
         ~FShaderManager() = default;
 
+        std::unique_ptr<FShader> CompileShader(const ShaderDesc& Desc);
+
         void ReflectShader(FShader& oShader);
 
-        std::unordered_map<uint64_t, std::unique_ptr<FShader>> ShaderCache;
+        // 计算二进制哈希，内容相同的SPIR-V只保留一份，由所有排列共享
+        void ShareBinary(FShader& oShader);
+
+        // 记录着色器依赖的文件，开启热重载时同时开始监视这些文件
+        void TrackDependencies(const FShader& Shader);
+
+        void OnFilesChanged(const std::vector<std::filesystem::path>& ChangedFiles);
+
+        void RecordShaderLoad(const FShader& Shader, std::string Source, std::uint64_t TotalMicroseconds,
+            std::uint64_t CompileMicroseconds, std::uint64_t ReflectMicroseconds);
+
+        FShaderStats Stats;
+
+        // 着色器缓存按哈希分片，降低并行编译时的锁竞争，编译过程本身不持有锁
+        // 缓存中存放的是编译结果的future，正在编译中的着色器也能被其他线程等待
+        static constexpr std::size_t ShaderCacheShardCount = 16;
+        struct ShaderCacheShard
+        {
+            std::shared_mutex Mutex;
+            std::unordered_map<uint64_t, std::shared_future<std::unique_ptr<FShader>>> Shaders;
+        };
+        std::array<ShaderCacheShard, ShaderCacheShardCount> ShaderCache;
+
+        // 按二进制哈希索引的SPIR-V数据
+        struct SharedBinary
+        {
+            std::span<const uint32_t> Binary;
+            std::shared_ptr<const void> Owner;
+        };
+        std::unordered_map<uint64_t, SharedBinary> BinaryCache;
+        std::mutex BinaryCacheMutex;
+
+        std::shared_ptr<const FShaderArchive> MountedArchive;
+        std::mutex ArchiveMutex;
+
+        // 热重载相关的状态，由HotReloadMutex保护
+        std::mutex HotReloadMutex;
+        std::unique_ptr<Utility::FFileWatcher> FileWatcher;
+        // 文件的绝对路径到依赖它的着色器的映射
+        std::map<std::filesystem::path, std::unordered_set<uint64_t>> DependentShaders;
+        std::unordered_map<uint64_t, ShaderDesc> TrackedDescs;
+        // 已提交到线程池的重新编译任务
+        std::vector<std::future<void>> PendingReloads;
+        // 后台重新编译完成、等待在帧边界替换的着色器
+        std::vector<std::unique_ptr<FShader>> ReloadedShaders;
+        // 上一次替换下来的着色器
+        std::vector<std::shared_future<std::unique_ptr<FShader>>> RetiredShaders;
+
+        // 保护下面的Vulkan对象缓存
+        std::mutex DeviceResourceMutex;
+
+        struct DescriptorSetLayoutEntry
+        {
+            VkDevice LogicDevice = VK_NULL_HANDLE;
+            VkDescriptorSetLayout Layout = VK_NULL_HANDLE;
+        };
+        std::unordered_map<uint64_t, DescriptorSetLayoutEntry> DescriptorSetLayoutCache;
+
+        std::unordered_map<uint64_t, PipelineLayoutInfo> PipelineLayoutCache;
+
+        struct ShaderModuleEntry
+        {
+            VkDevice LogicDevice = VK_NULL_HANDLE;
+            VkShaderModule Module = VK_NULL_HANDLE;
+            uint32_t RefCount = 0;
+            // 持有二进制的内存，保证作为键的地址在条目存在期间不会被其他二进制复用
+            std::shared_ptr<const void> BinaryOwner;
+        };
+        // 以共享后的二进制地址与设备作为键，哈希碰撞而未共享的二进制地址不同，不会拿到彼此的模块
+        using ShaderModuleKey = std::pair<const uint32_t*, VkDevice>;
+        std::map<ShaderModuleKey, ShaderModuleEntry> ShaderModuleCache;
+        // 模块句柄到缓存键的反向索引，用于释放
+        std::unordered_map<VkShaderModule, ShaderModuleKey> ShaderModuleKeys;
     };
 }
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "RendererMarco.hh"
+#include "Shader.hh"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace SilverBell::Renderer
+{
+    /*
+     * 着色器关键字轴
+     * 一个轴上的关键字互斥，每个排列从每个轴上恰好选择一个关键字，空字符串表示该轴不定义任何宏
+     * 关键字可以写成 NAME 或 NAME=VALUE 的形式，会原样作为 -D 参数传给DXC
+     */
+    struct ShaderKeywordAxis
+    {
+        std::vector<std::string> Keywords;
+
+        // 开关型关键字，生成 {未定义, Keyword} 两个取值
+        static ShaderKeywordAxis Toggle(std::string Keyword)
+        {
+            return { { std::string(), std::move(Keyword) } };
+        }
+    };
+
+    /*
+     * 着色器排列集合
+     * 在基础ShaderDesc上声明若干关键字轴，通过混合进制编号枚举所有关键字组合，
+     * 展开得到的ShaderDesc::Defines按轴的顺序排列，相同的关键字组合总是得到相同的哈希
+     */
+    class RENDERER_API FShaderPermutationSet
+    {
+    public:
+        FShaderPermutationSet(ShaderDesc iBaseDesc, std::vector<ShaderKeywordAxis> iAxes);
+
+        // 所有轴取值数量的乘积
+        std::size_t GetPermutationCount() const;
+
+        // 按编号取得一个排列，编号的第一个轴变化最快
+        ShaderDesc GetPermutation(std::size_t Index) const;
+
+        // 根据启用的关键字选择排列，每个轴取第一个被启用的关键字，都未启用时取该轴的第一个关键字
+        ShaderDesc Select(std::span<const std::string> EnabledKeywords) const;
+
+        // 展开所有排列，Filter返回false的排列会被跳过，用于剔除实际不会用到的组合
+        template<typename Func>
+        std::vector<ShaderDesc> Expand(Func&& Filter) const
+        {
+            std::vector<ShaderDesc> Result;
+            const std::size_t Count = GetPermutationCount();
+            Result.reserve(Count);
+            for (std::size_t Idx = 0; Idx < Count; ++Idx)
+            {
+                ShaderDesc Desc = GetPermutation(Idx);
+                if (Filter(static_cast<const ShaderDesc&>(Desc)))
+                {
+                    Result.push_back(std::move(Desc));
+                }
+            }
+            return Result;
+        }
+
+        std::vector<ShaderDesc> Expand() const
+        {
+            return Expand([](const ShaderDesc&) { return true; });
+        }
+
+        const ShaderDesc& GetBaseDesc() const { return BaseDesc; }
+
+        const std::vector<ShaderKeywordAxis>& GetAxes() const { return Axes; }
+
+        // 取得关键字中的宏名部分，即 NAME=VALUE 中的 NAME
+        static std::string_view GetDefineName(std::string_view Keyword);
+
+    private:
+        ShaderDesc BaseDesc;
+        std::vector<ShaderKeywordAxis> Axes;
+    };
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <ylt/reflection/member_value.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SilverBell::Renderer
+{
+    // 耗时直方图的快照，第i个桶统计耗时落在[2^i, 2^(i+1))微秒内的样本数，第0个桶同时包含0微秒
+    struct ShaderTimingSnapshot
+    {
+        std::uint64_t Count = 0;
+        std::uint64_t TotalMicroseconds = 0;
+        std::uint64_t MaxMicroseconds = 0;
+        std::vector<std::uint64_t> Buckets;
+    };
+    YLT_REFL(ShaderTimingSnapshot, Count, TotalMicroseconds, MaxMicroseconds, Buckets)
+
+    // 单个着色器的加载记录
+    struct ShaderLoadRecord
+    {
+        std::string Name;                       // 文件名-入口点
+        std::vector<std::string> Defines;       // 排列关键字
+        std::string Source;                     // 来源：DXC、DiskCache 或 Archive
+        std::uint64_t CompileMicroseconds = 0;  // DXC编译耗时，非DXC来源时为0
+        std::uint64_t ReflectMicroseconds = 0;  // 反射耗时，非DXC来源时为0
+        std::uint64_t TotalMicroseconds = 0;    // 包含读取文件与缓存在内的总耗时
+        std::uint64_t SPIRVBytes = 0;           // 最终使用的SPIR-V大小
+    };
+    YLT_REFL(ShaderLoadRecord, Name, Defines, Source, CompileMicroseconds, ReflectMicroseconds, TotalMicroseconds, SPIRVBytes)
+
+    struct ShaderStatsSnapshot
+    {
+        std::uint64_t MemoryCacheHits = 0;
+        std::uint64_t MemoryCacheMisses = 0;
+        std::uint64_t DiskCacheHits = 0;
+        std::uint64_t DiskCacheMisses = 0;
+        std::uint64_t ArchiveHits = 0;
+        std::uint64_t CompileFailures = 0;
+        std::uint64_t ModuleCacheHits = 0;
+        std::uint64_t ModulesCreated = 0;
+        std::uint64_t TotalSPIRVBytes = 0;
+        ShaderTimingSnapshot CompileTime;
+        ShaderTimingSnapshot ReflectTime;
+        ShaderTimingSnapshot ModuleCreationTime;
+        std::vector<ShaderLoadRecord> Shaders;
+    };
+    YLT_REFL(ShaderStatsSnapshot, MemoryCacheHits, MemoryCacheMisses, DiskCacheHits, DiskCacheMisses, ArchiveHits, CompileFailures,
+        ModuleCacheHits, ModulesCreated, TotalSPIRVBytes, CompileTime, ReflectTime, ModuleCreationTime, Shaders)
+
+    // 以2为底的对数耗时直方图，只使用原子操作，可以在多个编译线程上同时记录
+    class FTimingHistogram
+    {
+    public:
+        static constexpr std::size_t BucketCount = 32;
+
+        void Record(std::uint64_t Microseconds);
+
+        ShaderTimingSnapshot GetSnapshot() const;
+
+    private:
+        std::array<std::atomic<std::uint64_t>, BucketCount> Buckets = {};
+        std::atomic<std::uint64_t> Count = 0;
+        std::atomic<std::uint64_t> TotalMicroseconds = 0;
+        std::atomic<std::uint64_t> MaxMicroseconds = 0;
+    };
+
+    // 着色器管理器的统计数据，计数器都是原子的，每个着色器的加载记录由互斥锁保护
+    class FShaderStats
+    {
+    public:
+        std::atomic<std::uint64_t> MemoryCacheHits = 0;
+        std::atomic<std::uint64_t> MemoryCacheMisses = 0;
+        std::atomic<std::uint64_t> DiskCacheHits = 0;
+        std::atomic<std::uint64_t> DiskCacheMisses = 0;
+        std::atomic<std::uint64_t> ArchiveHits = 0;
+        std::atomic<std::uint64_t> CompileFailures = 0;
+        std::atomic<std::uint64_t> ModuleCacheHits = 0;
+        std::atomic<std::uint64_t> ModulesCreated = 0;
+
+        FTimingHistogram CompileTime;
+        FTimingHistogram ReflectTime;
+        FTimingHistogram ModuleCreationTime;
+
+        void AddRecord(ShaderLoadRecord Record);
+
+        ShaderStatsSnapshot GetSnapshot() const;
+
+    private:
+        mutable std::mutex RecordMutex;
+        std::vector<ShaderLoadRecord> Records;
+    };
+}
@@ -2,12 +2,18 @@
 
 #include "RendererMarco.hh"
 
+#include <memory>
 #include <optional>
+#include <string_view>
 #include <vector>
 
 #include <Volk/volk.h>
 #include <vma/vk_mem_alloc.h>
 
+#include "AssetLoader.hh"
+#include "AssetRegistry.hh"
+#include "GeometryArena.hh"
+#include "MipGenerator.hh"
 #include "Mixins.hh"
 #include "RenderResource.hh"
 
@@ -77,22 +83,24 @@ namespace SilverBell::Renderer
 
         void CreateTextureImage();
 
-        void CreateTextureImageView();
-
         void CreateTextureSampler();
 
         void CreateVertexBuffers();
 
-        void CreateIndexBuffer();
-
         void CreateConstantBuffer();
 
         void UpdateBuffer(const double Time);
 
+        // 设置相机位置与注视点，下一帧的常量缓冲、LOD选择与加载优先级随之更新
+        void SetCamera(const Math::Vec3& Eye, const Math::Vec3& Target);
+
         void CreateDescriptorPool();
 
         void CreateDescriptorSet();
 
+        // 按反射得到的绑定类型写入常量缓冲与当前纹理，bImagesOnly时只更新纹理相关的绑定
+        void WriteDescriptorSet(bool bImagesOnly);
+
         void CreateCommandBuffers();
 
         void CreateSemaphores();
@@ -101,8 +109,67 @@ namespace SilverBell::Renderer
 
     private:
 
+        // 模型与它在几何缓冲区中的顶点与索引范围
+        struct MeshResource
+        {
+            std::unique_ptr<Model> Data;
+            std::vector<GeometryAllocation> VertexAllocations;
+            GeometryAllocation IndexAllocation;
+            // 索引宽度，顶点数不超过65536时使用16位索引
+            VkIndexType IndexType = VK_INDEX_TYPE_UINT32;
+        };
+
+        struct TextureResource
+        {
+            VMAImageCache Image;
+            VkImageView View = VK_NULL_HANDLE;
+        };
+
+        // 尚未开始加载的请求与资产在模型空间中的位置，每帧按模型变换换算到世界空间后用相机距离调整优先级
+        struct PendingAssetLoad
+        {
+            Utility::FAssetLoader::RequestId Id;
+            Math::Vec3 LocalPosition;
+        };
+
         void CleanupSwapChain();
 
+        // 在帧边界应用后台重新编译完成的着色器，重建使用它们的管线
+        void ApplyShaderReloads();
+
+        // 在帧边界按当前相机更新等待中请求的优先级，并执行后台加载完成的资产的上传回调，每帧数量有上限
+        void ApplyAssetLoads();
+
+        // 已注册的纹理直接引用，正在加载时等待同一次加载，否则在后台加载，完成后上传并替换当前纹理
+        void RequestTexture(std::string_view Path);
+
+        // 已注册的模型直接引用，正在加载时等待同一次加载，否则在后台加载，完成后上传并替换当前模型
+        void RequestModel(std::string_view Path);
+
+        /*
+         * 上传mip链，Pixels中各级按TextureFormat紧密排列，转换为着色器只读布局并创建视图
+         * 只提供了前几级时其余级别在GPU上逐级blit生成，格式不支持线性过滤的blit(如BC格式)时只保留提供的级别
+         */
+        std::unique_ptr<TextureResource> UploadTexture(VkFormat TextureFormat, std::span<const unsigned char> Pixels, std::span<const Assets::MipLevel> Levels);
+
+        // 把模型的顶点流与索引写入几何缓冲区
+        std::unique_ptr<MeshResource> UploadMesh(std::unique_ptr<Model> NewModel);
+
+        // 更新描述符为新纹理，旧纹理的引用延迟到GPU不再使用时释放
+        void SetTexture(Assets::AssetHandle<TextureResource> NewTexture);
+
+        // 切换为新模型并重新录制命令缓冲，旧模型的引用延迟到GPU不再使用时释放
+        void SetModel(Assets::AssetHandle<MeshResource> NewMesh);
+
+        // 按当前相机与模型变换计算资产的加载优先级
+        float ComputeLoadPriority(const Math::Vec3& LocalPosition) const;
+
+        // 按当前相机与模型变换下的屏幕空间误差选择模型的LOD层级
+        std::size_t SelectLODLevel(const MeshResource& Mesh) const;
+
+        // 在帧边界重新选择LOD，与命令缓冲中录制的层级不同时重新录制
+        void UpdateLOD();
+
         bool IsDeviceSuitable(VkPhysicalDevice Device);
 
         bool CheckValidationLayerSupport();
@@ -124,11 +191,23 @@ namespace SilverBell::Renderer
         {
             CopyBuffer(std::vector{ SrcBuffer }, std::vector{ DstBuffer });
         }
-        void CopyBufferToImage(const VMABufferCache& Buffer, const VMAImageCache& Image) const;
+        void CopyBufferToArena(const VMABufferCache& SrcBuffer, const GeometryAllocation& DstAllocation);
+
+        // 每级mip一个复制区域，Levels中的偏移即暂存缓冲中的偏移
+        void CopyBufferToImage(const VMABufferCache& Buffer, const VMAImageCache& Image, std::span<const Assets::MipLevel> Levels) const;
+
+        void TransitionImageLayout(VkImage Image, VkFormat Format, VkImageLayout OldLayout, VkImageLayout NewLayout, uint32_t MipLevels = 1) const;
+
+        /*
+         * 由前FilledLevelCount级用vkCmdBlitImage逐级生成其余级别，调用前所有级别处于TRANSFER_DST布局，完成后全部处于着色器只读布局
+         * blit在sRGB格式的图像上先解码到线性空间再过滤，UNORM格式直接平均存储值，只适用于法线与数据纹理
+         */
+        void GenerateMipmaps(const VMAImageCache& Image, uint32_t FilledLevelCount) const;
 
-        void TransitionImageLayout(VkImage Image, VkFormat Format, VkImageLayout OldLayout, VkImageLayout NewLayout) const;
+        // 最优排布下是否支持以线性过滤blit，GPU生成mip需要
+        bool SupportsLinearBlit(VkFormat Format) const;
 
-        VkImageView CreateImageView(VkImage Image, VkFormat Format, VkImageAspectFlags AspectFlags) const;
+        VkImageView CreateImageView(VkImage Image, VkFormat Format, VkImageAspectFlags AspectFlags, uint32_t MipLevels = 1) const;
 
         VkFormat FindSupportedFormat(const std::vector<VkFormat>& Candidates, VkImageTiling Tiling, VkFormatFeatureFlags Features);
 
@@ -176,7 +255,7 @@ namespace SilverBell::Renderer
         VkRenderPass RenderPass;
         // Vulkan交换链帧缓冲
         std::vector<VkFramebuffer> SwapChainFramebuffers;
-        // Vulkan着色器模块
+        // 当前管线持有引用的着色器模块，由着色器管理器缓存
         std::vector<VkShaderModule> ShaderModules;
         // 描述符集布局
         VkDescriptorSetLayout DescriptorSetLayout;
@@ -198,16 +277,10 @@ namespace SilverBell::Renderer
         VkSemaphore RenderFinishedSemaphore;
         // 顶点临时缓冲
         std::vector<VMABufferCache> StagingBufferCaches;
-        // 顶点缓冲
-        std::vector<VMABufferCache> VertexBufferCaches;
-        // 顶点索引缓冲
-        std::vector<VMABufferCache> IndexBufferCaches;
+        // 顶点与索引共用的几何缓冲区
+        std::unique_ptr<FGeometryArena> GeometryArena;
         // 常量缓冲区
         std::vector<VMABufferCache> ConstantBufferCaches;
-        // 纹理图像
-        VMAImageCache TextureImageCache;
-        // 纹理图像视图
-        VkImageView TextureImageView;
         // 纹理采样器
         VkSampler TextureSampler;
         // 深度图像
@@ -218,8 +291,27 @@ namespace SilverBell::Renderer
         // VMA内存分配
         VmaAllocator MemoryAllocator;
 
-        // 模型
-        Model* LoadedModel = nullptr;
+        // 相机位置与注视点
+        Math::Vec3 CameraEye = Math::Vec3(2.0f, 2.0f, 2.0f);
+        Math::Vec3 CameraTarget = Math::Vec3::Zero();
+
+        // 后台资产加载，加载完成前使用占位资源(1x1白色纹理，模型不绘制)
+        // 取消的请求以空结果执行完成回调，注册表中的加载随之以失败结束
+        std::unique_ptr<Utility::FAssetLoader> AssetLoader;
+        std::vector<PendingAssetLoad> PendingAssetLoads;
+
+        // 按路径去重的GPU资产，引用计数归零后等所在帧执行完毕再销毁
+        Assets::FAssetRegistry<MeshResource> Meshes;
+        Assets::FAssetRegistry<TextureResource> Textures;
+        // 当前绘制的模型与绑定的纹理
+        Assets::AssetHandle<MeshResource> CurrentMesh;
+        Assets::AssetHandle<TextureResource> CurrentTexture;
+        // 命令缓冲中录制的当前模型的LOD层级
+        std::size_t RecordedLODLevel = 0;
+        // 已提交的帧数，用于判断被释放的资产何时可以销毁
+        std::uint64_t FrameIndex = 0;
+        // 设备支持BC块压缩时纹理烘焙为BC格式，否则为RGBA8
+        bool bTextureCompressionBC = false;
     };
 }
 
@@ -0,0 +1,118 @@
+#include "GeometryArena.hh"
+
+#include "Logger.hh"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+using namespace SilverBell::Renderer;
+
+FGeometryArena::FGeometryArena(VmaAllocator InMemoryAllocator, VkDeviceSize InPageSize)
+    : MemoryAllocator(InMemoryAllocator)
+    , PageSize(InPageSize)
+{
+}
+
+FGeometryArena::~FGeometryArena()
+{
+    Destroy();
+}
+
+GeometryAllocation FGeometryArena::Allocate(VkDeviceSize Size, VkDeviceSize Alignment)
+{
+    Alignment = std::max<VkDeviceSize>(Alignment, 1);
+
+    // VMA只接受2的幂对齐，其他对齐多申请Alignment - 1字节，再把偏移上调到Alignment的倍数
+    const bool bPowerOfTwo = std::has_single_bit(Alignment);
+    VmaVirtualAllocationCreateInfo AllocCreateInfo = {};
+    AllocCreateInfo.size = bPowerOfTwo ? Size : Size + Alignment - 1;
+    AllocCreateInfo.alignment = bPowerOfTwo ? Alignment : 1;
+
+    auto TryAllocate = [&](uint32_t PageIndex) -> GeometryAllocation
+    {
+        GeometryAllocation Allocation;
+        VkDeviceSize Offset = 0;
+        if (vmaVirtualAllocate(Pages[PageIndex].Block, &AllocCreateInfo, &Allocation.Handle, &Offset) != VK_SUCCESS)
+        {
+            return {};
+        }
+        Allocation.PageIndex = PageIndex;
+        Allocation.Offset = (Offset + Alignment - 1) / Alignment * Alignment;
+        Allocation.Size = Size;
+        return Allocation;
+    };
+
+    for (uint32_t PageIndex = 0; PageIndex < Pages.size(); ++PageIndex)
+    {
+        if (GeometryAllocation Allocation = TryAllocate(PageIndex); Allocation.IsValid())
+        {
+            return Allocation;
+        }
+    }
+
+    GeometryAllocation Allocation = TryAllocate(CreatePage(std::max(PageSize, AllocCreateInfo.size)));
+    if (!Allocation.IsValid())
+    {
+        LOG_ERROR("几何缓冲区分配失败，大小: {}，对齐: {}", Size, Alignment);
+        throw std::runtime_error("Failed to allocate geometry range!");
+    }
+    return Allocation;
+}
+
+void FGeometryArena::Free(GeometryAllocation& Allocation)
+{
+    if (!Allocation.IsValid()) return;
+
+    // 空页保留下来供后续分配，只在Destroy时释放
+    vmaVirtualFree(Pages[Allocation.PageIndex].Block, Allocation.Handle);
+    Allocation = {};
+}
+
+GeometryArenaStatistics FGeometryArena::GetStatistics() const
+{
+    GeometryArenaStatistics Result;
+    Result.PageCount = Pages.size();
+    for (const Page& CurrentPage : Pages)
+    {
+        VmaStatistics Statistics = {};
+        vmaGetVirtualBlockStatistics(CurrentPage.Block, &Statistics);
+        Result.AllocationCount += Statistics.allocationCount;
+        Result.UsedBytes += Statistics.allocationBytes;
+        Result.ReservedBytes += Statistics.blockBytes;
+    }
+    return Result;
+}
+
+void FGeometryArena::Destroy()
+{
+    for (Page& CurrentPage : Pages)
+    {
+        // 未释放的范围随整页一起回收
+        vmaClearVirtualBlock(CurrentPage.Block);
+        vmaDestroyVirtualBlock(CurrentPage.Block);
+        vmaDestroyBuffer(MemoryAllocator, CurrentPage.Buffer.BufferHandle, CurrentPage.Buffer.Allocation);
+    }
+    Pages.clear();
+}
+
+uint32_t FGeometryArena::CreatePage(VkDeviceSize Size)
+{
+    Page NewPage;
+    NewPage.Buffer = CreateBufferPack(Size, MemoryAllocator,
+        static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT),
+        VMA_MEMORY_USAGE_GPU_ONLY, 0)[0];
+
+    VmaVirtualBlockCreateInfo BlockCreateInfo = {};
+    BlockCreateInfo.size = Size;
+    if (vmaCreateVirtualBlock(&BlockCreateInfo, &NewPage.Block) != VK_SUCCESS)
+    {
+        vmaDestroyBuffer(MemoryAllocator, NewPage.Buffer.BufferHandle, NewPage.Buffer.Allocation);
+        LOG_ERROR("创建几何缓冲区虚拟块失败！");
+        throw std::runtime_error("Failed to create geometry virtual block!");
+    }
+
+    LOG_DEBUG("创建几何缓冲区页: {}，大小: {}", Pages.size(), Size);
+    Pages.push_back(NewPage);
+    return static_cast<uint32_t>(Pages.size() - 1);
+}
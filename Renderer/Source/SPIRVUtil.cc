@@ -0,0 +1,127 @@
+#include "SPIRVUtil.hh"
+
+#include "Logger.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+using namespace SilverBell::Renderer;
+
+namespace
+{
+    constexpr std::uint32_t SPIRVMagic = 0x07230203;
+    constexpr std::size_t SPIRVHeaderWordCount = 5;
+
+    // 用到的SPIR-V操作码
+    enum ESPIRVOp : std::uint16_t
+    {
+        OpSourceContinued = 2,
+        OpSource = 3,
+        OpSourceExtension = 4,
+        OpName = 5,
+        OpMemberName = 6,
+        OpString = 7,
+        OpLine = 8,
+        OpExtension = 10,
+        OpExtInstImport = 11,
+        OpExtInst = 12,
+        OpNoLine = 317,
+        OpModuleProcessed = 330,
+    };
+
+    bool IsValidHeader(std::span<const std::uint32_t> Binary)
+    {
+        return Binary.size() >= SPIRVHeaderWordCount && Binary[0] == SPIRVMagic;
+    }
+
+    // 遍历所有指令，字数为0或越界时返回false
+    template<typename Func>
+    bool ForEachInstruction(std::span<const std::uint32_t> Binary, Func&& Visitor)
+    {
+        for (std::size_t Offset = SPIRVHeaderWordCount; Offset < Binary.size();)
+        {
+            const std::uint32_t WordCount = Binary[Offset] >> 16;
+            if (WordCount == 0 || Offset + WordCount > Binary.size()) return false;
+            Visitor(static_cast<std::uint16_t>(Binary[Offset] & 0xFFFF), Binary.subspan(Offset, WordCount));
+            Offset += WordCount;
+        }
+        return true;
+    }
+
+    // 指令中从WordIndex开始的字面量字符串
+    std::string_view GetLiteralString(std::span<const std::uint32_t> Instruction, std::size_t WordIndex)
+    {
+        if (WordIndex >= Instruction.size()) return {};
+        const auto* Chars = reinterpret_cast<const char*>(Instruction.data() + WordIndex);
+        const std::size_t MaxLength = (Instruction.size() - WordIndex) * sizeof(std::uint32_t);
+        return { Chars, strnlen(Chars, MaxLength) };
+    }
+}
+
+std::uint32_t FSPIRVUtil::CountInstructions(std::span<const std::uint32_t> Binary)
+{
+    if (!IsValidHeader(Binary)) return 0;
+
+    std::uint32_t Count = 0;
+    const bool bValid = ForEachInstruction(Binary, [&Count](std::uint16_t, std::span<const std::uint32_t>) { ++Count; });
+    return bValid ? Count : 0;
+}
+
+std::vector<std::uint32_t> FSPIRVUtil::StripDebugInfo(std::span<const std::uint32_t> Binary)
+{
+    if (!IsValidHeader(Binary))
+    {
+        LOG_ERROR("SPIR-V二进制格式不合法，无法移除调试信息");
+        throw std::runtime_error("Invalid SPIR-V binary!");
+    }
+
+    // 先找出所有NonSemantic扩展指令集，它们的指令可以整体移除
+    std::vector<std::uint32_t> NonSemanticSets;
+    ForEachInstruction(Binary, [&NonSemanticSets](std::uint16_t Op, std::span<const std::uint32_t> Instruction)
+    {
+        if (Op == OpExtInstImport && GetLiteralString(Instruction, 2).starts_with("NonSemantic."))
+        {
+            NonSemanticSets.push_back(Instruction[1]);
+        }
+    });
+
+    std::vector<std::uint32_t> Result(Binary.begin(), Binary.begin() + SPIRVHeaderWordCount);
+    Result.reserve(Binary.size());
+    const bool bValid = ForEachInstruction(Binary, [&Result, &NonSemanticSets](std::uint16_t Op, std::span<const std::uint32_t> Instruction)
+    {
+        switch (Op)
+        {
+        case OpSourceContinued:
+        case OpSource:
+        case OpSourceExtension:
+        case OpName:
+        case OpMemberName:
+        case OpString:
+        case OpLine:
+        case OpNoLine:
+        case OpModuleProcessed:
+            return;
+        case OpExtension:
+            if (!NonSemanticSets.empty() && GetLiteralString(Instruction, 1) == "SPV_KHR_non_semantic_info") return;
+            break;
+        case OpExtInstImport:
+            if (std::ranges::find(NonSemanticSets, Instruction[1]) != NonSemanticSets.end()) return;
+            break;
+        case OpExtInst:
+            if (Instruction.size() > 3 && std::ranges::find(NonSemanticSets, Instruction[3]) != NonSemanticSets.end()) return;
+            break;
+        default:
+            break;
+        }
+        Result.insert(Result.end(), Instruction.begin(), Instruction.end());
+    });
+
+    if (!bValid)
+    {
+        LOG_ERROR("SPIR-V指令流已损坏，无法移除调试信息");
+        throw std::runtime_error("Corrupted SPIR-V instruction stream!");
+    }
+    return Result;
+}
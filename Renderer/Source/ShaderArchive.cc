@@ -0,0 +1,137 @@
+#include "ShaderArchive.hh"
+
+#include "Logger.hh"
+#include "ShaderCache.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace SilverBell::Renderer;
+
+namespace
+{
+    constexpr std::uint64_t AlignUp(std::uint64_t Value, std::uint64_t Alignment)
+    {
+        return (Value + Alignment - 1) / Alignment * Alignment;
+    }
+}
+
+void FShaderArchiveWriter::Add(const FShader& Shader)
+{
+    const std::uint64_t DescHash = Shader.Desc.GetHashValue();
+    if (std::ranges::any_of(Records, [DescHash](const Record& Other) { return Other.DescHash == DescHash; }))
+    {
+        return;
+    }
+
+    Record NewRecord;
+    NewRecord.DescHash = DescHash;
+    NewRecord.Binary.assign(Shader.GetBinary().begin(), Shader.GetBinary().end());
+    FShaderDiskCache::SerializeReflection(Shader, NewRecord.Reflection);
+    Records.push_back(std::move(NewRecord));
+}
+
+void FShaderArchiveWriter::Write(const std::filesystem::path& ArchivePath) const
+{
+    std::vector<const Record*> SortedRecords;
+    SortedRecords.reserve(Records.size());
+    for (const auto& Item : Records) SortedRecords.push_back(&Item);
+    std::ranges::sort(SortedRecords, {}, &Record::DescHash);
+
+    // 先计算布局，再按顺序写出
+    std::vector<ShaderArchiveEntry> Entries(SortedRecords.size());
+    std::uint64_t Offset = sizeof(ShaderArchiveHeader) + Entries.size() * sizeof(ShaderArchiveEntry);
+    for (std::size_t Idx = 0; Idx < SortedRecords.size(); ++Idx)
+    {
+        const auto& Item = *SortedRecords[Idx];
+        auto& Entry = Entries[Idx];
+        Entry.DescHash = Item.DescHash;
+        Entry.BinaryOffset = AlignUp(Offset, alignof(std::uint32_t));
+        Entry.BinarySize = Item.Binary.size() * sizeof(std::uint32_t);
+        Entry.ReflectionOffset = Entry.BinaryOffset + Entry.BinarySize;
+        Entry.ReflectionSize = Item.Reflection.size();
+        Offset = Entry.ReflectionOffset + Entry.ReflectionSize;
+    }
+
+    std::vector<char> Buffer(Offset, 0);
+    const ShaderArchiveHeader Header =
+    {
+        .Magic = FShaderArchive::ArchiveMagic,
+        .Version = FShaderArchive::ArchiveVersion,
+        .EntryCount = static_cast<std::uint32_t>(Entries.size()),
+        .Reserved = 0
+    };
+    std::memcpy(Buffer.data(), &Header, sizeof(Header));
+    std::memcpy(Buffer.data() + sizeof(Header), Entries.data(), Entries.size() * sizeof(ShaderArchiveEntry));
+    for (std::size_t Idx = 0; Idx < SortedRecords.size(); ++Idx)
+    {
+        const auto& Item = *SortedRecords[Idx];
+        std::memcpy(Buffer.data() + Entries[Idx].BinaryOffset, Item.Binary.data(), Entries[Idx].BinarySize);
+        std::memcpy(Buffer.data() + Entries[Idx].ReflectionOffset, Item.Reflection.data(), Entries[Idx].ReflectionSize);
+    }
+
+    std::ofstream File(ArchivePath, std::ios::binary | std::ios::trunc);
+    if (!File.is_open() || !File.write(Buffer.data(), static_cast<std::streamsize>(Buffer.size())))
+    {
+        LOG_ERROR("写入着色器包失败: {}", ArchivePath.string());
+        throw std::runtime_error("Failed to write shader archive: " + ArchivePath.string());
+    }
+}
+
+FShaderArchive::FShaderArchive(const std::filesystem::path& ArchivePath)
+    : MappedFile(std::make_shared<Utility::FMappedFile>(ArchivePath))
+{
+    const auto Data = MappedFile->GetData();
+
+    ShaderArchiveHeader Header = {};
+    if (Data.size() >= sizeof(Header))
+    {
+        std::memcpy(&Header, Data.data(), sizeof(Header));
+    }
+    if (Header.Magic != ArchiveMagic || Header.Version != ArchiveVersion ||
+        Data.size() < sizeof(Header) + static_cast<std::size_t>(Header.EntryCount) * sizeof(ShaderArchiveEntry))
+    {
+        LOG_ERROR("着色器包格式不合法: {}", ArchivePath.string());
+        throw std::runtime_error("Invalid shader archive: " + ArchivePath.string());
+    }
+
+    // 映射的起始地址按页对齐，文件头之后的索引满足8字节对齐，可以直接按结构体访问
+    Entries = { reinterpret_cast<const ShaderArchiveEntry*>(Data.data() + sizeof(Header)), Header.EntryCount };
+    // 写成减法的形式，构造的偏移与大小相加溢出时也能检测出越界
+    auto InFile = [FileSize = static_cast<std::uint64_t>(Data.size())](std::uint64_t Offset, std::uint64_t Size)
+    {
+        return Offset <= FileSize && FileSize - Offset >= Size;
+    };
+    for (const auto& Entry : Entries)
+    {
+        // SPIR-V由32位字组成，大小不是4的倍数的二进制不能按字访问
+        if (Entry.BinaryOffset % alignof(std::uint32_t) != 0 || Entry.BinarySize % sizeof(std::uint32_t) != 0 ||
+            !InFile(Entry.BinaryOffset, Entry.BinarySize) || !InFile(Entry.ReflectionOffset, Entry.ReflectionSize))
+        {
+            LOG_ERROR("着色器包索引已损坏: {}", ArchivePath.string());
+            throw std::runtime_error("Corrupted shader archive index: " + ArchivePath.string());
+        }
+    }
+    LOG_INFO("已加载着色器包: {}，共 {} 个着色器", ArchivePath.string(), Entries.size());
+}
+
+const ShaderArchiveEntry* FShaderArchive::Find(std::uint64_t DescHash) const
+{
+    auto Iter = std::ranges::lower_bound(Entries, DescHash, {}, &ShaderArchiveEntry::DescHash);
+    if (Iter == Entries.end() || Iter->DescHash != DescHash) return nullptr;
+    return &*Iter;
+}
+
+bool FShaderArchive::Load(const ShaderArchiveEntry& Entry, FShader& oShader) const
+{
+    const auto Data = MappedFile->GetData();
+    if (!FShaderDiskCache::DeserializeReflection(Data.subspan(Entry.ReflectionOffset, Entry.ReflectionSize), oShader))
+    {
+        return false;
+    }
+
+    oShader.SPIRVData = { reinterpret_cast<const uint32_t*>(Data.data() + Entry.BinaryOffset), Entry.BinarySize / sizeof(uint32_t) };
+    oShader.SPIRVOwner = MappedFile;
+    return true;
+}
@@ -0,0 +1,286 @@
+#include "ShaderCache.hh"
+
+#include "Hash.hh"
+#include "Logger.hh"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <optional>
+#include <string_view>
+
+using namespace SilverBell::Renderer;
+
+namespace
+{
+    constexpr std::uint32_t CacheMagic = 0x43534253; // "SBSC"
+
+    class FBinaryWriter
+    {
+    public:
+        explicit FBinaryWriter(std::vector<char>& oBuffer) : Buffer(oBuffer) {}
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        void Write(const T& Value)
+        {
+            const auto* Bytes = reinterpret_cast<const char*>(&Value);
+            Buffer.insert(Buffer.end(), Bytes, Bytes + sizeof(T));
+        }
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        void WriteSpan(std::span<const T> Values)
+        {
+            Write<std::uint64_t>(Values.size());
+            const auto* Bytes = reinterpret_cast<const char*>(Values.data());
+            Buffer.insert(Buffer.end(), Bytes, Bytes + Values.size_bytes());
+        }
+
+        template<typename T>
+        void WriteVector(const std::vector<T>& Values)
+        {
+            WriteSpan(std::span<const T>(Values));
+        }
+
+        void WriteString(std::string_view Value)
+        {
+            Write<std::uint64_t>(Value.size());
+            Buffer.insert(Buffer.end(), Value.begin(), Value.end());
+        }
+
+        void WritePath(const std::filesystem::path& Path)
+        {
+            const std::u8string U8Path = Path.u8string();
+            WriteString(std::string_view(reinterpret_cast<const char*>(U8Path.data()), U8Path.size()));
+        }
+
+    private:
+        std::vector<char>& Buffer;
+    };
+
+    // 所有读取操作都做越界检查，数据被截断或损坏时返回false
+    class FBinaryReader
+    {
+    public:
+        explicit FBinaryReader(std::span<const char> iBuffer) : Buffer(iBuffer) {}
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        bool Read(T& oValue)
+        {
+            if (Buffer.size() - Offset < sizeof(T)) return false;
+            std::memcpy(&oValue, Buffer.data() + Offset, sizeof(T));
+            Offset += sizeof(T);
+            return true;
+        }
+
+        template<typename T>
+            requires std::is_trivially_copyable_v<T>
+        bool ReadVector(std::vector<T>& oValues)
+        {
+            std::uint64_t Count = 0;
+            if (!Read(Count) || (Buffer.size() - Offset) / sizeof(T) < Count) return false;
+            oValues.resize(Count);
+            std::memcpy(oValues.data(), Buffer.data() + Offset, Count * sizeof(T));
+            Offset += Count * sizeof(T);
+            return true;
+        }
+
+        bool ReadString(std::string& oValue)
+        {
+            std::uint64_t Size = 0;
+            if (!Read(Size) || Buffer.size() - Offset < Size) return false;
+            oValue.assign(Buffer.data() + Offset, Size);
+            Offset += Size;
+            return true;
+        }
+
+        bool ReadPath(std::filesystem::path& oPath)
+        {
+            std::string U8Path;
+            if (!ReadString(U8Path)) return false;
+            oPath = std::filesystem::path(std::u8string(reinterpret_cast<const char8_t*>(U8Path.data()), U8Path.size()));
+            return true;
+        }
+
+        std::span<const char> Remaining() const { return Buffer.subspan(Offset); }
+
+    private:
+        std::span<const char> Buffer;
+        std::size_t Offset = 0;
+    };
+
+    std::optional<std::vector<char>> ReadFileBytes(const std::filesystem::path& FilePath)
+    {
+        std::ifstream File(FilePath, std::ios::binary | std::ios::ate);
+        if (!File.is_open()) return std::nullopt;
+
+        const std::streamsize Size = File.tellg();
+        std::vector<char> Buffer(static_cast<std::size_t>(Size));
+        File.seekg(0);
+        if (!File.read(Buffer.data(), Size)) return std::nullopt;
+        return Buffer;
+    }
+
+    std::optional<std::uint64_t> HashFileContent(const std::filesystem::path& FilePath)
+    {
+        auto Content = ReadFileBytes(FilePath);
+        if (!Content.has_value()) return std::nullopt;
+        return SilverBell::Algorithm::HashFunction::Hash64(Content->data(), Content->size());
+    }
+
+    std::filesystem::path GetCacheFilePath(const std::filesystem::path& CacheDirectory, std::uint64_t CacheKey)
+    {
+        return CacheDirectory / std::format("{:016x}.spvcache", CacheKey);
+    }
+}
+
+bool FShaderDiskCache::Load(const std::filesystem::path& CacheDirectory, std::uint64_t CacheKey, std::uint64_t SourceHash, FShader& oShader)
+{
+    const auto CacheFilePath = GetCacheFilePath(CacheDirectory, CacheKey);
+    auto Content = ReadFileBytes(CacheFilePath);
+    if (!Content.has_value()) return false;
+
+    FBinaryReader Reader(*Content);
+    std::uint32_t Magic = 0, Version = 0;
+    std::uint64_t StoredKey = 0, StoredSourceHash = 0;
+    if (!Reader.Read(Magic) || !Reader.Read(Version) || !Reader.Read(StoredKey) || !Reader.Read(StoredSourceHash) ||
+        Magic != CacheMagic || Version != CacheVersion || StoredKey != CacheKey)
+    {
+        LOG_DEBUG("着色器缓存格式不匹配，忽略: {}", CacheFilePath.string());
+        return false;
+    }
+
+    if (StoredSourceHash != SourceHash) return false;
+
+    // 校验所有被包含的文件，任意一个变化都视为失效
+    std::uint64_t DependencyCount = 0;
+    if (!Reader.Read(DependencyCount)) return false;
+    std::vector<std::filesystem::path> Dependencies;
+    for (std::uint64_t Idx = 0; Idx < DependencyCount; ++Idx)
+    {
+        std::filesystem::path DependencyPath;
+        std::uint64_t StoredHash = 0;
+        if (!Reader.ReadPath(DependencyPath) || !Reader.Read(StoredHash)) return false;
+
+        auto CurrentHash = HashFileContent(DependencyPath);
+        if (!CurrentHash.has_value() || *CurrentHash != StoredHash) return false;
+        Dependencies.push_back(std::move(DependencyPath));
+    }
+
+    if (!Deserialize(Reader.Remaining(), oShader))
+    {
+        LOG_WARN("着色器缓存已损坏，将重新编译: {}", CacheFilePath.string());
+        return false;
+    }
+    oShader.Dependencies = std::move(Dependencies);
+    return true;
+}
+
+void FShaderDiskCache::Store(const std::filesystem::path& CacheDirectory, std::uint64_t CacheKey, std::uint64_t SourceHash, const FShader& Shader)
+{
+    std::vector<char> Buffer;
+    FBinaryWriter Writer(Buffer);
+    Writer.Write(CacheMagic);
+    Writer.Write(CacheVersion);
+    Writer.Write(CacheKey);
+    Writer.Write(SourceHash);
+
+    Writer.Write<std::uint64_t>(Shader.Dependencies.size());
+    for (const auto& DependencyPath : Shader.Dependencies)
+    {
+        auto DependencyHash = HashFileContent(DependencyPath);
+        if (!DependencyHash.has_value())
+        {
+            LOG_WARN("无法读取着色器依赖文件，跳过写入缓存: {}", DependencyPath.string());
+            return;
+        }
+        Writer.WritePath(DependencyPath);
+        Writer.Write(*DependencyHash);
+    }
+
+    Serialize(Shader, Buffer);
+
+    std::error_code ErrorCode;
+    std::filesystem::create_directories(CacheDirectory, ErrorCode);
+
+    // 先写临时文件再重命名，避免其他进程读到写了一半的缓存
+    const auto CacheFilePath = GetCacheFilePath(CacheDirectory, CacheKey);
+    auto TempFilePath = CacheFilePath;
+    TempFilePath += ".tmp";
+    {
+        std::ofstream File(TempFilePath, std::ios::binary | std::ios::trunc);
+        if (!File.is_open() || !File.write(Buffer.data(), static_cast<std::streamsize>(Buffer.size())))
+        {
+            LOG_WARN("写入着色器缓存失败: {}", TempFilePath.string());
+            return;
+        }
+    }
+    std::filesystem::rename(TempFilePath, CacheFilePath, ErrorCode);
+    if (ErrorCode)
+    {
+        LOG_WARN("写入着色器缓存失败: {}, {}", CacheFilePath.string(), ErrorCode.message());
+        std::filesystem::remove(TempFilePath, ErrorCode);
+    }
+}
+
+void FShaderDiskCache::Serialize(const FShader& Shader, std::vector<char>& oBuffer)
+{
+    FBinaryWriter Writer(oBuffer);
+    Writer.WriteSpan(Shader.GetBinary());
+    SerializeReflection(Shader, oBuffer);
+}
+
+bool FShaderDiskCache::Deserialize(std::span<const char> Buffer, FShader& oShader)
+{
+    FBinaryReader Reader(Buffer);
+    std::vector<uint32_t> SPIRVData;
+    if (!Reader.ReadVector(SPIRVData)) return false;
+    oShader.SetBinary(std::move(SPIRVData));
+    return DeserializeReflection(Reader.Remaining(), oShader);
+}
+
+void FShaderDiskCache::SerializeReflection(const FShader& Shader, std::vector<char>& oBuffer)
+{
+    FBinaryWriter Writer(oBuffer);
+    const auto& Reflection = Shader.ReflectionInfo;
+    Writer.WriteString(Reflection.Name);
+    Writer.Write(Reflection.Stage);
+    Writer.WriteVector(Reflection.Resources);
+    Writer.WriteVector(Reflection.PushConstants);
+    Writer.Write<std::uint64_t>(Reflection.DefinedSymbols.size());
+    for (const auto& Symbol : Reflection.DefinedSymbols)
+    {
+        Writer.WriteString(Symbol);
+    }
+    Writer.WriteVector(Reflection.InputVariables);
+    Writer.WriteVector(Reflection.OutputVariables);
+    Writer.Write(Reflection.InstructionCount);
+    Writer.Write(Reflection.FinalInstructionCount);
+}
+
+bool FShaderDiskCache::DeserializeReflection(std::span<const char> Buffer, FShader& oShader)
+{
+    FBinaryReader Reader(Buffer);
+    auto& Reflection = oShader.ReflectionInfo;
+    if (!Reader.ReadString(Reflection.Name) ||
+        !Reader.Read(Reflection.Stage) ||
+        !Reader.ReadVector(Reflection.Resources) ||
+        !Reader.ReadVector(Reflection.PushConstants))
+    {
+        return false;
+    }
+
+    std::uint64_t SymbolCount = 0;
+    if (!Reader.Read(SymbolCount)) return false;
+    for (std::uint64_t Idx = 0; Idx < SymbolCount; ++Idx)
+    {
+        std::string Symbol;
+        if (!Reader.ReadString(Symbol)) return false;
+        Reflection.DefinedSymbols.insert(std::move(Symbol));
+    }
+
+    return Reader.ReadVector(Reflection.InputVariables) && Reader.ReadVector(Reflection.OutputVariables) &&
+        Reader.Read(Reflection.InstructionCount) && Reader.Read(Reflection.FinalInstructionCount);
+}
@@ -1,7 +1,12 @@
 #include "ShaderManager.hh"
 
+#include "Hash.hh"
 #include "Logger.hh"
 #include "RendererMarco.hh"
+#include "ShaderCache.hh"
+#include "ShaderPermutation.hh"
+#include "SPIRVUtil.hh"
+#include "ThreadPool.hh"
 
 #include <Volk/volk.h>
 
@@ -11,7 +16,13 @@
 
 #include "spirv_reflect.h"
 
+#include <ylt/struct_json/json_writer.h>
+
+#include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <iterator>
+#include <ranges>
 #include <span>
 
 using namespace SilverBell::Renderer;
@@ -49,28 +60,101 @@ namespace
     }
 
     constexpr uint8_t MAX_SHADER_INPUT = 8;
+
+    // 着色器磁盘缓存目录
+    const std::filesystem::path ShaderCacheDirectory = ProjectPath + "Intermediate/ShaderCache";
+
+    // 包装DXC默认的IncludeHandler，记录编译过程中打开过的所有文件
+    class FRecordingIncludeHandler : public IDxcIncludeHandler
+    {
+    public:
+        explicit FRecordingIncludeHandler(IDxcUtils* Utils)
+        {
+            Utils->CreateDefaultIncludeHandler(&DefaultHandler);
+        }
+
+        HRESULT STDMETHODCALLTYPE LoadSource(LPCWSTR pFilename, IDxcBlob** ppIncludeSource) override
+        {
+            HRESULT Result = DefaultHandler->LoadSource(pFilename, ppIncludeSource);
+            if (SUCCEEDED(Result))
+            {
+                std::filesystem::path IncludedFile = std::filesystem::path(pFilename).lexically_normal();
+                if (std::ranges::find(IncludedFiles, IncludedFile) == IncludedFiles.end())
+                {
+                    IncludedFiles.push_back(std::move(IncludedFile));
+                }
+            }
+            return Result;
+        }
+
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID Riid, void** ppvObject) override
+        {
+            if (IsEqualIID(Riid, __uuidof(IDxcIncludeHandler)) || IsEqualIID(Riid, __uuidof(IUnknown)))
+            {
+                *ppvObject = static_cast<IDxcIncludeHandler*>(this);
+                return S_OK;
+            }
+            *ppvObject = nullptr;
+            return E_NOINTERFACE;
+        }
+
+        // 只在栈上使用，生命周期由调用者管理
+        ULONG STDMETHODCALLTYPE AddRef() override { return 1; }
+        ULONG STDMETHODCALLTYPE Release() override { return 1; }
+
+        std::vector<std::filesystem::path> IncludedFiles;
+
+    private:
+        ComPtr<IDxcIncludeHandler> DefaultHandler;
+    };
+
+    std::filesystem::path NormalizePath(const std::filesystem::path& FilePath)
+    {
+        std::error_code ErrorCode;
+        return std::filesystem::absolute(FilePath, ErrorCode).lexically_normal();
+    }
+
+    std::uint64_t MicrosecondsSince(std::chrono::steady_clock::time_point StartTime)
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - StartTime).count());
+    }
+
+    std::uint64_t HashArguments(std::span<const wchar_t* const> Arguments)
+    {
+        std::uint64_t Seed = 0;
+        for (const wchar_t* Argument : Arguments)
+        {
+            const std::wstring_view View(Argument);
+            Seed = SilverBell::Algorithm::HashFunction::HashCombine(Seed,
+                SilverBell::Algorithm::HashFunction::Hash64(View.data(), View.size() * sizeof(wchar_t)));
+        }
+        return Seed;
+    }
 }
 
 FShaderManager& FShaderManager::Instance()
 {
+    // 静态对象按构造的逆序析构，先构造线程池，保证它比着色器管理器晚析构
+    Utility::FThreadPool::Instance();
     static FShaderManager sInstance;
     return sInstance;
 }
 
-std::vector<uint32_t> CompileHLSLToSPIRV(const std::span<char> SourceCode, std::span<const wchar_t*> Arguments)
+std::vector<uint32_t> CompileHLSLToSPIRV(const std::span<char> SourceCode, std::span<const wchar_t*> Arguments,
+                                         std::vector<std::filesystem::path>& oIncludedFiles)
 {
-    // 初始化DXCs
-    static ComPtr<IDxcUtils> IDxcUtils = nullptr;
-    static ComPtr<IDxcCompiler3> Compiler = nullptr;
-    static ComPtr<IDxcIncludeHandler> IncludeHandler = nullptr;
+    // 初始化DXC，IDxcCompiler3不能被多个线程同时使用，每个线程持有独立的实例
+    thread_local ComPtr<IDxcUtils> IDxcUtils = nullptr;
+    thread_local ComPtr<IDxcCompiler3> Compiler = nullptr;
     
     if (Compiler == nullptr)
     {
         DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&IDxcUtils));
         DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&Compiler));
-        IDxcUtils->CreateDefaultIncludeHandler(&IncludeHandler);
     }
 
+    FRecordingIncludeHandler IncludeHandler(IDxcUtils.Get());
+
     ComPtr<IDxcBlobEncoding> SourceBlob;
     IDxcUtils->CreateBlob(SourceCode.data(), static_cast<UINT32>(SourceCode.size()), CP_UTF8, &SourceBlob);
     DxcBuffer SourceBuffer = { .Ptr = SourceBlob->GetBufferPointer(), .Size = SourceBlob->GetBufferSize(), .Encoding = DXC_CP_UTF8 };
@@ -80,7 +164,7 @@ std::vector<uint32_t> CompileHLSLToSPIRV(const std::span<char> SourceCode, std::
         &SourceBuffer,
         Arguments.data(),
         static_cast<UINT32>(Arguments.size()),
-        IncludeHandler.Get(),
+        &IncludeHandler,
         IID_PPV_ARGS(&Results));
 
 
@@ -104,20 +188,30 @@ std::vector<uint32_t> CompileHLSLToSPIRV(const std::span<char> SourceCode, std::
     const uint32_t* SpirvData = reinterpret_cast<const uint32_t*>(SpirvBlob->GetBufferPointer());
     size_t SpirvSize = SpirvBlob->GetBufferSize() / sizeof(uint32_t);
 
+    oIncludedFiles = std::move(IncludeHandler.IncludedFiles);
     return { SpirvData, SpirvData + SpirvSize };
 }
 
-VkShaderModule FShaderManager::CreateShaderModule(const ShaderDesc& Desc, const VkDevice LogicDevice)
+VkShaderModule FShaderManager::AcquireShaderModule(const ShaderDesc& Desc, const VkDevice LogicDevice)
 {
-    // TODO : 这里可以添加缓存机制，避免重复创建同一个ShaderModule
-
     const auto& Shader = GetOrCreateShader(Desc);
+    const auto SPIRVBinary = Shader.GetBinary();
+    const ShaderModuleKey ModuleKey{ SPIRVBinary.data(), LogicDevice };
+
+    std::scoped_lock Lock(DeviceResourceMutex);
+    if (auto Iter = ShaderModuleCache.find(ModuleKey); Iter != ShaderModuleCache.end())
+    {
+        ++Stats.ModuleCacheHits;
+        ++Iter->second.RefCount;
+        return Iter->second.Module;
+    }
+
+    const auto StartTime = std::chrono::steady_clock::now();
 
-    auto& SPIRVBinary = Shader.SPIRVData;
     VkShaderModuleCreateInfo CreateInfo = {};
     CreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    CreateInfo.codeSize = SPIRVBinary.size() * sizeof(uint32_t);
-    CreateInfo.pCode = (SPIRVBinary.data());
+    CreateInfo.codeSize = SPIRVBinary.size_bytes();
+    CreateInfo.pCode = SPIRVBinary.data();
 
     VkShaderModule ShaderModule;
     if (vkCreateShaderModule(LogicDevice, &CreateInfo, nullptr, &ShaderModule) != VK_SUCCESS)
@@ -126,13 +220,159 @@ VkShaderModule FShaderManager::CreateShaderModule(const ShaderDesc& Desc, const
         throw std::runtime_error("Failed to create shader module from file: " + Desc.FilePath.string());
     }
 
+    ++Stats.ModulesCreated;
+    Stats.ModuleCreationTime.Record(MicrosecondsSince(StartTime));
+
+    ShaderModuleCache[ModuleKey] = { .LogicDevice = LogicDevice, .Module = ShaderModule, .RefCount = 1, .BinaryOwner = Shader.SPIRVOwner };
+    ShaderModuleKeys[ShaderModule] = ModuleKey;
     return ShaderModule;
 }
 
+void FShaderManager::ReleaseShaderModule(VkShaderModule ShaderModule)
+{
+    std::scoped_lock Lock(DeviceResourceMutex);
+    auto KeyIter = ShaderModuleKeys.find(ShaderModule);
+    if (KeyIter == ShaderModuleKeys.end())
+    {
+        LOG_WARN("释放了不由着色器管理器创建的着色器模块");
+        return;
+    }
+
+    auto& Entry = ShaderModuleCache.at(KeyIter->second);
+    if (Entry.RefCount == 0)
+    {
+        LOG_WARN("着色器模块被重复释放");
+        return;
+    }
+    --Entry.RefCount;
+}
+
+void FShaderManager::PurgeUnusedShaderModules(VkDevice LogicDevice)
+{
+    std::scoped_lock Lock(DeviceResourceMutex);
+    std::erase_if(ShaderModuleCache, [this, LogicDevice](const auto& Pair)
+    {
+        if (Pair.second.LogicDevice != LogicDevice || Pair.second.RefCount != 0) return false;
+        vkDestroyShaderModule(LogicDevice, Pair.second.Module, nullptr);
+        ShaderModuleKeys.erase(Pair.second.Module);
+        return true;
+    });
+}
+
 const FShader& FShaderManager::GetOrCreateShader(const ShaderDesc& Desc)
 {
-    auto ShaderHash = Desc.GetHashValue();
-    if (ShaderCache.contains(ShaderHash)) return *ShaderCache[ShaderHash];
+    const auto ShaderHash = Desc.GetHashValue();
+    auto& Shard = ShaderCache[ShaderHash % ShaderCacheShardCount];
+
+    std::shared_future<std::unique_ptr<FShader>> Result;
+    {
+        std::shared_lock Lock(Shard.Mutex);
+        if (auto Iter = Shard.Shaders.find(ShaderHash); Iter != Shard.Shaders.end())
+        {
+            Result = Iter->second;
+        }
+    }
+
+    if (Result.valid())
+    {
+        ++Stats.MemoryCacheHits;
+    }
+    else
+    {
+        // 抢先插入一个未完成的future，后到的线程会直接等待它
+        std::promise<std::unique_ptr<FShader>> Promise;
+        bool bShouldCompile = false;
+        {
+            std::unique_lock Lock(Shard.Mutex);
+            auto [Iter, bInserted] = Shard.Shaders.try_emplace(ShaderHash);
+            if (bInserted)
+            {
+                Iter->second = Promise.get_future().share();
+                bShouldCompile = true;
+                ++Stats.MemoryCacheMisses;
+            }
+            else
+            {
+                // 其他线程刚好抢先开始编译
+                ++Stats.MemoryCacheHits;
+            }
+            Result = Iter->second;
+        }
+
+        if (bShouldCompile)
+        {
+            try
+            {
+                auto Shader = CompileShader(Desc);
+                TrackDependencies(*Shader);
+                Promise.set_value(std::move(Shader));
+            }
+            catch (...)
+            {
+                ++Stats.CompileFailures;
+                // 编译失败时移除缓存项，修正着色器后可以重新编译
+                {
+                    std::unique_lock Lock(Shard.Mutex);
+                    Shard.Shaders.erase(ShaderHash);
+                }
+                Promise.set_exception(std::current_exception());
+            }
+        }
+    }
+
+    return *Result.get();
+}
+
+std::vector<std::future<const FShader*>> FShaderManager::CompileAsync(std::span<const ShaderDesc> Descs,
+    std::function<void(const FShader&)> OnCompleted)
+{
+    std::vector<std::future<const FShader*>> Futures;
+    Futures.reserve(Descs.size());
+    for (const auto& Desc : Descs)
+    {
+        Futures.push_back(Utility::FThreadPool::Instance().Enqueue([this, Desc, OnCompleted]() -> const FShader*
+        {
+            const FShader& Shader = GetOrCreateShader(Desc);
+            if (OnCompleted)
+            {
+                OnCompleted(Shader);
+            }
+            return &Shader;
+        }));
+    }
+    return Futures;
+}
+
+std::unique_ptr<FShader> FShaderManager::CompileShader(const ShaderDesc& Desc)
+{
+    const auto StartTime = std::chrono::steady_clock::now();
+    const auto ShaderHash = Desc.GetHashValue();
+
+    // 优先从着色器包中加载
+    std::shared_ptr<const FShaderArchive> Archive;
+    {
+        std::scoped_lock Lock(ArchiveMutex);
+        Archive = MountedArchive;
+    }
+    if (Archive)
+    {
+        if (const auto* Entry = Archive->Find(ShaderHash))
+        {
+            auto Shader = std::unique_ptr<FShader>(new FShader(Desc));
+            if (Archive->Load(*Entry, *Shader))
+            {
+                ++Stats.ArchiveHits;
+                RecordShaderLoad(*Shader, "Archive", MicrosecondsSince(StartTime), 0, 0);
+                ShareBinary(*Shader);
+                return Shader;
+            }
+            LOG_WARN("着色器包中的反射信息已损坏: {}", Desc.FilePath.string());
+        }
+        else
+        {
+            LOG_WARN("着色器包中没有找到着色器，回退到实时编译: {}", Desc.FilePath.string());
+        }
+    }
 
     // 读取着色器文件
     const std::string CompletePath = ProjectPath + Desc.FilePath.string();
@@ -159,6 +399,9 @@ const FShader& FShaderManager::GetOrCreateShader(const ShaderDesc& Desc)
     // 入口点
     std::wstring WEntyPoint(Desc.EntryPoint.begin(), Desc.EntryPoint.end());
 
+    // 以着色器所在目录作为包含目录，使相对路径的#include能够被解析
+    std::wstring WIncludeDirectory = std::filesystem::path(CompletePath).parent_path().wstring();
+
     // 装配编译参数
     std::vector Argument =
     {
@@ -167,20 +410,266 @@ const FShader& FShaderManager::GetOrCreateShader(const ShaderDesc& Desc)
         L"-spirv",
         L"-fvk-use-dx-layout", // 使用DirectX的内存布局
         L"-fspv-target-env=vulkan1.1", // TODO:做成可配置的
-#if VULKAN_DEBUG_ENABLE
+        L"-I", WIncludeDirectory.c_str(),
+        // DXC默认即为-O3，不优化时额外生成调试信息
+#if !SHADER_OPTIMIZE_ENABLE
         L"-Zi",
 #endif
         WFileName.c_str(),
     };
 
-    // 编译成SPIR-V二进制
-    auto SPIRVBinary = CompileHLSLToSPIRV(SourceCode, Argument);
+    // 排列关键字作为宏定义传入，NAME=VALUE 的形式由DXC自行解析
+    std::vector<std::wstring> WDefines;
+    WDefines.reserve(Desc.Defines.size());
+    for (const auto& Define : Desc.Defines)
+    {
+        WDefines.emplace_back(Define.begin(), Define.end());
+        Argument.push_back(L"-D");
+        Argument.push_back(WDefines.back().c_str());
+    }
 
     auto Shader = std::unique_ptr<FShader>(new FShader(Desc));
-    Shader->SPIRVData = std::move(SPIRVBinary);
+
+    // 磁盘缓存的键由ShaderDesc与编译参数共同决定，源文件与包含文件的内容哈希在缓存内部校验
+    const std::uint64_t CacheKey = Algorithm::HashFunction::HashCombine(ShaderHash, HashArguments(Argument));
+    const std::uint64_t SourceHash = Algorithm::HashFunction::Hash64(SourceCode.data(), SourceCode.size());
+    if (FShaderDiskCache::Load(ShaderCacheDirectory, CacheKey, SourceHash, *Shader))
+    {
+        LOG_DEBUG("命中着色器磁盘缓存: {}", Desc.FilePath.string());
+        ++Stats.DiskCacheHits;
+        RecordShaderLoad(*Shader, "DiskCache", MicrosecondsSince(StartTime), 0, 0);
+        ShareBinary(*Shader);
+        return Shader;
+    }
+    ++Stats.DiskCacheMisses;
+
+    // 编译成SPIR-V二进制
+    const auto CompileStartTime = std::chrono::steady_clock::now();
+    Shader->SetBinary(CompileHLSLToSPIRV(SourceCode, Argument, Shader->Dependencies));
+    const std::uint64_t CompileMicroseconds = MicrosecondsSince(CompileStartTime);
+    Stats.CompileTime.Record(CompileMicroseconds);
+
+    // 反射依赖调试信息中的名称，必须在移除调试信息之前进行
+    const auto ReflectStartTime = std::chrono::steady_clock::now();
+    ReflectShader(*Shader);
+    const std::uint64_t ReflectMicroseconds = MicrosecondsSince(ReflectStartTime);
+    Stats.ReflectTime.Record(ReflectMicroseconds);
+
+    auto& Reflection = Shader->ReflectionInfo;
+    Reflection.InstructionCount = FSPIRVUtil::CountInstructions(Shader->GetBinary());
+#if SHADER_OPTIMIZE_ENABLE
+    Shader->SetBinary(FSPIRVUtil::StripDebugInfo(Shader->GetBinary()));
+    Reflection.FinalInstructionCount = FSPIRVUtil::CountInstructions(Shader->GetBinary());
+#else
+    Reflection.FinalInstructionCount = Reflection.InstructionCount;
+#endif
+    LOG_DEBUG("着色器 {} SPIR-V指令数: {} -> {}", Reflection.Name, Reflection.InstructionCount, Reflection.FinalInstructionCount);
+
+    FShaderDiskCache::Store(ShaderCacheDirectory, CacheKey, SourceHash, *Shader);
+
+    RecordShaderLoad(*Shader, "DXC", MicrosecondsSince(StartTime), CompileMicroseconds, ReflectMicroseconds);
+    ShareBinary(*Shader);
+    return Shader;
+}
+
+const PipelineLayoutInfo& FShaderManager::GetOrCreatePipelineLayout(std::span<const ShaderDesc> Descs, VkDevice LogicDevice)
+{
+    // 合并所有阶段的资源绑定，同一个set/binding在多个阶段出现时合并阶段标记
+    std::vector<std::vector<VkDescriptorSetLayoutBinding>> SetBindings;
+    // 每个着色器阶段只能出现在一个推送常量范围里，这里先按阶段求并集
+    std::vector<std::pair<uint32_t, VkPushConstantRange>> StageRanges;
+    for (const auto& Desc : Descs)
+    {
+        const auto& Reflection = GetOrCreateShader(Desc).GetReflectionInfo();
+        for (const auto& Resource : Reflection.Resources)
+        {
+            if (SetBindings.size() < Resource.Set + 1u)
+            {
+                SetBindings.resize(Resource.Set + 1u);
+            }
+
+            // 以(set, binding, 类型)为键合并，同一个binding上出现不同类型时布局无法表示
+            auto& Bindings = SetBindings[Resource.Set];
+            const auto Type = static_cast<VkDescriptorType>(Resource.Type);
+            auto Iter = std::ranges::find_if(Bindings, [&Resource, Type](const VkDescriptorSetLayoutBinding& Binding)
+            {
+                return Binding.binding == Resource.Binding && Binding.descriptorType == Type;
+            });
+
+            if (Iter == Bindings.end())
+            {
+                if (std::ranges::find(Bindings, Resource.Binding, &VkDescriptorSetLayoutBinding::binding) != Bindings.end())
+                {
+                    // 常见于分开声明的纹理与采样器使用了相同的寄存器编号，需要[[vk::combinedImageSampler]]或不同的绑定
+                    LOG_ERROR("着色器资源绑定冲突，set: {} binding: {} 被不同类型的资源使用！", Resource.Set, Resource.Binding);
+                    throw std::runtime_error("Descriptor type mismatch between shader resources!");
+                }
+
+                VkDescriptorSetLayoutBinding Binding = {};
+                Binding.binding = Resource.Binding;
+                Binding.descriptorType = Type;
+                Binding.descriptorCount = Resource.Size;
+                Binding.stageFlags = Resource.Stage;
+                Binding.pImmutableSamplers = nullptr;
+                Bindings.push_back(Binding);
+                continue;
+            }
+
+            Iter->descriptorCount = std::max<uint32_t>(Iter->descriptorCount, Resource.Size);
+            Iter->stageFlags |= Resource.Stage;
+        }
+
+        for (const auto& PushConstant : Reflection.PushConstants)
+        {
+            auto Iter = std::ranges::find_if(StageRanges, [&PushConstant](const auto& Pair)
+            {
+                return Pair.first == PushConstant.Stage;
+            });
+            if (Iter == StageRanges.end())
+            {
+                StageRanges.emplace_back(PushConstant.Stage, VkPushConstantRange{ PushConstant.Stage, PushConstant.Offset, PushConstant.Size });
+                continue;
+            }
+            const uint32_t End = std::max(Iter->second.offset + Iter->second.size, PushConstant.Offset + PushConstant.Size);
+            Iter->second.offset = std::min(Iter->second.offset, PushConstant.Offset);
+            Iter->second.size = End - Iter->second.offset;
+        }
+    }
+
+    // 绑定按编号排序，保证相同的布局得到相同的哈希
+    for (auto& Bindings : SetBindings)
+    {
+        std::ranges::sort(Bindings, {}, &VkDescriptorSetLayoutBinding::binding);
+    }
+
+    // 范围完全相同的阶段合并成一个推送常量范围
+    std::vector<VkPushConstantRange> PushConstantRanges;
+    for (const auto& Range : StageRanges | std::views::values)
+    {
+        auto Iter = std::ranges::find_if(PushConstantRanges, [&Range](const VkPushConstantRange& Other)
+        {
+            return Other.offset == Range.offset && Other.size == Range.size;
+        });
+        if (Iter != PushConstantRanges.end())
+        {
+            Iter->stageFlags |= Range.stageFlags;
+        }
+        else
+        {
+            PushConstantRanges.push_back(Range);
+        }
+    }
+    std::ranges::sort(PushConstantRanges, {}, &VkPushConstantRange::offset);
+
+    std::vector<VkDescriptorSetLayout> SetLayouts;
+    SetLayouts.reserve(SetBindings.size());
+    for (const auto& Bindings : SetBindings)
+    {
+        SetLayouts.push_back(GetOrCreateDescriptorSetLayout(Bindings, LogicDevice));
+    }
+
+    std::uint64_t LayoutHash = Algorithm::HashFunction::Hash64(SetLayouts.data(), SetLayouts.size() * sizeof(VkDescriptorSetLayout));
+    LayoutHash = Algorithm::HashFunction::HashCombine(LayoutHash,
+        Algorithm::HashFunction::Hash64(PushConstantRanges.data(), PushConstantRanges.size() * sizeof(VkPushConstantRange)));
+    LayoutHash = Algorithm::HashFunction::HashCombine(LayoutHash, reinterpret_cast<std::uint64_t>(LogicDevice));
+
+    std::scoped_lock Lock(DeviceResourceMutex);
+    if (auto Iter = PipelineLayoutCache.find(LayoutHash); Iter != PipelineLayoutCache.end())
+    {
+        return Iter->second;
+    }
+
+    VkPipelineLayoutCreateInfo LayoutCreateInfo = {};
+    LayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    LayoutCreateInfo.setLayoutCount = static_cast<uint32_t>(SetLayouts.size());
+    LayoutCreateInfo.pSetLayouts = SetLayouts.data();
+    LayoutCreateInfo.pushConstantRangeCount = static_cast<uint32_t>(PushConstantRanges.size());
+    LayoutCreateInfo.pPushConstantRanges = PushConstantRanges.data();
+
+    VkPipelineLayout PipelineLayout;
+    if (vkCreatePipelineLayout(LogicDevice, &LayoutCreateInfo, nullptr, &PipelineLayout) != VK_SUCCESS)
+    {
+        LOG_ERROR("创建管线布局失败！");
+        throw std::runtime_error("Failed to create pipeline layout!");
+    }
+
+    auto& Info = PipelineLayoutCache[LayoutHash];
+    Info.LogicDevice = LogicDevice;
+    Info.PipelineLayout = PipelineLayout;
+    Info.SetLayouts = std::move(SetLayouts);
+    Info.SetBindings = std::move(SetBindings);
+    Info.PushConstantRanges = std::move(PushConstantRanges);
+    return Info;
+}
+
+VkDescriptorSetLayout FShaderManager::GetOrCreateDescriptorSetLayout(std::span<const VkDescriptorSetLayoutBinding> Bindings, VkDevice LogicDevice)
+{
+    // 注：pImmutableSamplers 由反射生成时总是空指针，可以直接按字节求哈希
+    std::uint64_t LayoutHash = Algorithm::HashFunction::Hash64(Bindings.data(), Bindings.size_bytes());
+    LayoutHash = Algorithm::HashFunction::HashCombine(LayoutHash, reinterpret_cast<std::uint64_t>(LogicDevice));
+
+    std::scoped_lock Lock(DeviceResourceMutex);
+
+    if (auto Iter = DescriptorSetLayoutCache.find(LayoutHash); Iter != DescriptorSetLayoutCache.end())
+    {
+        return Iter->second.Layout;
+    }
+
+    VkDescriptorSetLayoutCreateInfo LayoutCreateInfo = {};
+    LayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    LayoutCreateInfo.bindingCount = static_cast<uint32_t>(Bindings.size());
+    LayoutCreateInfo.pBindings = Bindings.data();
+
+    VkDescriptorSetLayout Layout;
+    if (vkCreateDescriptorSetLayout(LogicDevice, &LayoutCreateInfo, nullptr, &Layout) != VK_SUCCESS)
+    {
+        LOG_ERROR("创建描述符集布局失败！");
+        throw std::runtime_error("failed to create descriptor set layout!");
+    }
+
+    DescriptorSetLayoutCache[LayoutHash] = { .LogicDevice = LogicDevice, .Layout = Layout };
+    return Layout;
+}
+
+void FShaderManager::DestroyDeviceResources(VkDevice LogicDevice)
+{
+    std::scoped_lock Lock(DeviceResourceMutex);
+
+    // 设备即将销毁，仍被引用的模块也一并销毁
+    std::erase_if(ShaderModuleCache, [this, LogicDevice](const auto& Pair)
+    {
+        if (Pair.second.LogicDevice != LogicDevice) return false;
+        if (Pair.second.RefCount != 0)
+        {
+            LOG_WARN("设备销毁时仍有着色器模块未释放，引用计数: {}", Pair.second.RefCount);
+        }
+        vkDestroyShaderModule(LogicDevice, Pair.second.Module, nullptr);
+        ShaderModuleKeys.erase(Pair.second.Module);
+        return true;
+    });
+
+    std::erase_if(PipelineLayoutCache, [LogicDevice](const auto& Pair)
+    {
+        if (Pair.second.LogicDevice != LogicDevice) return false;
+        vkDestroyPipelineLayout(LogicDevice, Pair.second.PipelineLayout, nullptr);
+        return true;
+    });
+
+    std::erase_if(DescriptorSetLayoutCache, [LogicDevice](const auto& Pair)
+    {
+        if (Pair.second.LogicDevice != LogicDevice) return false;
+        vkDestroyDescriptorSetLayout(LogicDevice, Pair.second.Layout, nullptr);
+        return true;
+    });
+}
+
+void FShaderManager::ReflectShader(FShader& oShader)
+{
+    const std::string CompletePath = ProjectPath + oShader.Desc.FilePath.string();
 
     SpvReflectShaderModule Module;
-    SpvReflectResult Result = spvReflectCreateShaderModule(Shader->SPIRVData.size() * sizeof(uint32_t), Shader->SPIRVData.data(), &Module);
+    const auto SPIRVBinary = oShader.GetBinary();
+    SpvReflectResult Result = spvReflectCreateShaderModule(SPIRVBinary.size_bytes(), SPIRVBinary.data(), &Module);
     if (Result != SPV_REFLECT_RESULT_SUCCESS)
     {
         LOG_ERROR("SPIR-V反射创建失败，失败文件: {}", CompletePath);
@@ -190,10 +679,15 @@ const FShader& FShaderManager::GetOrCreateShader(const ShaderDesc& Desc)
     // 注：反射库中的枚举类型与Vulkan的枚举类型是一致的，可以直接使用
 
     // 获取入口点信息
-    const SpvReflectEntryPoint* EntryPoint = spvReflectGetEntryPoint(&Module, Desc.EntryPoint.c_str());
+    const SpvReflectEntryPoint* EntryPoint = spvReflectGetEntryPoint(&Module, oShader.Desc.EntryPoint.c_str());
     // 名称采用 文件名-入口点名 的形式，便于区分同一文件中的不同入口点
-    Shader->ReflectionInfo.Name = FileName + std::string("-") + std::string(EntryPoint->name);
-    Shader->ReflectionInfo.Stage = static_cast<uint8_t>(EntryPoint->shader_stage);
+    oShader.ReflectionInfo.Name = oShader.Desc.FilePath.filename().string() + std::string("-") + std::string(EntryPoint->name);
+    oShader.ReflectionInfo.Stage = static_cast<uint8_t>(EntryPoint->shader_stage);
+    // 记录编译时定义的宏名
+    for (const auto& Define : oShader.Desc.Defines)
+    {
+        oShader.ReflectionInfo.DefinedSymbols.emplace(FShaderPermutationSet::GetDefineName(Define));
+    }
     // 获取输入变量信息
     uint32_t InputVariableCount = 0;
     spvReflectEnumerateInputVariables(&Module, &InputVariableCount, nullptr);
@@ -205,11 +699,11 @@ const FShader& FShaderManager::GetOrCreateShader(const ShaderDesc& Desc)
         {
             if (Var->location < MAX_SHADER_INPUT)
             {
-                if (Shader->ReflectionInfo.InputVariables.size() < Var->location + 1)
+                if (oShader.ReflectionInfo.InputVariables.size() < Var->location + 1)
                 {
-                    Shader->ReflectionInfo.InputVariables.resize(Var->location + 1);
+                    oShader.ReflectionInfo.InputVariables.resize(Var->location + 1);
                 }
-                Shader->ReflectionInfo.InputVariables[Var->location] = Var->format;
+                oShader.ReflectionInfo.InputVariables[Var->location] = Var->format;
             }
         }
     }
@@ -225,11 +719,11 @@ const FShader& FShaderManager::GetOrCreateShader(const ShaderDesc& Desc)
         {
             if (Var->location < MAX_SHADER_INPUT)
             {
-                if (Shader->ReflectionInfo.OutputVariables.size() < Var->location + 1)
+                if (oShader.ReflectionInfo.OutputVariables.size() < Var->location + 1)
                 {
-                    Shader->ReflectionInfo.OutputVariables.resize(Var->location + 1);
+                    oShader.ReflectionInfo.OutputVariables.resize(Var->location + 1);
                 }
-                Shader->ReflectionInfo.OutputVariables[Var->location] = Var->format;
+                oShader.ReflectionInfo.OutputVariables[Var->location] = Var->format;
             }
         }
     }
@@ -253,17 +747,233 @@ const FShader& FShaderManager::GetOrCreateShader(const ShaderDesc& Desc)
                 ResourceDesc.Size = static_cast<uint8_t>(Binding->count);
                 ResourceDesc.Stage = static_cast<uint8_t>(EntryPoint->shader_stage);
                 ResourceDesc.Type = static_cast<uint32_t>(Binding->descriptor_type);
-                Shader->ReflectionInfo.Resources.push_back(ResourceDesc);
+                oShader.ReflectionInfo.Resources.push_back(ResourceDesc);
             }
         }
     }
 
-    // 存入缓存
-    ShaderCache[ShaderHash] = std::move(Shader);
-    return *ShaderCache[ShaderHash];
+    // 获取推送常量信息
+    uint32_t PushConstantCount = 0;
+    spvReflectEnumeratePushConstantBlocks(&Module, &PushConstantCount, nullptr);
+    if (PushConstantCount)
+    {
+        std::vector<SpvReflectBlockVariable*> PushConstants(PushConstantCount);
+        spvReflectEnumeratePushConstantBlocks(&Module, &PushConstantCount, PushConstants.data());
+        for (const auto* Block : PushConstants)
+        {
+            FShader::ShaderPushConstantDesc PushConstantDesc;
+            PushConstantDesc.Offset = Block->offset;
+            PushConstantDesc.Size = Block->size;
+            PushConstantDesc.Stage = static_cast<uint32_t>(EntryPoint->shader_stage);
+            oShader.ReflectionInfo.PushConstants.push_back(PushConstantDesc);
+        }
+    }
+
+    spvReflectDestroyShaderModule(&Module);
 }
 
-void FShaderManager::ReflectShader(FShader& oShader)
+void FShaderManager::ShareBinary(FShader& oShader)
 {
+    const auto SPIRVBinary = oShader.GetBinary();
+    oShader.BinaryHash = Algorithm::HashFunction::Hash64(SPIRVBinary.data(), SPIRVBinary.size_bytes());
 
+    std::scoped_lock Lock(BinaryCacheMutex);
+    auto [Iter, bInserted] = BinaryCache.try_emplace(oShader.BinaryHash, SharedBinary{ oShader.SPIRVData, oShader.SPIRVOwner });
+    if (bInserted) return;
+
+    // 哈希相同时再逐字节比较一次，防止哈希碰撞导致使用错误的二进制
+    if (!std::ranges::equal(Iter->second.Binary, oShader.SPIRVData))
+    {
+        LOG_WARN("SPIR-V二进制哈希碰撞，不进行共享: {}", oShader.ReflectionInfo.Name);
+        return;
+    }
+    LOG_DEBUG("着色器 {} 与已有排列生成的SPIR-V相同，共享二进制", oShader.ReflectionInfo.Name);
+    oShader.SPIRVData = Iter->second.Binary;
+    oShader.SPIRVOwner = Iter->second.Owner;
+}
+
+void FShaderManager::TrackDependencies(const FShader& Shader)
+{
+    const auto ShaderHash = Shader.Desc.GetHashValue();
+
+    std::scoped_lock Lock(HotReloadMutex);
+    TrackedDescs.try_emplace(ShaderHash, Shader.Desc);
+
+    // 重新编译后包含的文件可能已经变化，先移除这个着色器之前的全部依赖
+    std::erase_if(DependentShaders, [ShaderHash](auto& Pair)
+    {
+        Pair.second.erase(ShaderHash);
+        return Pair.second.empty();
+    });
+
+    auto AddDependency = [this, ShaderHash](const std::filesystem::path& FilePath)
+    {
+        auto [Iter, bInserted] = DependentShaders.try_emplace(NormalizePath(FilePath));
+        Iter->second.insert(ShaderHash);
+        if (bInserted && FileWatcher)
+        {
+            FileWatcher->Watch(Iter->first);
+        }
+    };
+
+    AddDependency(ProjectPath + Shader.Desc.FilePath.string());
+    for (const auto& Dependency : Shader.Dependencies)
+    {
+        AddDependency(Dependency);
+    }
+}
+
+void FShaderManager::MountArchive(const std::filesystem::path& ArchivePath)
+{
+    auto Archive = std::make_shared<const FShaderArchive>(ArchivePath);
+    std::scoped_lock Lock(ArchiveMutex);
+    MountedArchive = std::move(Archive);
+}
+
+void FShaderManager::EnableHotReload()
+{
+    std::scoped_lock Lock(HotReloadMutex);
+    if (FileWatcher) return;
+
+    FileWatcher = std::make_unique<Utility::FFileWatcher>([this](const std::vector<std::filesystem::path>& ChangedFiles)
+    {
+        OnFilesChanged(ChangedFiles);
+    });
+    for (const auto& FilePath : DependentShaders | std::views::keys)
+    {
+        FileWatcher->Watch(FilePath);
+    }
+    LOG_INFO("着色器热重载已开启");
+}
+
+void FShaderManager::DisableHotReload()
+{
+    // 监视线程的回调会获取HotReloadMutex，必须在锁外等待它结束
+    std::unique_ptr<Utility::FFileWatcher> Watcher;
+    {
+        std::scoped_lock Lock(HotReloadMutex);
+        Watcher = std::move(FileWatcher);
+    }
+    Watcher.reset();
+
+    // 监视线程已停止，不会再提交新的任务
+    std::vector<std::future<void>> Pending;
+    {
+        std::scoped_lock Lock(HotReloadMutex);
+        Pending = std::move(PendingReloads);
+    }
+    for (auto& Future : Pending)
+    {
+        Future.wait();
+    }
+}
+
+void FShaderManager::OnFilesChanged(const std::vector<std::filesystem::path>& ChangedFiles)
+{
+    std::vector<ShaderDesc> AffectedDescs;
+    {
+        std::scoped_lock Lock(HotReloadMutex);
+        std::unordered_set<uint64_t> AffectedHashes;
+        for (const auto& FilePath : ChangedFiles)
+        {
+            auto Iter = DependentShaders.find(FilePath);
+            if (Iter == DependentShaders.end()) continue;
+            AffectedHashes.insert(Iter->second.begin(), Iter->second.end());
+        }
+        for (const auto ShaderHash : AffectedHashes)
+        {
+            AffectedDescs.push_back(TrackedDescs.at(ShaderHash));
+        }
+    }
+
+    // 只重新编译受影响的着色器，编译失败时保留旧版本继续使用
+    std::vector<std::future<void>> Futures;
+    for (auto& Desc : AffectedDescs)
+    {
+        Futures.push_back(Utility::FThreadPool::Instance().Enqueue([this, Desc = std::move(Desc)]()
+        {
+            try
+            {
+                auto Shader = CompileShader(Desc);
+                TrackDependencies(*Shader);
+                LOG_INFO("着色器已重新编译: {}", Shader->ReflectionInfo.Name);
+
+                std::scoped_lock Lock(HotReloadMutex);
+                ReloadedShaders.push_back(std::move(Shader));
+            }
+            catch (const std::exception& E)
+            {
+                ++Stats.CompileFailures;
+                LOG_ERROR("着色器重新编译失败，继续使用旧版本: {}, {}", Desc.FilePath.string(), E.what());
+            }
+        }));
+    }
+
+    std::scoped_lock Lock(HotReloadMutex);
+    std::erase_if(PendingReloads, [](const std::future<void>& Future)
+    {
+        return Future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+    std::ranges::move(Futures, std::back_inserter(PendingReloads));
+}
+
+std::vector<ShaderDesc> FShaderManager::ConsumeReloadedShaders()
+{
+    std::scoped_lock Lock(HotReloadMutex);
+
+    // 上一次替换下来的着色器已经过了一帧，不会再被引用
+    RetiredShaders.clear();
+
+    std::vector<ShaderDesc> ReloadedDescs;
+    for (auto& Shader : ReloadedShaders)
+    {
+        const auto ShaderHash = Shader->Desc.GetHashValue();
+        ReloadedDescs.push_back(Shader->Desc);
+
+        std::promise<std::unique_ptr<FShader>> Promise;
+        Promise.set_value(std::move(Shader));
+
+        auto& Shard = ShaderCache[ShaderHash % ShaderCacheShardCount];
+        std::unique_lock ShardLock(Shard.Mutex);
+        auto& Entry = Shard.Shaders[ShaderHash];
+        if (Entry.valid())
+        {
+            RetiredShaders.push_back(std::move(Entry));
+        }
+        Entry = Promise.get_future().share();
+    }
+    ReloadedShaders.clear();
+    return ReloadedDescs;
+}
+
+void FShaderManager::RecordShaderLoad(const FShader& Shader, std::string Source, std::uint64_t TotalMicroseconds,
+    std::uint64_t CompileMicroseconds, std::uint64_t ReflectMicroseconds)
+{
+    ShaderLoadRecord Record;
+    Record.Name = Shader.ReflectionInfo.Name;
+    Record.Defines = Shader.Desc.Defines;
+    Record.Source = std::move(Source);
+    Record.CompileMicroseconds = CompileMicroseconds;
+    Record.ReflectMicroseconds = ReflectMicroseconds;
+    Record.TotalMicroseconds = TotalMicroseconds;
+    Record.SPIRVBytes = Shader.GetBinary().size_bytes();
+    Stats.AddRecord(std::move(Record));
+}
+
+ShaderStatsSnapshot FShaderManager::GetStats() const
+{
+    return Stats.GetSnapshot();
+}
+
+void FShaderManager::DumpStats(const std::filesystem::path& FilePath) const
+{
+    std::string Json;
+    struct_json::to_json(GetStats(), Json);
+
+    std::ofstream File(FilePath, std::ios::trunc);
+    if (!File.is_open() || !File.write(Json.data(), static_cast<std::streamsize>(Json.size())))
+    {
+        LOG_ERROR("写入着色器统计数据失败: {}", FilePath.string());
+        throw std::runtime_error("Failed to write shader stats: " + FilePath.string());
+    }
 }
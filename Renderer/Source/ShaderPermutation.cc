@@ -0,0 +1,75 @@
+#include "ShaderPermutation.hh"
+
+#include "Logger.hh"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace SilverBell::Renderer;
+
+FShaderPermutationSet::FShaderPermutationSet(ShaderDesc iBaseDesc, std::vector<ShaderKeywordAxis> iAxes)
+    : BaseDesc(std::move(iBaseDesc)), Axes(std::move(iAxes))
+{
+    for (const auto& Axis : Axes)
+    {
+        if (Axis.Keywords.empty())
+        {
+            LOG_ERROR("着色器关键字轴不能为空: {}", BaseDesc.FilePath.string());
+            throw std::runtime_error("Shader keyword axis must not be empty: " + BaseDesc.FilePath.string());
+        }
+    }
+}
+
+std::size_t FShaderPermutationSet::GetPermutationCount() const
+{
+    std::size_t Count = 1;
+    for (const auto& Axis : Axes)
+    {
+        Count *= Axis.Keywords.size();
+    }
+    return Count;
+}
+
+ShaderDesc FShaderPermutationSet::GetPermutation(std::size_t Index) const
+{
+    if (Index >= GetPermutationCount())
+    {
+        LOG_ERROR("着色器排列编号越界: {}，文件: {}", Index, BaseDesc.FilePath.string());
+        throw std::out_of_range("Shader permutation index out of range: " + BaseDesc.FilePath.string());
+    }
+
+    ShaderDesc Desc = BaseDesc;
+    for (const auto& Axis : Axes)
+    {
+        const auto& Keyword = Axis.Keywords[Index % Axis.Keywords.size()];
+        Index /= Axis.Keywords.size();
+        if (!Keyword.empty())
+        {
+            Desc.Defines.push_back(Keyword);
+        }
+    }
+    return Desc;
+}
+
+ShaderDesc FShaderPermutationSet::Select(std::span<const std::string> EnabledKeywords) const
+{
+    ShaderDesc Desc = BaseDesc;
+    for (const auto& Axis : Axes)
+    {
+        auto Iter = std::ranges::find_if(Axis.Keywords, [EnabledKeywords](const std::string& Keyword)
+        {
+            return !Keyword.empty() && std::ranges::find(EnabledKeywords, Keyword) != EnabledKeywords.end();
+        });
+        const auto& Keyword = Iter != Axis.Keywords.end() ? *Iter : Axis.Keywords.front();
+        if (!Keyword.empty())
+        {
+            Desc.Defines.push_back(Keyword);
+        }
+    }
+    return Desc;
+}
+
+std::string_view FShaderPermutationSet::GetDefineName(std::string_view Keyword)
+{
+    return Keyword.substr(0, Keyword.find('='));
+}
@@ -0,0 +1,67 @@
+#include "ShaderStats.hh"
+
+#include <algorithm>
+#include <bit>
+
+using namespace SilverBell::Renderer;
+
+void FTimingHistogram::Record(std::uint64_t Microseconds)
+{
+    const std::size_t Bucket = Microseconds == 0 ? 0 : std::min<std::size_t>(std::bit_width(Microseconds) - 1, BucketCount - 1);
+    Buckets[Bucket].fetch_add(1, std::memory_order_relaxed);
+    Count.fetch_add(1, std::memory_order_relaxed);
+    TotalMicroseconds.fetch_add(Microseconds, std::memory_order_relaxed);
+
+    std::uint64_t CurrentMax = MaxMicroseconds.load(std::memory_order_relaxed);
+    while (CurrentMax < Microseconds && !MaxMicroseconds.compare_exchange_weak(CurrentMax, Microseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+ShaderTimingSnapshot FTimingHistogram::GetSnapshot() const
+{
+    ShaderTimingSnapshot Snapshot;
+    Snapshot.Count = Count.load(std::memory_order_relaxed);
+    Snapshot.TotalMicroseconds = TotalMicroseconds.load(std::memory_order_relaxed);
+    Snapshot.MaxMicroseconds = MaxMicroseconds.load(std::memory_order_relaxed);
+
+    // 去掉末尾的空桶，输出的JSON更紧凑
+    std::size_t UsedBuckets = BucketCount;
+    while (UsedBuckets > 0 && Buckets[UsedBuckets - 1].load(std::memory_order_relaxed) == 0) --UsedBuckets;
+    Snapshot.Buckets.reserve(UsedBuckets);
+    for (std::size_t Idx = 0; Idx < UsedBuckets; ++Idx)
+    {
+        Snapshot.Buckets.push_back(Buckets[Idx].load(std::memory_order_relaxed));
+    }
+    return Snapshot;
+}
+
+void FShaderStats::AddRecord(ShaderLoadRecord Record)
+{
+    std::scoped_lock Lock(RecordMutex);
+    Records.push_back(std::move(Record));
+}
+
+ShaderStatsSnapshot FShaderStats::GetSnapshot() const
+{
+    ShaderStatsSnapshot Snapshot;
+    Snapshot.MemoryCacheHits = MemoryCacheHits.load(std::memory_order_relaxed);
+    Snapshot.MemoryCacheMisses = MemoryCacheMisses.load(std::memory_order_relaxed);
+    Snapshot.DiskCacheHits = DiskCacheHits.load(std::memory_order_relaxed);
+    Snapshot.DiskCacheMisses = DiskCacheMisses.load(std::memory_order_relaxed);
+    Snapshot.ArchiveHits = ArchiveHits.load(std::memory_order_relaxed);
+    Snapshot.CompileFailures = CompileFailures.load(std::memory_order_relaxed);
+    Snapshot.ModuleCacheHits = ModuleCacheHits.load(std::memory_order_relaxed);
+    Snapshot.ModulesCreated = ModulesCreated.load(std::memory_order_relaxed);
+    Snapshot.CompileTime = CompileTime.GetSnapshot();
+    Snapshot.ReflectTime = ReflectTime.GetSnapshot();
+    Snapshot.ModuleCreationTime = ModuleCreationTime.GetSnapshot();
+
+    std::scoped_lock Lock(RecordMutex);
+    Snapshot.Shaders = Records;
+    for (const auto& Record : Records)
+    {
+        Snapshot.TotalSPIRVBytes += Record.SPIRVBytes;
+    }
+    return Snapshot;
+}
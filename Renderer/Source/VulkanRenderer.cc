@@ -11,8 +11,11 @@
 
 #include "ImageImporter.hh"
 #include "Logger.hh"
+#include "MipGenerator.hh"
 #include "ModelImporter.hh"
 #include "ShaderManager.hh"
+#include "ShaderPermutation.hh"
+#include "TextureCooker.hh"
 
 #ifdef VK_USE_PLATFORM_WIN32_KHR
 
@@ -34,6 +37,78 @@ namespace
         "VK_LAYER_KHRONOS_validation"
     };
 
+    // 相机投影参数，LOD选择与常量缓冲共用
+    const float CameraFovY = SilverBell::Math::ToRadians(45.f);
+    const float CameraNear = 0.1f;
+    const float CameraFar = 10.0f;
+    // LOD允许的最大屏幕空间误差，单位为像素
+    const float LODMaxPixelError = 1.0f;
+
+    // 每帧最多执行的资产上传回调数量，避免一帧内上传过多造成卡顿
+    constexpr std::size_t MaxAssetUploadsPerFrame = 4;
+
+    enum class EMipSource : uint8_t
+    {
+        // 在加载线程上用FMipGenerator生成，sRGB正确
+        Cpu,
+        // 只上传第0级，其余级别在GPU上用vkCmdBlitImage生成，颜色纹理为sRGB格式，在线性空间中过滤
+        Gpu,
+    };
+
+    // 纹理mip链的生成方式
+    constexpr EMipSource TextureMipSource = EMipSource::Cpu;
+
+    // 设备支持块压缩时纹理的烘焙格式与编码质量，GPU生成mip时只能使用RGBA8
+    constexpr SilverBell::Assets::ETextureFormat CompressedTextureFormat = SilverBell::Assets::ETextureFormat::BC7;
+    constexpr SilverBell::Assets::ECompressionQuality TextureCompressionQuality = SilverBell::Assets::ECompressionQuality::Normal;
+
+    // 颜色纹理使用sRGB格式，采样、三线性过滤与blit都在线性空间进行，法线与数据纹理保持UNORM
+    VkFormat ToVkFormat(SilverBell::Assets::ETextureFormat Format, bool bSRGB)
+    {
+        using SilverBell::Assets::ETextureFormat;
+        switch (Format)
+        {
+        case ETextureFormat::BC1: return bSRGB ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        case ETextureFormat::BC3: return bSRGB ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+        // 两通道的法线贴图没有sRGB格式
+        case ETextureFormat::BC5: return VK_FORMAT_BC5_UNORM_BLOCK;
+        case ETextureFormat::BC7: return bSRGB ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        default: return bSRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+        }
+    }
+
+    // 主Pass的顶点缓冲布局，交错存储只需一个绑定，切换为Separated或PositionSplit即可对比
+    constexpr EVertexLayout MeshVertexLayout = EVertexLayout::Interleaved;
+
+    // 由ShaderArchiver根据Assets/Shaders/ShaderManifest.json离线生成的着色器包
+    const std::filesystem::path ShaderArchivePath = PROJECT_ROOT_PATH "Intermediate/Shaders.sbsa";
+
+    // 三角形Pass的像素着色器排列
+    const FShaderPermutationSet TrianglePSPermutations =
+    {
+        ShaderDesc
+        {
+            .FilePath = "Assets/Shaders/Triangle/HLSL/TrianglePS.hlsl",
+            .EntryPoint = "Main",
+            .ShaderStage = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .Defines = {}
+        },
+        { ShaderKeywordAxis::Toggle("USE_VERTEX_COLOR"), ShaderKeywordAxis::Toggle("USE_VERTEX_NORMAL") }
+    };
+
+    // 三角形Pass使用的着色器
+    const std::array<ShaderDesc, 2> TriangleShaders =
+    {
+        ShaderDesc
+        {
+            .FilePath = "Assets/Shaders/Triangle/HLSL/TriangleVS.hlsl",
+            .EntryPoint = "Main",
+            .ShaderStage = VK_SHADER_STAGE_VERTEX_BIT,
+            .Defines = {}
+        },
+        TrianglePSPermutations.Select({}),
+    };
+
     const std::vector<const char*> DeviceExtensions =
     {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
@@ -67,16 +142,17 @@ namespace
         return DebugCreateInfo;
     }
 
+    // 着色器输出线性颜色，写入sRGB格式的交换链图像时由硬件编码
     VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& AvailableFormats)
     {
         if (AvailableFormats.size() == 1 && AvailableFormats[0].format == VK_FORMAT_UNDEFINED)
         {
-            return { VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
+            return { VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR };
         }
 
         for (const auto& Format : AvailableFormats)
         {
-            if (Format.format == VK_FORMAT_B8G8R8A8_UNORM && Format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
+            if (Format.format == VK_FORMAT_B8G8R8A8_SRGB && Format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR)
             {
                 return Format;
             }
@@ -128,24 +204,33 @@ FVulkanRenderer::FVulkanRenderer() :
     SwapChainImageFormat(VK_FORMAT_UNDEFINED),
     SwapChainExtent({.width = 0, .height = 0 }),
     RenderPass(VK_NULL_HANDLE),
+    DescriptorSet(VK_NULL_HANDLE),
     GraphicsPipeline(VK_NULL_HANDLE),
     PipelineLayout(VK_NULL_HANDLE),
     CommandPool(VK_NULL_HANDLE),
     ImageAvailableSemaphore(VK_NULL_HANDLE),
     RenderFinishedSemaphore(VK_NULL_HANDLE),
-    MemoryAllocator(VMA_NULL)
+    MemoryAllocator(VMA_NULL),
+    Meshes([this](MeshResource& Mesh)
+    {
+        for (auto& Allocation : Mesh.VertexAllocations)
+        {
+            GeometryArena->Free(Allocation);
+        }
+        GeometryArena->Free(Mesh.IndexAllocation);
+    }),
+    Textures([this](TextureResource& Texture)
+    {
+        vkDestroyImageView(LogicalDevice, Texture.View, nullptr);
+        vmaDestroyImage(MemoryAllocator, Texture.Image.ImageHandle, Texture.Image.Allocation);
+    })
 {
+    AssetLoader = std::make_unique<Utility::FAssetLoader>();
 }
 
 FVulkanRenderer::~FVulkanRenderer()
 {
     CleanUp();
-
-    if (LoadedModel)
-    {
-        delete LoadedModel;
-        LoadedModel = nullptr;
-    }
 }
 
 void FVulkanRenderer::SetRequiredInstanceExtensions(const char** Exts, int Len)
@@ -161,6 +246,11 @@ void FVulkanRenderer::SetRequiredInstanceExtensions(const char** Exts, int Len)
 
 void FVulkanRenderer::CleanUp()
 {
+    // 先停止加载线程，未执行的上传回调随之丢弃
+    AssetLoader.reset();
+    // 热重载的监视线程与重新编译任务使用全局线程池，需在静态对象析构前结束
+    FShaderManager::Instance().DisableHotReload();
+
     vkDeviceWaitIdle(LogicalDevice);
     if (DebugMessenger != VK_NULL_HANDLE)
     {
@@ -168,14 +258,9 @@ void FVulkanRenderer::CleanUp()
         DebugMessenger = VK_NULL_HANDLE;
     }
     CleanupSwapChain();
-    // 销毁着色器模块
-    for (auto ShaderModule : ShaderModules)
-    {
-        vkDestroyShaderModule(LogicalDevice, ShaderModule, nullptr);
-    }
 
-    // 销毁描述符集布局
-    vkDestroyDescriptorSetLayout(LogicalDevice, DescriptorSetLayout, nullptr);
+    // 销毁着色器模块、描述符集布局和管线布局，它们由着色器管理器统一缓存
+    FShaderManager::Instance().DestroyDeviceResources(LogicalDevice);
     // 销毁描述符池
     vkDestroyDescriptorPool(LogicalDevice, DescriptorPool, nullptr);
 
@@ -183,25 +268,19 @@ void FVulkanRenderer::CleanUp()
     vkDestroySemaphore(LogicalDevice, ImageAvailableSemaphore, nullptr);
     vkDestroyCommandPool(LogicalDevice, CommandPool, nullptr);
 
-    // 销毁顶点缓冲区
-    for (auto& BufferCache : VertexBufferCaches)
-    {
-        vmaDestroyBuffer(MemoryAllocator, BufferCache.BufferHandle, BufferCache.Allocation);
-    }
-    // 销毁索引缓冲区
-    for (auto& BufferCache : IndexBufferCaches)
-    {
-        vmaDestroyBuffer(MemoryAllocator, BufferCache.BufferHandle, BufferCache.Allocation);
-    }
+    // 设备已空闲，不论引用计数销毁全部资产，再销毁几何缓冲区
+    CurrentMesh = {};
+    CurrentTexture = {};
+    Meshes.Clear();
+    Textures.Clear();
+    GeometryArena.reset();
     // 销毁常量缓冲区
     for (auto& BufferCache : ConstantBufferCaches)
     {
         vmaDestroyBuffer(MemoryAllocator, BufferCache.BufferHandle, BufferCache.Allocation);
     }
-    // 销毁纹理
-    vmaDestroyImage(MemoryAllocator, TextureImageCache.ImageHandle, TextureImageCache.Allocation);
+    // 销毁纹理采样器
     vkDestroySampler(LogicalDevice, TextureSampler, nullptr);
-    vkDestroyImageView(LogicalDevice, TextureImageView, nullptr);
 
     vmaDestroyAllocator(MemoryAllocator);
 
@@ -218,6 +297,18 @@ bool FVulkanRenderer::DrawFrame()
 {
     vkQueueWaitIdle(PresentQueue);
 
+    // 帧边界，上一帧已经提交完成，可以安全地替换着色器
+    ApplyShaderReloads();
+    // 之前提交的帧都已执行完毕，销毁在这些帧中释放的资产
+    if (FrameIndex > 0)
+    {
+        Meshes.CollectGarbage(FrameIndex - 1);
+        Textures.CollectGarbage(FrameIndex - 1);
+    }
+    ApplyAssetLoads();
+    // 相机或模型移动后所需的LOD可能变化
+    UpdateLOD();
+
     std::uint32_t ImageIndex;
     auto Result = vkAcquireNextImageKHR(LogicalDevice, SwapChain, std::numeric_limits<uint64_t>::max(), ImageAvailableSemaphore, VK_NULL_HANDLE, &ImageIndex);
 
@@ -272,12 +363,26 @@ bool FVulkanRenderer::DrawFrame()
     PresentInfo.pImageIndices = &ImageIndex;
     PresentInfo.pResults = nullptr; // Optional
     vkQueuePresentKHR(PresentQueue, &PresentInfo);
+    ++FrameIndex;
 
     return true;
 }
 
 void FVulkanRenderer::CreateInstance()
 {
+#if SHADER_ARCHIVE_ENABLE
+    if (std::filesystem::exists(ShaderArchivePath))
+    {
+        FShaderManager::Instance().MountArchive(ShaderArchivePath);
+    }
+#endif
+
+    // 着色器编译不依赖Vulkan设备，提前放到后台线程，与设备初始化并行进行
+    FShaderManager::Instance().CompileAsync(TriangleShaders);
+#if SHADER_HOT_RELOAD_ENABLE
+    FShaderManager::Instance().EnableHotReload();
+#endif
+
     if (volkInitialize() != VK_SUCCESS)
     {
         LOG_ERROR("Volk初始化失败！");
@@ -514,6 +619,12 @@ void FVulkanRenderer::CreateLogicalDevice()
     DeviceFeatures.fillModeNonSolid = VK_TRUE; // 启用非实心填充模式
     DeviceFeatures.samplerAnisotropy = VK_TRUE; // 启用各向异性过滤
 
+    // BC块压缩是可选特性，不支持时纹理烘焙为RGBA8
+    VkPhysicalDeviceFeatures SupportedFeatures;
+    vkGetPhysicalDeviceFeatures(PhysicalDevice, &SupportedFeatures);
+    DeviceFeatures.textureCompressionBC = SupportedFeatures.textureCompressionBC;
+    bTextureCompressionBC = SupportedFeatures.textureCompressionBC == VK_TRUE;
+
     // 创建逻辑设备
     VkDeviceCreateInfo DeviceCreateInfo = {};
     DeviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -684,22 +795,10 @@ void FVulkanRenderer::CreateRenderPass()
 void FVulkanRenderer::CreateGraphicsPipeline()
 {
     // 创建着色器模块
-   ShaderDesc VertexShaderDesc =
-    {
-        .FilePath = "Assets/Shaders/Triangle/HLSL/TriangleVS.hlsl",
-        .EntryPoint = "Main",
-        .ShaderStage = VK_SHADER_STAGE_VERTEX_BIT,
-        .Defines = {}
-    };
-    ShaderDesc FragmentShaderDesc =
-    {
-        .FilePath = "Assets/Shaders/Triangle/HLSL/TrianglePS.hlsl",
-        .EntryPoint = "Main",
-        .ShaderStage = VK_SHADER_STAGE_FRAGMENT_BIT,
-        .Defines = {}
-    };
-    auto FragmentShaderModule = FShaderManager::Instance().CreateShaderModule(FragmentShaderDesc, LogicalDevice);
-    auto VertexShaderModule = FShaderManager::Instance().CreateShaderModule(VertexShaderDesc, LogicalDevice);
+    const ShaderDesc& VertexShaderDesc = TriangleShaders[0];
+    const ShaderDesc& FragmentShaderDesc = TriangleShaders[1];
+    auto FragmentShaderModule = FShaderManager::Instance().AcquireShaderModule(FragmentShaderDesc, LogicalDevice);
+    auto VertexShaderModule = FShaderManager::Instance().AcquireShaderModule(VertexShaderDesc, LogicalDevice);
     VkPipelineShaderStageCreateInfo VertexShaderStageInfo = {};
     VertexShaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     VertexShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
@@ -716,8 +815,8 @@ void FVulkanRenderer::CreateGraphicsPipeline()
     ShaderModules.push_back(VertexShaderModule);
 
 
-    auto AttributeDescriptions = GetAttributeDescriptions<Assets::BaseMesh>();
-    auto BindingBindingDescriptions = GetBindingDescriptions<Assets::BaseMesh>();
+    auto AttributeDescriptions = GetAttributeDescriptions<Assets::QuantizedMesh, MeshVertexLayout>();
+    auto BindingBindingDescriptions = GetBindingDescriptions<Assets::QuantizedMesh, MeshVertexLayout>();
     // 顶点输入状态
     VkPipelineVertexInputStateCreateInfo VertexInputInfo = {};
     VertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -809,18 +908,7 @@ void FVulkanRenderer::CreateGraphicsPipeline()
     DynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
     DynamicState.dynamicStateCount = 0; // 视口和裁剪
     //DynamicState.pDynamicStates = DynamicStates;
-    // 创建管线布局
-    VkPipelineLayoutCreateInfo PipelineLayoutInfo = {};
-    PipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    PipelineLayoutInfo.setLayoutCount = 1;
-    PipelineLayoutInfo.pSetLayouts = &DescriptorSetLayout;
-    PipelineLayoutInfo.pushConstantRangeCount = 0; // 如果没有推送常量范围
-    PipelineLayoutInfo.pPushConstantRanges = nullptr; // 没有推送常量范围
-    if (vkCreatePipelineLayout(LogicalDevice, &PipelineLayoutInfo, nullptr, &PipelineLayout) != VK_SUCCESS)
-    {
-        LOG_ERROR("创建管线布局失败！");
-        throw std::runtime_error("Failed to create pipeline layout!");
-    }
+    // 管线布局由反射信息生成，见 CreateDescriptorSetLayout
 
     VkGraphicsPipelineCreateInfo PipelineCreateInfo = {};
     PipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
@@ -885,42 +973,128 @@ void FVulkanRenderer::CreateDepthResources()
 
 void FVulkanRenderer::CreateTextureImage()
 {
-    auto ImportInfo = FImageImporter::ImportImage("Assets/Models/viking_room.png");
-    if (ImportInfo.has_value())
+    // 加载完成前使用白色占位纹理
+    constexpr unsigned char PlaceholderPixel[4] = { 255, 255, 255, 255 };
+    CurrentTexture = Textures.Acquire("Builtin/WhiteTexture", [this, &PlaceholderPixel]()
     {
-        VkDeviceSize ImageSize = static_cast<VkDeviceSize>(ImportInfo->Width) * ImportInfo->Height * 4;
+        const auto Mips = Assets::FMipGenerator::Generate(PlaceholderPixel, 1, 1);
+        return UploadTexture(VK_FORMAT_R8G8B8A8_SRGB, Mips.Pixels, Mips.Levels);
+    });
 
-        auto BufferCache = CreateBufferPack(ImageSize, MemoryAllocator, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VMA_MEMORY_USAGE_CPU_ONLY, 0);
+    RequestTexture("Assets/Models/viking_room.png");
+}
 
-        void* Data;
-        vmaMapMemory(MemoryAllocator, BufferCache[0].Allocation, &Data);
-        std::memcpy(Data, ImportInfo->Pixels, ImageSize);
-        vmaUnmapMemory(MemoryAllocator, BufferCache[0].Allocation);
-        FImageImporter::FreeImage(ImportInfo.value());
-
-        VMAImgCreateInfo CreateInfo = {};
-        CreateInfo.Width = ImportInfo->Width;
-        CreateInfo.Height = ImportInfo->Height;
-        CreateInfo.Format = VK_FORMAT_R8G8B8A8_UNORM;
-        CreateInfo.Usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-        CreateInfo.MemoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
-        CreateInfo.AllocationCreateFlags = 0;
-
-        TextureImageCache = CreateImage(MemoryAllocator, CreateInfo);
-        TransitionImageLayout(TextureImageCache.ImageHandle, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-        CopyBufferToImage(BufferCache[0], TextureImageCache);
-        // 为了了在着色器中读取纹理，我们需要将图像布局转换为着色器读取专用
-        TransitionImageLayout(TextureImageCache.ImageHandle, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+void FVulkanRenderer::RequestTexture(std::string_view Path)
+{
+    if (!Textures.BeginLoad(Path, [this](Assets::AssetHandle<TextureResource> Handle) { SetTexture(Handle); }))
+    {
+        return;
+    }
+
+    Assets::TextureCookSettings CookSettings;
+    CookSettings.bGenerateMips = TextureMipSource == EMipSource::Cpu;
+    CookSettings.Format = bTextureCompressionBC && CookSettings.bGenerateMips ? CompressedTextureFormat : Assets::ETextureFormat::RGBA8;
+    CookSettings.Quality = TextureCompressionQuality;
 
-        // 清理临时缓冲区
-        vmaDestroyBuffer(MemoryAllocator, BufferCache[0].BufferHandle, BufferCache[0].Allocation);
+    // 纹理属于当前模型，包围体未知的加载阶段以模型原点估计位置
+    const Math::Vec3 LocalPosition = Math::Vec3::Zero();
+    const auto Id = AssetLoader->Submit(ComputeLoadPriority(LocalPosition), [FilePath = std::string(Path), CookSettings]()
+        -> std::optional<Assets::CookedTexture>
+    {
+        // 解码、生成mip与块压缩都在加载线程上进行，结果缓存在磁盘上
+        // 异常也要作为失败返回，否则注册表中的加载永远不会结束
+        try
+        {
+            return Assets::FTextureCooker::Cook(FilePath, CookSettings);
+        }
+        catch (const std::exception& Exception)
+        {
+            LOG_WARN("纹理加载失败: {}, {}", FilePath, Exception.what());
+            return std::nullopt;
+        }
+    },
+    [this, FilePath = std::string(Path), bSRGB = CookSettings.MipOptions.bSRGB](std::optional<Assets::CookedTexture> Cooked)
+    {
+        std::unique_ptr<TextureResource> Texture;
+        if (Cooked.has_value())
+        {
+            // 按sRGB烘焙的颜色纹理以sRGB格式上传
+            Texture = UploadTexture(ToVkFormat(Cooked->Format, bSRGB), Cooked->Data, Cooked->Levels);
+        }
+        // 加载期间同一纹理的请求都在这里收到句柄，失败时保留当前纹理
+        Textures.FinishLoad(FilePath, std::move(Texture));
+    });
+    PendingAssetLoads.push_back({ Id, LocalPosition });
+}
+
+std::unique_ptr<FVulkanRenderer::TextureResource> FVulkanRenderer::UploadTexture(VkFormat TextureFormat, std::span<const unsigned char> Pixels, std::span<const Assets::MipLevel> Levels)
+{
+    const Assets::MipLevel& BaseLevel = Levels[0];
+    const uint32_t FilledLevelCount = static_cast<uint32_t>(Levels.size());
+    const uint32_t FullLevelCount = Assets::FMipGenerator::GetMipLevelCount(BaseLevel.Width, BaseLevel.Height);
+    const bool bBlitMips = FilledLevelCount < FullLevelCount && SupportsLinearBlit(TextureFormat);
+    if (FilledLevelCount < FullLevelCount && !bBlitMips)
+    {
+        LOG_WARN("纹理格式不支持线性过滤的blit，只使用已有的{}级mip", FilledLevelCount);
     }
+
+    const VkDeviceSize ImageSize = Pixels.size();
+    auto BufferCache = CreateBufferPack(ImageSize, MemoryAllocator, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VMA_MEMORY_USAGE_CPU_ONLY, 0);
+
+    void* Data;
+    vmaMapMemory(MemoryAllocator, BufferCache[0].Allocation, &Data);
+    std::memcpy(Data, Pixels.data(), ImageSize);
+    vmaUnmapMemory(MemoryAllocator, BufferCache[0].Allocation);
+
+    VMAImgCreateInfo CreateInfo = {};
+    CreateInfo.Width = BaseLevel.Width;
+    CreateInfo.Height = BaseLevel.Height;
+    CreateInfo.MipLevels = bBlitMips ? FullLevelCount : FilledLevelCount;
+    CreateInfo.Format = TextureFormat;
+    // blit时每一级先作为目标再作为源
+    CreateInfo.Usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    CreateInfo.MemoryUsage = VMA_MEMORY_USAGE_GPU_ONLY;
+    CreateInfo.AllocationCreateFlags = 0;
+
+    auto Texture = std::make_unique<TextureResource>();
+    Texture->Image = CreateImage(MemoryAllocator, CreateInfo);
+    TransitionImageLayout(Texture->Image.ImageHandle, TextureFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, CreateInfo.MipLevels);
+    CopyBufferToImage(BufferCache[0], Texture->Image, Levels);
+    if (bBlitMips)
+    {
+        GenerateMipmaps(Texture->Image, FilledLevelCount);
+    }
+    else
+    {
+        // 为了了在着色器中读取纹理，我们需要将图像布局转换为着色器读取专用
+        TransitionImageLayout(Texture->Image.ImageHandle, TextureFormat, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, CreateInfo.MipLevels);
+    }
+    Texture->View = CreateImageView(Texture->Image.ImageHandle, TextureFormat, VK_IMAGE_ASPECT_COLOR_BIT, CreateInfo.MipLevels);
+
+    // 清理临时缓冲区
+    vmaDestroyBuffer(MemoryAllocator, BufferCache[0].BufferHandle, BufferCache[0].Allocation);
+    return Texture;
 }
 
-void FVulkanRenderer::CreateTextureImageView()
+void FVulkanRenderer::SetTexture(Assets::AssetHandle<TextureResource> NewTexture)
 {
-    TextureImageView = CreateImageView(TextureImageCache.ImageHandle, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT);
+    if (Textures.Get(NewTexture) == nullptr) return;
+
+    // 命令缓冲可能仍在使用旧的描述符，更新前等待设备空闲
+    if (DescriptorSet != VK_NULL_HANDLE)
+    {
+        vkDeviceWaitIdle(LogicalDevice);
+    }
+
+    Textures.Release(CurrentTexture, FrameIndex);
+    CurrentTexture = NewTexture;
+
+    // 描述符集尚未创建时由CreateDescriptorSet写入
+    if (DescriptorSet != VK_NULL_HANDLE)
+    {
+        WriteDescriptorSet(true);
+    }
 }
 
 void FVulkanRenderer::CreateTextureSampler()
@@ -941,7 +1115,7 @@ void FVulkanRenderer::CreateTextureSampler()
     SamplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR; // 线性mipmap过滤
     SamplerCreateInfo.mipLodBias = 0.0f; // LOD偏差
     SamplerCreateInfo.minLod = 0.0f; // 最小LOD
-    SamplerCreateInfo.maxLod = 0.0f; // 最大LOD
+    SamplerCreateInfo.maxLod = VK_LOD_CLAMP_NONE; // 最大LOD，不限制，由图像视图的mip级数决定
     if (vkCreateSampler(LogicalDevice, &SamplerCreateInfo, nullptr, &TextureSampler) != VK_SUCCESS)
     {
         LOG_ERROR("创建纹理采样器失败！");
@@ -950,68 +1124,126 @@ void FVulkanRenderer::CreateTextureSampler()
 
 void FVulkanRenderer::CreateVertexBuffers()
 {
-    auto Model = FModelImporter::ImporterModel("Assets/Models/viking_room.obj");
+    // 模型在加载线程上导入，完成前不绘制
+    RequestModel("Assets/Models/viking_room.obj");
+}
 
-    if (Model == nullptr)return;;
+void FVulkanRenderer::RequestModel(std::string_view Path)
+{
+    if (!Meshes.BeginLoad(Path, [this](Assets::AssetHandle<MeshResource> Handle) { SetModel(Handle); }))
+    {
+        return;
+    }
 
-    LoadedModel = Model;
-    const auto& Mesh = Model->MeshData;
+    // 包围体未知的加载阶段以模型原点估计位置
+    const Math::Vec3 LocalPosition = Math::Vec3::Zero();
+    const auto Id = AssetLoader->Submit(ComputeLoadPriority(LocalPosition), [FilePath = std::string(Path)]()
+        -> std::unique_ptr<Model>
+    {
+        // 异常也要作为失败返回，否则注册表中的加载永远不会结束
+        try
+        {
+            return FModelImporter::ImporterModel(FilePath);
+        }
+        catch (const std::exception& Exception)
+        {
+            LOG_WARN("模型加载失败: {}, {}", FilePath, Exception.what());
+            return nullptr;
+        }
+    },
+    [this, FilePath = std::string(Path)](std::unique_ptr<Model> NewModel)
+    {
+        std::unique_ptr<MeshResource> Mesh;
+        if (NewModel != nullptr)
+        {
+            Mesh = UploadMesh(std::move(NewModel));
+        }
+        // 加载期间同一模型的请求都在这里收到句柄
+        Meshes.FinishLoad(FilePath, std::move(Mesh));
+    });
+    PendingAssetLoads.push_back({ Id, LocalPosition });
+}
 
-    // 创建临时缓冲区
-    StagingBufferCaches = CreateBuffer(Mesh, MemoryAllocator, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VMA_MEMORY_USAGE_CPU_ONLY, 0);
+void FVulkanRenderer::SetModel(Assets::AssetHandle<MeshResource> NewMesh)
+{
+    if (Meshes.Get(NewMesh) == nullptr) return;
+
+    Meshes.Release(CurrentMesh, FrameIndex);
+    CurrentMesh = NewMesh;
+
+    // 初始化阶段命令缓冲尚未创建
+    if (!CommandBuffers.empty())
+    {
+        // 等待使用旧命令缓冲的帧执行完毕后重新录制
+        vkDeviceWaitIdle(LogicalDevice);
+        vkFreeCommandBuffers(LogicalDevice, CommandPool, static_cast<uint32_t>(CommandBuffers.size()), CommandBuffers.data());
+        CreateCommandBuffers();
+    }
+}
+
+std::unique_ptr<FVulkanRenderer::MeshResource> FVulkanRenderer::UploadMesh(std::unique_ptr<Model> NewModel)
+{
+    auto Mesh = std::make_unique<MeshResource>();
+    Mesh->Data = std::move(NewModel);
+    const Model& MeshModel = *Mesh->Data;
+
+    // 从网格缓存加载时顶点流直接来自映射的文件，按布局打包后直接写入暂存缓冲
+    std::array<std::span<const std::byte>, SilverBell::Model::VertexStreamCount> Streams;
+    for (std::size_t Stream = 0; Stream < Streams.size(); ++Stream)
+    {
+        Streams[Stream] = MeshModel.GetVertexStream(Stream);
+    }
+    const auto VertexLayout = GetVertexLayout<Assets::QuantizedMesh, MeshVertexLayout>();
+    const std::size_t VertexCount = Streams[0].size() / VertexLayout.ElementSizes[0];
+
+    StagingBufferCaches.clear();
+    for (uint32_t Binding = 0; Binding < VertexLayout.BindingCount; ++Binding)
+    {
+        const std::size_t BufferSize = VertexCount * VertexLayout.Strides[Binding];
+
+        // 创建临时缓冲区并写入顶点数据
+        auto StagingBufferCache = CreateBufferPack(BufferSize, MemoryAllocator, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VMA_MEMORY_USAGE_CPU_ONLY, 0);
+        void* Data = nullptr;
+        vmaMapMemory(MemoryAllocator, StagingBufferCache[0].Allocation, &Data);
+        PackVertexStreams(VertexLayout, Streams, Binding, std::span(static_cast<std::byte*>(Data), BufferSize));
+        vmaUnmapMemory(MemoryAllocator, StagingBufferCache[0].Allocation);
+        StagingBufferCaches.push_back(StagingBufferCache[0]);
+
+        // 按步长对齐，偏移恰好是整数个顶点，之后可以改为用vertexOffset区分网格
+        Mesh->VertexAllocations.push_back(GeometryArena->Allocate(BufferSize, VertexLayout.Strides[Binding]));
+        CopyBufferToArena(StagingBufferCache[0], Mesh->VertexAllocations.back());
+    }
 
-    // 写入顶点数据
-    void* Data = nullptr;
-    std::size_t DataSize = StagingBufferCaches[0].BufferSize;
-    vmaMapMemory(MemoryAllocator, StagingBufferCaches[0].Allocation, &Data);
-    std::memcpy(Data, (void*)Mesh.Positions.data(), DataSize);
-    vmaUnmapMemory(MemoryAllocator, StagingBufferCaches[0].Allocation);
-    Data = nullptr;
-    DataSize = StagingBufferCaches[1].BufferSize;
-    vmaMapMemory(MemoryAllocator, StagingBufferCaches[1].Allocation, &Data);
-    std::memcpy(Data, (void*)Mesh.Color.data(), DataSize);
-    vmaUnmapMemory(MemoryAllocator, StagingBufferCaches[1].Allocation);
-    Data = nullptr;
-    DataSize = StagingBufferCaches[2].BufferSize;
-    vmaMapMemory(MemoryAllocator, StagingBufferCaches[2].Allocation, &Data);
-    std::memcpy(Data, (void*)Mesh.TexCoord.data(), DataSize);
-    vmaUnmapMemory(MemoryAllocator, StagingBufferCaches[2].Allocation);
-
-    // 创建顶点缓冲区
-    VertexBufferCaches = CreateBuffer(Mesh, MemoryAllocator,
-        static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT),
-        VMA_MEMORY_USAGE_GPU_ONLY, 0);
-
-    CopyBuffer(StagingBufferCaches, VertexBufferCaches);
     // 销毁临时缓冲区
     for (const auto& BufferCache : StagingBufferCaches)
     {
         vmaDestroyBuffer(MemoryAllocator, BufferCache.BufferHandle, BufferCache.Allocation);
     }
-}
+    StagingBufferCaches.clear();
 
-void FVulkanRenderer::CreateIndexBuffer()
-{
-    //// 创建临时缓冲区
-    //StagingBufferCaches = CreateBuffer(Assets::TestTriangleMeshIndices, MemoryAllocator, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-    //    VMA_MEMORY_USAGE_CPU_ONLY, 0);
-    //// 写入顶点索引数据
-    //void* Data = nullptr;
-    //std::size_t DataSize = StagingBufferCaches[0].BufferSize;
-    //vmaMapMemory(MemoryAllocator, StagingBufferCaches[0].Allocation, &Data);
-    //std::memcpy(Data, (void*)Assets::TestTriangleMeshIndices.Indices.data(), DataSize);
-    //vmaUnmapMemory(MemoryAllocator, StagingBufferCaches[0].Allocation);
-
-    //IndexBufferCaches = CreateBuffer(Assets::TestTriangleMeshIndices, MemoryAllocator, 
-    //    static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT),
-    //    VMA_MEMORY_USAGE_GPU_ONLY, 0);
-    //CopyBuffer(StagingBufferCaches, IndexBufferCaches);
-    //// 销毁临时缓冲区
-    //for (const auto& BufferCache : StagingBufferCaches)
-    //{
-    //    vmaDestroyBuffer(MemoryAllocator, BufferCache.Buffer, BufferCache.Allocation);
-    //}
+    const auto IndexData = MeshModel.GetIndexData();
+    const std::size_t DataSize = IndexData.size();
+    Mesh->IndexType = MeshModel.Is16BitIndex() ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+    // 创建临时缓冲区
+    auto IndexStagingBufferCaches = CreateBufferPack(DataSize, MemoryAllocator, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VMA_MEMORY_USAGE_CPU_ONLY, 0);
+    // 写入顶点索引数据
+    void* Data = nullptr;
+    vmaMapMemory(MemoryAllocator, IndexStagingBufferCaches[0].Allocation, &Data);
+    std::memcpy(Data, IndexData.data(), DataSize);
+    vmaUnmapMemory(MemoryAllocator, IndexStagingBufferCaches[0].Allocation);
+
+    // 偏移需为索引宽度的整数倍
+    Mesh->IndexAllocation = GeometryArena->Allocate(DataSize, Mesh->IndexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t));
+    CopyBufferToArena(IndexStagingBufferCaches[0], Mesh->IndexAllocation);
+    // 销毁临时缓冲区
+    for (const auto& BufferCache : IndexStagingBufferCaches)
+    {
+        vmaDestroyBuffer(MemoryAllocator, BufferCache.BufferHandle, BufferCache.Allocation);
+    }
+    return Mesh;
 }
 
 
@@ -1026,13 +1258,16 @@ void FVulkanRenderer::UpdateBuffer(const double Time)
     Math::Vec3 EulerAngle(0.0f, 0.0f, static_cast<float>(Time) * 90.0f);
     Assets::TestTriangleMeshUniformBufferObject.Model.block<3, 3>(0, 0)
         = Math::ToQuaternion(EulerAngle).normalized().toRotationMatrix();
-    Assets::TestTriangleMeshUniformBufferObject.View = Math::LookAt(Math::Vec3(2.0f, 2.0f, 2.0f), 
-                                                                  Math::Vec3(0.0f, 0.0f, 0.0f), 
-                                                                     Math::Vec3(0.0f, 0.0f, 1.0f));
+    Assets::TestTriangleMeshUniformBufferObject.View = Math::LookAt(CameraEye, CameraTarget, Math::Vec3(0.0f, 0.0f, 1.0f));
     Assets::TestTriangleMeshUniformBufferObject.Projection
-        = Math::Perspective(Math::ToRadians(45.f), SwapChainExtent.width / (float)SwapChainExtent.height, 0.1f, 10.0f);
+        = Math::Perspective(CameraFovY, SwapChainExtent.width / (float)SwapChainExtent.height, CameraNear, CameraFar);
 
     Assets::TestTriangleMeshUniformBufferObject.Projection(1, 1) *= -1; //Vulkan 的NDC是向下
+    if (const MeshResource* Mesh = Meshes.Get(CurrentMesh))
+    {
+        Assets::TestTriangleMeshUniformBufferObject.PositionScale = Mesh->Data->Quantization.PositionScale;
+        Assets::TestTriangleMeshUniformBufferObject.PositionBias = Mesh->Data->Quantization.PositionBias;
+    }
 
     void* Data = nullptr;
     vmaMapMemory(MemoryAllocator, ConstantBufferCaches[0].Allocation, &Data);
@@ -1042,11 +1277,24 @@ void FVulkanRenderer::UpdateBuffer(const double Time)
 
 void FVulkanRenderer::CreateDescriptorPool()
 {
-    std::array<VkDescriptorPoolSize, 2> PoolSizes = {};
-    PoolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    PoolSizes[0].descriptorCount = 1; // 假设只需要一个描述符
-    PoolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    PoolSizes[1].descriptorCount = 1; // 假设只需要一个
+    // 根据反射得到的绑定统计每种描述符的数量
+    const auto& LayoutInfo = FShaderManager::Instance().GetOrCreatePipelineLayout(TriangleShaders, LogicalDevice);
+    std::vector<VkDescriptorPoolSize> PoolSizes;
+    for (const auto& Bindings : LayoutInfo.SetBindings)
+    {
+        for (const auto& Binding : Bindings)
+        {
+            auto Iter = std::ranges::find(PoolSizes, Binding.descriptorType, &VkDescriptorPoolSize::type);
+            if (Iter != PoolSizes.end())
+            {
+                Iter->descriptorCount += Binding.descriptorCount;
+            }
+            else
+            {
+                PoolSizes.push_back({ .type = Binding.descriptorType, .descriptorCount = Binding.descriptorCount });
+            }
+        }
+    }
 
     VkDescriptorPoolCreateInfo PoolCreateInfo = {};
     PoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -1072,33 +1320,51 @@ void FVulkanRenderer::CreateDescriptorSet()
         LOG_ERROR("分配描述符集失败！");
         throw std::runtime_error("Failed to allocate descriptor set!");
     }
+    WriteDescriptorSet(false);
+}
+
+void FVulkanRenderer::WriteDescriptorSet(bool bImagesOnly)
+{
     VkDescriptorBufferInfo BufferInfo = {};
     BufferInfo.buffer = ConstantBufferCaches[0].BufferHandle;
     BufferInfo.offset = 0;
     BufferInfo.range = sizeof(Assets::TestTriangleMeshUniformBufferObject);
 
+    // 采样器类型的描述符忽略imageView，图像类型的描述符忽略sampler，三种图像相关类型共用一份
     VkDescriptorImageInfo ImageInfo = {};
     ImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    ImageInfo.imageView = TextureImageView;
+    ImageInfo.imageView = Textures.Get(CurrentTexture)->View;
     ImageInfo.sampler = TextureSampler;
 
-    std::array<VkWriteDescriptorSet, 2> DescriptorWrites = {};
-    DescriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    DescriptorWrites[0].dstSet = DescriptorSet;
-    DescriptorWrites[0].dstBinding = 0;
-    DescriptorWrites[0].dstArrayElement = 0;
-    DescriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    DescriptorWrites[0].descriptorCount = 1;
-    DescriptorWrites[0].pBufferInfo = &BufferInfo;
-
-    DescriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    DescriptorWrites[1].dstSet = DescriptorSet;
-    DescriptorWrites[1].dstBinding = 1;
-    DescriptorWrites[1].dstArrayElement = 0;
-    DescriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    DescriptorWrites[1].descriptorCount = 1; 
-    DescriptorWrites[1].pImageInfo = &ImageInfo;
-
+    // 按反射得到的set 0绑定写入，三角形Pass只有一个常量缓冲与一张纹理
+    const auto& LayoutInfo = FShaderManager::Instance().GetOrCreatePipelineLayout(TriangleShaders, LogicalDevice);
+    std::vector<VkWriteDescriptorSet> DescriptorWrites;
+    for (const auto& Binding : LayoutInfo.SetBindings[0])
+    {
+        VkWriteDescriptorSet DescriptorWrite = {};
+        DescriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        DescriptorWrite.dstSet = DescriptorSet;
+        DescriptorWrite.dstBinding = Binding.binding;
+        DescriptorWrite.dstArrayElement = 0;
+        DescriptorWrite.descriptorType = Binding.descriptorType;
+        DescriptorWrite.descriptorCount = 1;
+        switch (Binding.descriptorType)
+        {
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            if (bImagesOnly) continue;
+            DescriptorWrite.pBufferInfo = &BufferInfo;
+            break;
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+        case VK_DESCRIPTOR_TYPE_SAMPLER:
+            DescriptorWrite.pImageInfo = &ImageInfo;
+            break;
+        default:
+            LOG_WARN("三角形Pass不支持的描述符类型: {}，binding: {}", static_cast<int>(Binding.descriptorType), Binding.binding);
+            continue;
+        }
+        DescriptorWrites.push_back(DescriptorWrite);
+    }
     vkUpdateDescriptorSets(LogicalDevice, static_cast<uint32_t>(DescriptorWrites.size()), DescriptorWrites.data(), 0, nullptr);
 }
 
@@ -1115,6 +1381,18 @@ void FVulkanRenderer::CreateCommandBuffers()
         LOG_ERROR("分配命令缓冲失败！");
         throw std::runtime_error("Failed to allocate command buffers!");
     }
+
+    // 录制当前所需的LOD，之后每帧由UpdateLOD检查，层级变化时重新录制
+    // 模型尚未加载完成时只录制清屏
+    const MeshResource* Mesh = Meshes.Get(CurrentMesh);
+    const Assets::MeshLOD* LOD = nullptr;
+    if (Mesh)
+    {
+        RecordedLODLevel = SelectLODLevel(*Mesh);
+        LOD = &Mesh->Data->LODChain.Levels[RecordedLODLevel];
+        LOG_DEBUG("选择LOD{}，三角形数: {}", RecordedLODLevel, LOD->IndexCount / 3);
+    }
+
     for (size_t Idx = 0; Idx < CommandBuffers.size(); ++Idx)
     {
         VkCommandBufferBeginInfo BeginInfo = {};
@@ -1140,16 +1418,23 @@ void FVulkanRenderer::CreateCommandBuffers()
         RenderPassInfo.clearValueCount = static_cast<uint32_t>(ClearValues.size());
         RenderPassInfo.pClearValues = ClearValues.data();
         vkCmdBindPipeline(CommandBuffers[Idx], VK_PIPELINE_BIND_POINT_GRAPHICS, GraphicsPipeline);
-
-        // 绑定顶点缓冲区
-        std::vector<VkBuffer> VertexBuffers(VertexBufferCaches.size());
-        for (int I = 0; I < VertexBuffers.size(); ++I)VertexBuffers[I] = VertexBufferCaches[I].BufferHandle;
-        VkDeviceSize OffSets[] = {0, 0, 0};
-        vkCmdBindVertexBuffers(CommandBuffers[Idx], 0, static_cast<uint32_t>(VertexBuffers.size()), VertexBuffers.data(), OffSets);
-        //vkCmdBindIndexBuffer(CommandBuffers[Idx], IndexBufferCaches[0].Buffer, 0, VK_INDEX_TYPE_UINT32);
-        vkCmdBindDescriptorSets(CommandBuffers[Idx], VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayout, 0, 1, &DescriptorSet, 0, nullptr);
         vkCmdBeginRenderPass(CommandBuffers[Idx], &RenderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-        vkCmdDraw(CommandBuffers[Idx], LoadedModel->MeshData.Positions.size(), 1, 0, 0); // 绘制一个三角形
+        if (LOD)
+        {
+            // 绑定几何缓冲区中模型所在的范围
+            const auto& VertexAllocations = Mesh->VertexAllocations;
+            std::vector<VkBuffer> VertexBuffers(VertexAllocations.size());
+            std::vector<VkDeviceSize> OffSets(VertexAllocations.size());
+            for (std::size_t I = 0; I < VertexAllocations.size(); ++I)
+            {
+                VertexBuffers[I] = GeometryArena->GetBuffer(VertexAllocations[I].PageIndex);
+                OffSets[I] = VertexAllocations[I].Offset;
+            }
+            vkCmdBindVertexBuffers(CommandBuffers[Idx], 0, static_cast<uint32_t>(VertexBuffers.size()), VertexBuffers.data(), OffSets.data());
+            vkCmdBindIndexBuffer(CommandBuffers[Idx], GeometryArena->GetBuffer(Mesh->IndexAllocation.PageIndex), Mesh->IndexAllocation.Offset, Mesh->IndexType);
+            vkCmdBindDescriptorSets(CommandBuffers[Idx], VK_PIPELINE_BIND_POINT_GRAPHICS, PipelineLayout, 0, 1, &DescriptorSet, 0, nullptr);
+            vkCmdDrawIndexed(CommandBuffers[Idx], LOD->IndexCount, 1, LOD->IndexOffset, 0, 0);
+        }
         vkCmdEndRenderPass(CommandBuffers[Idx]);
         if (vkEndCommandBuffer(CommandBuffers[Idx]) != VK_SUCCESS)
         {
@@ -1159,6 +1444,44 @@ void FVulkanRenderer::CreateCommandBuffers()
     }
 }
 
+void FVulkanRenderer::SetCamera(const Math::Vec3& Eye, const Math::Vec3& Target)
+{
+    CameraEye = Eye;
+    CameraTarget = Target;
+}
+
+float FVulkanRenderer::ComputeLoadPriority(const Math::Vec3& LocalPosition) const
+{
+    // 离相机越近的资产越先加载
+    const Math::Mat4& ModelMatrix = Assets::TestTriangleMeshUniformBufferObject.Model;
+    const Math::Vec3 WorldPosition = (ModelMatrix * LocalPosition.homogeneous()).head<3>();
+    return (CameraEye - WorldPosition).norm();
+}
+
+std::size_t FVulkanRenderer::SelectLODLevel(const MeshResource& Mesh) const
+{
+    // 按模型包围球离相机最近处的屏幕空间误差选择，包围球随模型当前的变换移动与缩放
+    const auto& LODChain = Mesh.Data->LODChain;
+    const Math::Mat4& ModelMatrix = Assets::TestTriangleMeshUniformBufferObject.Model;
+    const Math::Vec3 ModelCenter = (ModelMatrix * LODChain.BoundingSphere.head<3>().homogeneous()).head<3>();
+    const float ModelRadius = LODChain.BoundingSphere.w() * ModelMatrix.block<3, 3>(0, 0).colwise().norm().maxCoeff();
+    const float ModelDistance = std::max((CameraEye - ModelCenter).norm() - ModelRadius, CameraNear);
+    const float ProjectionScale = SwapChainExtent.height / (2.0f * std::tan(CameraFovY * 0.5f));
+    return LODChain.SelectLevel(ModelDistance, ProjectionScale, LODMaxPixelError);
+}
+
+void FVulkanRenderer::UpdateLOD()
+{
+    const MeshResource* Mesh = Meshes.Get(CurrentMesh);
+    if (Mesh == nullptr || CommandBuffers.empty()) return;
+    // 投影误差跨过阈值时才重新录制，层级不变的帧不产生额外开销
+    if (SelectLODLevel(*Mesh) == RecordedLODLevel) return;
+
+    vkDeviceWaitIdle(LogicalDevice);
+    vkFreeCommandBuffers(LogicalDevice, CommandPool, static_cast<uint32_t>(CommandBuffers.size()), CommandBuffers.data());
+    CreateCommandBuffers();
+}
+
 void FVulkanRenderer::CreateSemaphores()
 {
     VkSemaphoreCreateInfo SemaphoreInfo = {};
@@ -1186,6 +1509,49 @@ void FVulkanRenderer::RecreateSwapChain(int Width, int Height)
     CreateCommandBuffers();
 }
 
+void FVulkanRenderer::ApplyShaderReloads()
+{
+    const auto ReloadedDescs = FShaderManager::Instance().ConsumeReloadedShaders();
+    const bool bAffected = std::ranges::any_of(ReloadedDescs, [](const ShaderDesc& Desc)
+    {
+        return std::ranges::find(TriangleShaders, Desc) != TriangleShaders.end();
+    });
+    if (!bAffected) return;
+
+    // 注：只重建管线，资源绑定发生变化时仍然需要重启
+    vkDeviceWaitIdle(LogicalDevice);
+    vkFreeCommandBuffers(LogicalDevice, CommandPool, static_cast<uint32_t>(CommandBuffers.size()), CommandBuffers.data());
+    vkDestroyPipeline(LogicalDevice, GraphicsPipeline, nullptr);
+    for (auto ShaderModule : ShaderModules)
+    {
+        FShaderManager::Instance().ReleaseShaderModule(ShaderModule);
+    }
+    ShaderModules.clear();
+    // 旧版本着色器的模块不会再被使用
+    FShaderManager::Instance().PurgeUnusedShaderModules(LogicalDevice);
+
+    CreateGraphicsPipeline();
+    CreateCommandBuffers();
+    LOG_INFO("着色器热重载完成，已重建图形管线");
+}
+
+void FVulkanRenderer::ApplyAssetLoads()
+{
+    if (AssetLoader == nullptr) return;
+
+    // 按本帧的相机与模型变换调整优先级，已开始加载的请求不再跟踪
+    std::erase_if(PendingAssetLoads, [this](const PendingAssetLoad& Load)
+    {
+        return !AssetLoader->UpdatePriority(Load.Id, ComputeLoadPriority(Load.LocalPosition));
+    });
+
+    const std::size_t Count = AssetLoader->PumpCompletions(MaxAssetUploadsPerFrame);
+    if (Count > 0)
+    {
+        LOG_DEBUG("本帧上传资产: {}，剩余请求: {}", Count, AssetLoader->GetOutstandingCount());
+    }
+}
+
 void FVulkanRenderer::CleanupSwapChain()
 {
     vkDestroyImageView(LogicalDevice, DepthImageView, nullptr);
@@ -1198,9 +1564,15 @@ void FVulkanRenderer::CleanupSwapChain()
     }
 
     vkDestroyPipeline(LogicalDevice, GraphicsPipeline, nullptr);
-    vkDestroyPipelineLayout(LogicalDevice, PipelineLayout, nullptr);
     vkDestroyRenderPass(LogicalDevice, RenderPass, nullptr);
 
+    // 管线重建时会重新获取着色器模块，缓存中的模块会被直接复用
+    for (auto ShaderModule : ShaderModules)
+    {
+        FShaderManager::Instance().ReleaseShaderModule(ShaderModule);
+    }
+    ShaderModules.clear();
+
     for (auto ImageView : SwapChainImageViews)
     {
         vkDestroyImageView(LogicalDevice, ImageView, nullptr);
@@ -1235,31 +1607,17 @@ void FVulkanRenderer::CreateFramebuffers()
 
 void FVulkanRenderer::CreateDescriptorSetLayout()
 {
-    VkDescriptorSetLayoutBinding CBufferLayoutBinding = {};
-    CBufferLayoutBinding.binding = 0;
-    CBufferLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    CBufferLayoutBinding.descriptorCount = 1;
-    CBufferLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    CBufferLayoutBinding.pImmutableSamplers = nullptr; // 可选
-
-    VkDescriptorSetLayoutBinding SamplerLayoutBinding = {};
-    SamplerLayoutBinding.binding = 1;
-    SamplerLayoutBinding.descriptorCount = 1;
-    SamplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    SamplerLayoutBinding.pImmutableSamplers = nullptr;
-    SamplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-    std::array Bindings = { CBufferLayoutBinding, SamplerLayoutBinding };
-    VkDescriptorSetLayoutCreateInfo LayoutCreateInfo = {};
-    LayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    LayoutCreateInfo.bindingCount = static_cast<uint32_t>(Bindings.size());
-    LayoutCreateInfo.pBindings = Bindings.data();
-
-    if (vkCreateDescriptorSetLayout(LogicalDevice, &LayoutCreateInfo, nullptr, &DescriptorSetLayout) != VK_SUCCESS) 
-    {
-        LOG_ERROR("创建描述符集布局失败！");
-        throw std::runtime_error("failed to create descriptor set layout!");
+    // 描述符集布局和管线布局都从着色器反射信息生成，不再手写绑定
+    const auto& LayoutInfo = FShaderManager::Instance().GetOrCreatePipelineLayout(TriangleShaders, LogicalDevice);
+    if (LayoutInfo.SetLayouts.empty())
+    {
+        LOG_ERROR("三角形着色器没有任何描述符集！");
+        throw std::runtime_error("Triangle shaders have no descriptor set!");
     }
+
+    // 三角形Pass只用到了 set 0
+    DescriptorSetLayout = LayoutInfo.SetLayouts[0];
+    PipelineLayout = LayoutInfo.PipelineLayout;
 }
 
 FVulkanRenderer::SwapChainSupportDetails FVulkanRenderer::QuerySwapChainSupport(VkPhysicalDevice Device)
@@ -1378,6 +1736,8 @@ void FVulkanRenderer::CreateMemoryAllocator()
     {
         LOG_ERROR("创建VMA分配器失败！");
     }
+
+    GeometryArena = std::make_unique<FGeometryArena>(MemoryAllocator);
 }
 
 VkCommandBuffer FVulkanRenderer::BeginSingleTimeCommands() const
@@ -1434,25 +1794,40 @@ void FVulkanRenderer::CopyBuffer(const std::vector<VMABufferCache>& SrcBuffer, c
     EndSingleTimeCommands(CommandBuffer);
 }
 
-void FVulkanRenderer::CopyBufferToImage(const VMABufferCache& Buffer, const VMAImageCache& Image) const
+void FVulkanRenderer::CopyBufferToArena(const VMABufferCache& SrcBuffer, const GeometryAllocation& DstAllocation)
+{
+    VkCommandBuffer CommandBuffer = BeginSingleTimeCommands();
+    VkBufferCopy CopyRegion = {};
+    CopyRegion.srcOffset = 0;
+    CopyRegion.dstOffset = DstAllocation.Offset;
+    CopyRegion.size = DstAllocation.Size;
+    vkCmdCopyBuffer(CommandBuffer, SrcBuffer.BufferHandle, GeometryArena->GetBuffer(DstAllocation.PageIndex), 1, &CopyRegion);
+    EndSingleTimeCommands(CommandBuffer);
+}
+
+void FVulkanRenderer::CopyBufferToImage(const VMABufferCache& Buffer, const VMAImageCache& Image, std::span<const Assets::MipLevel> Levels) const
 {
     const VkCommandBuffer CommandBuffer = BeginSingleTimeCommands();
-    VkBufferImageCopy Region = {};
-    Region.bufferOffset = 0;
-    Region.bufferRowLength = 0; // 0表示紧密打包
-    Region.bufferImageHeight = 0; // 0表示紧密打包
-    Region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    Region.imageSubresource.mipLevel = 0;
-    Region.imageSubresource.baseArrayLayer = 0;
-    Region.imageSubresource.layerCount = 1;
-    Region.imageOffset = {.x = 0, .y = 0, .z = 0};
-    Region.imageExtent = {.width = Image.Width, .height = Image.Height, .depth = 1 };
+    std::vector<VkBufferImageCopy> Regions(Levels.size());
+    for (uint32_t Level = 0; Level < Levels.size(); ++Level)
+    {
+        VkBufferImageCopy& Region = Regions[Level];
+        Region.bufferOffset = Levels[Level].Offset;
+        Region.bufferRowLength = 0; // 0表示紧密打包
+        Region.bufferImageHeight = 0; // 0表示紧密打包
+        Region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        Region.imageSubresource.mipLevel = Level;
+        Region.imageSubresource.baseArrayLayer = 0;
+        Region.imageSubresource.layerCount = 1;
+        Region.imageOffset = {.x = 0, .y = 0, .z = 0};
+        Region.imageExtent = {.width = Levels[Level].Width, .height = Levels[Level].Height, .depth = 1 };
+    }
     vkCmdCopyBufferToImage(CommandBuffer, Buffer.BufferHandle, Image.ImageHandle,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &Region);
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(Regions.size()), Regions.data());
     EndSingleTimeCommands(CommandBuffer);
 }
 
-void FVulkanRenderer::TransitionImageLayout(VkImage Image, VkFormat Format, VkImageLayout OldLayout, VkImageLayout NewLayout) const
+void FVulkanRenderer::TransitionImageLayout(VkImage Image, VkFormat Format, VkImageLayout OldLayout, VkImageLayout NewLayout, uint32_t MipLevels) const
 {
     VkCommandBuffer CommandBuffer = BeginSingleTimeCommands();
 
@@ -1468,7 +1843,7 @@ void FVulkanRenderer::TransitionImageLayout(VkImage Image, VkFormat Format, VkIm
     Barrier.image = Image;
     Barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     Barrier.subresourceRange.baseMipLevel = 0;
-    Barrier.subresourceRange.levelCount = 1;
+    Barrier.subresourceRange.levelCount = MipLevels;
     Barrier.subresourceRange.baseArrayLayer = 0;
     Barrier.subresourceRange.layerCount = 1;
 
@@ -1512,7 +1887,83 @@ void FVulkanRenderer::TransitionImageLayout(VkImage Image, VkFormat Format, VkIm
     EndSingleTimeCommands(CommandBuffer);
 }
 
-VkImageView FVulkanRenderer::CreateImageView(VkImage Image, VkFormat Format, VkImageAspectFlags AspectFlags) const
+void FVulkanRenderer::GenerateMipmaps(const VMAImageCache& Image, uint32_t FilledLevelCount) const
+{
+    VkCommandBuffer CommandBuffer = BeginSingleTimeCommands();
+
+    VkImageMemoryBarrier Barrier = {};
+    Barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    Barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    Barrier.image = Image.ImageHandle;
+    Barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    Barrier.subresourceRange.baseArrayLayer = 0;
+    Barrier.subresourceRange.layerCount = 1;
+
+    auto Transition = [&](uint32_t BaseLevel, uint32_t LevelCount, VkImageLayout OldLayout, VkImageLayout NewLayout,
+                          VkAccessFlags SrcAccess, VkAccessFlags DstAccess, VkPipelineStageFlags DstStage)
+    {
+        Barrier.subresourceRange.baseMipLevel = BaseLevel;
+        Barrier.subresourceRange.levelCount = LevelCount;
+        Barrier.oldLayout = OldLayout;
+        Barrier.newLayout = NewLayout;
+        Barrier.srcAccessMask = SrcAccess;
+        Barrier.dstAccessMask = DstAccess;
+        vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, DstStage, 0, 0, nullptr, 0, nullptr, 1, &Barrier);
+    };
+
+    // 已上传的级别中只有最后一级作为blit源，其余直接转为着色器只读
+    if (FilledLevelCount > 1)
+    {
+        Transition(0, FilledLevelCount - 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                   VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    }
+
+    int32_t Width = static_cast<int32_t>(std::max(Image.Width >> (FilledLevelCount - 1), 1u));
+    int32_t Height = static_cast<int32_t>(std::max(Image.Height >> (FilledLevelCount - 1), 1u));
+    for (uint32_t Level = FilledLevelCount; Level < Image.MipLevels; ++Level)
+    {
+        // 上一级写入完成后转为blit源
+        Transition(Level - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+        const int32_t NextWidth = std::max(Width / 2, 1);
+        const int32_t NextHeight = std::max(Height / 2, 1);
+        VkImageBlit Blit = {};
+        Blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, Level - 1, 0, 1 };
+        Blit.srcOffsets[1] = { Width, Height, 1 };
+        Blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, Level, 0, 1 };
+        Blit.dstOffsets[1] = { NextWidth, NextHeight, 1 };
+        vkCmdBlitImage(CommandBuffer,
+            Image.ImageHandle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            Image.ImageHandle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1, &Blit, VK_FILTER_LINEAR);
+
+        // 作为源读取完毕后转为着色器只读
+        Transition(Level - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                   VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+        Width = NextWidth;
+        Height = NextHeight;
+    }
+
+    // 最后一级只被写入过
+    Transition(Image.MipLevels - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+               VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+    EndSingleTimeCommands(CommandBuffer);
+}
+
+bool FVulkanRenderer::SupportsLinearBlit(VkFormat Format) const
+{
+    constexpr VkFormatFeatureFlags RequiredFeatures =
+        VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    VkFormatProperties Props;
+    vkGetPhysicalDeviceFormatProperties(PhysicalDevice, Format, &Props);
+    return (Props.optimalTilingFeatures & RequiredFeatures) == RequiredFeatures;
+}
+
+VkImageView FVulkanRenderer::CreateImageView(VkImage Image, VkFormat Format, VkImageAspectFlags AspectFlags, uint32_t MipLevels) const
 {
     VkImageViewCreateInfo ViewInfo = {};
     ViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -1521,7 +1972,7 @@ VkImageView FVulkanRenderer::CreateImageView(VkImage Image, VkFormat Format, VkI
     ViewInfo.format = Format;
     ViewInfo.subresourceRange.aspectMask = AspectFlags;
     ViewInfo.subresourceRange.baseMipLevel = 0;
-    ViewInfo.subresourceRange.levelCount = 1;
+    ViewInfo.subresourceRange.levelCount = MipLevels;
     ViewInfo.subresourceRange.baseArrayLayer = 0;
     ViewInfo.subresourceRange.layerCount = 1;
 
@@ -0,0 +1,126 @@
+#include "Logger.hh"
+#include "ShaderArchive.hh"
+#include "ShaderManager.hh"
+#include "ShaderPermutation.hh"
+
+#include <ylt/struct_json/json_reader.h>
+
+#include <fstream>
+#include <sstream>
+
+using namespace SilverBell::Renderer;
+
+namespace
+{
+    // 着色器清单中的一项，每个关键字轴是一组互斥的关键字，空字符串表示不定义宏
+    struct ShaderManifestEntry
+    {
+        std::string FilePath;
+        std::string EntryPoint;
+        std::string Stage;
+        std::vector<std::vector<std::string>> KeywordAxes;
+    };
+    YLT_REFL(ShaderManifestEntry, FilePath, EntryPoint, Stage, KeywordAxes)
+
+    struct ShaderManifest
+    {
+        std::vector<ShaderManifestEntry> Shaders;
+    };
+    YLT_REFL(ShaderManifest, Shaders)
+
+    std::uint32_t ParseShaderStage(const std::string& Stage)
+    {
+        if (Stage == "Vertex") return VK_SHADER_STAGE_VERTEX_BIT;
+        if (Stage == "Fragment") return VK_SHADER_STAGE_FRAGMENT_BIT;
+        if (Stage == "Compute") return VK_SHADER_STAGE_COMPUTE_BIT;
+        LOG_ERROR("未知的着色器阶段: {}", Stage);
+        throw std::runtime_error("Unknown shader stage: " + Stage);
+    }
+}
+
+// 用法：ShaderArchiver <着色器清单.json> <输出文件>
+// 展开清单中每个着色器的所有关键字组合，并行编译后写入同一个着色器包
+int main(int Argc, char** Argv)
+{
+    SilverBell::Utility::Logger::InitializeAsyncLogging();
+
+    if (Argc < 3)
+    {
+        LOG_ERROR("用法: ShaderArchiver <着色器清单.json> <输出文件>");
+        return 1;
+    }
+
+    std::ifstream ManifestFile(Argv[1]);
+    if (!ManifestFile.is_open())
+    {
+        LOG_ERROR("打开着色器清单失败: {}", Argv[1]);
+        return 1;
+    }
+    std::stringstream Content;
+    Content << ManifestFile.rdbuf();
+
+    ShaderManifest Manifest;
+    try
+    {
+        struct_json::from_json(Manifest, Content.str());
+    }
+    catch (const std::exception& E)
+    {
+        LOG_ERROR("解析着色器清单失败: {}", E.what());
+        return 1;
+    }
+
+    std::vector<ShaderDesc> Descs;
+    for (const auto& Entry : Manifest.Shaders)
+    {
+        ShaderDesc BaseDesc
+        {
+            .FilePath = Entry.FilePath,
+            .EntryPoint = Entry.EntryPoint,
+            .ShaderStage = ParseShaderStage(Entry.Stage),
+            .Defines = {}
+        };
+        std::vector<ShaderKeywordAxis> Axes;
+        for (const auto& Keywords : Entry.KeywordAxes)
+        {
+            Axes.push_back({ Keywords });
+        }
+
+        auto Permutations = FShaderPermutationSet(std::move(BaseDesc), std::move(Axes)).Expand();
+        Descs.insert(Descs.end(), std::make_move_iterator(Permutations.begin()), std::make_move_iterator(Permutations.end()));
+    }
+    LOG_INFO("共 {} 个着色器排列需要编译", Descs.size());
+
+    auto Futures = FShaderManager::Instance().CompileAsync(Descs);
+
+    FShaderArchiveWriter Writer;
+    std::size_t FailedCount = 0;
+    for (std::size_t Idx = 0; Idx < Futures.size(); ++Idx)
+    {
+        try
+        {
+            Writer.Add(*Futures[Idx].get());
+        }
+        catch (const std::exception& E)
+        {
+            ++FailedCount;
+            LOG_ERROR("编译失败: {}, {}", Descs[Idx].FilePath.string(), E.what());
+        }
+    }
+    if (FailedCount != 0)
+    {
+        LOG_ERROR("{} 个着色器编译失败，未生成着色器包", FailedCount);
+        return 1;
+    }
+
+    try
+    {
+        Writer.Write(Argv[2]);
+    }
+    catch (const std::exception&)
+    {
+        return 1;
+    }
+    LOG_INFO("着色器包已生成: {}，共 {} 个着色器", Argv[2], Writer.GetEntryCount());
+    return 0;
+}